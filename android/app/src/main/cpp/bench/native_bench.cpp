@@ -0,0 +1,710 @@
+// android/app/src/main/cpp/bench/native_bench.cpp
+// Benchmark hors téléphone (Linux x86_64) des noyaux de native_processing.
+//
+// Pour chaque noyau : latence par appel (p50 / p90 / p99, en µs) et débit.
+// Entrées synthétiques par défaut (trames NV12 640x480, 1280x720, 1920x1080 et carte
+// de profondeur 256x256 d'un couloir), ou enregistrées :
+//   native_bench [--iterations N] [--warmup N]
+//                [--nv12 FICHIER LxH]   trame NV12 brute (plan Y puis plan UV, sans marge)
+//                [--depth FICHIER]      carte 256x256 brute : float32, ou uint8 si 65536 octets
+//                [--seed N]             graine RANSAC (rejeu ; 0 = automatique), 1 par défaut
+//                [--model FICHIER]      modèle .tflite 256x256 : trame complète par
+//                                       pipeline_process_frame (build NATIVE_WITH_TFLITE)
+//                [--check-kernels]      vérifie seulement les noyaux d'inliers, sans mesure
+//
+// Avant toute mesure, chaque noyau de comptage d'inliers compilé est comparé à la
+// référence scalaire ; au moindre écart, le programme s'arrête avec le code 1.
+//
+// Les chiffres sont à comparer d'un commit à l'autre sur la même machine, pas avec
+// ceux du téléphone. Le passage à l'échelle (1 à 8 threads) n'a de sens que sur une
+// machine qui a au moins autant de cœurs libres.
+
+#include "image_utils.h"
+#include "ransac_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kModelSize = 256;     // Entrée / sortie du modèle MiDaS
+constexpr int kMaxPlanes = 8;
+constexpr float kFreePathThreshold = 0.3f;
+constexpr float kHistogramMax = 1.0f;
+constexpr float kBlobThreshold = 0.4f; // Profondeur inverse : murs, sol et plafond proches des bords
+constexpr int kModelThreads = 4;       // Threads de l'interpréteur TFLite (--model)
+
+struct Config {
+    int iterations = 200;
+    int warmup = 10;
+    std::string nv12_path;
+    int nv12_width = 0, nv12_height = 0;
+    std::string depth_path;
+    uint32_t seed = 1; // Tirages RANSAC identiques d'une exécution à l'autre
+    std::string model_path;
+    bool check_only = false; // --check-kernels
+};
+
+struct Nv12Frame {
+    std::string name;
+    int width = 0, height = 0;
+    std::vector<uint8_t> y, uv; // Strides = largeur
+};
+
+struct DepthMap {
+    std::string name;
+    std::vector<float> f32;
+    std::vector<uint8_t> u8;    // Même carte quantifiée (scale, zero_point)
+    float scale = 1.0f / 255.0f;
+    int zero_point = 0;
+};
+
+// --- Mesure ---
+
+// Empêche le compilateur d'éliminer un résultat inutilisé.
+volatile int64_t g_sink = 0;
+
+// Percentile au rang le plus proche, sur des échantillons triés.
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    if (rank == 0) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+// Exécute `fn` warmup + iterations fois, puis affiche une ligne de résultats.
+// `pixels` : pixels traités par appel (0 : pas de débit en Mpix/s).
+template <typename Fn>
+void run(const Config& config, const std::string& name, int64_t pixels, Fn fn) {
+    for (int i = 0; i < config.warmup; ++i) g_sink += fn();
+
+    std::vector<double> samples(config.iterations);
+    for (int i = 0; i < config.iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        g_sink += fn();
+        const auto end = std::chrono::steady_clock::now();
+        samples[i] = std::chrono::duration<double, std::micro>(end - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0.0;
+    for (double s : samples) total += s;
+    const double mean = total / samples.size();
+    const double calls_per_s = mean > 0.0 ? 1e6 / mean : 0.0;
+
+    std::printf("%-44s %10.1f %10.1f %10.1f %10.0f", name.c_str(),
+                percentile(samples, 50), percentile(samples, 90), percentile(samples, 99),
+                calls_per_s);
+    if (pixels > 0) {
+        std::printf(" %10.1f", static_cast<double>(pixels) * calls_per_s / 1e6);
+    }
+    std::printf("\n");
+}
+
+// --- Entrées synthétiques ---
+
+// Trame NV12 avec dégradés et texture (valeurs variées pour la conversion).
+Nv12Frame make_nv12(int width, int height) {
+    Nv12Frame frame;
+    frame.name = std::to_string(width) + "x" + std::to_string(height);
+    frame.width = width;
+    frame.height = height;
+    frame.y.resize(static_cast<size_t>(width) * height);
+    frame.uv.resize(static_cast<size_t>(width) * (height / 2));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            frame.y[static_cast<size_t>(y) * width + x] =
+                static_cast<uint8_t>(16 + (x * 7 + y * 3 + ((x ^ y) & 31)) % 220);
+        }
+    }
+    for (int y = 0; y < height / 2; ++y) {
+        for (int x = 0; x < width; x += 2) {
+            uint8_t* uv = &frame.uv[static_cast<size_t>(y) * width + x];
+            uv[0] = static_cast<uint8_t>(64 + (x * 128) / width);  // U
+            uv[1] = static_cast<uint8_t>(64 + (y * 256) / height); // V
+        }
+    }
+    return frame;
+}
+
+// Carte de profondeur inverse d'un couloir vu de face : deux murs, sol et plafond
+// (plans), fond lointain, plus un léger bruit déterministe.
+DepthMap make_corridor_depth() {
+    DepthMap map;
+    map.name = "couloir 256x256";
+    map.f32.resize(kModelSize * kModelSize);
+    const float f = kModelSize * 0.8f;
+    const float c = kModelSize * 0.5f;
+    const float half_width = 1.2f, half_height = 1.3f, far = 12.0f;
+    uint32_t noise = 12345u;
+    for (int v = 0; v < kModelSize; ++v) {
+        for (int u = 0; u < kModelSize; ++u) {
+            const float rx = (u - c) / f;
+            const float ry = (v - c) / f;
+            // Profondeur du premier plan rencontré par le rayon (u, v).
+            float z = far;
+            if (rx != 0.0f) z = std::min(z, half_width / std::fabs(rx));
+            if (ry != 0.0f) z = std::min(z, half_height / std::fabs(ry));
+            noise = noise * 1664525u + 1013904223u;
+            const float jitter = ((noise >> 8) & 0xFFFF) / 65535.0f - 0.5f;
+            map.f32[v * kModelSize + u] = 1.0f / z + jitter * 0.004f;
+        }
+    }
+    return map;
+}
+
+// Remplit la version 8 bits de la carte (quantification uint8 sur [0, max]).
+void quantize(DepthMap& map) {
+    float max_value = 0.0f;
+    for (float value : map.f32) max_value = std::max(max_value, value);
+    map.scale = max_value > 0.0f ? max_value / 255.0f : 1.0f / 255.0f;
+    map.zero_point = 0;
+    map.u8.resize(map.f32.size());
+    for (size_t i = 0; i < map.f32.size(); ++i) {
+        const float q = std::round(map.f32[i] / map.scale);
+        map.u8[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, q)));
+    }
+}
+
+// --- Entrées enregistrées ---
+
+bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Impossible d'ouvrir %s\n", path.c_str());
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    out.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    const size_t read = out.empty() ? 0 : std::fread(out.data(), 1, out.size(), file);
+    std::fclose(file);
+    return read == out.size();
+}
+
+bool load_nv12(const std::string& path, int width, int height, Nv12Frame& frame) {
+    std::vector<uint8_t> bytes;
+    if (!read_file(path, bytes)) return false;
+    const size_t y_size = static_cast<size_t>(width) * height;
+    const size_t uv_size = static_cast<size_t>(width) * (height / 2);
+    if (bytes.size() < y_size + uv_size) {
+        std::fprintf(stderr, "%s : %zu octets, %zu attendus pour %dx%d NV12\n",
+                     path.c_str(), bytes.size(), y_size + uv_size, width, height);
+        return false;
+    }
+    frame.name = "enregistrée " + std::to_string(width) + "x" + std::to_string(height);
+    frame.width = width;
+    frame.height = height;
+    frame.y.assign(bytes.begin(), bytes.begin() + y_size);
+    frame.uv.assign(bytes.begin() + y_size, bytes.begin() + y_size + uv_size);
+    return true;
+}
+
+bool load_depth(const std::string& path, DepthMap& map) {
+    std::vector<uint8_t> bytes;
+    if (!read_file(path, bytes)) return false;
+    const size_t count = static_cast<size_t>(kModelSize) * kModelSize;
+    map.name = "enregistrée 256x256";
+    if (bytes.size() == count) {
+        // Sortie uint8 du modèle : quantification inconnue, on suppose [0, 1].
+        map.u8 = bytes;
+        map.scale = 1.0f / 255.0f;
+        map.zero_point = 0;
+        map.f32.resize(count);
+        for (size_t i = 0; i < count; ++i) map.f32[i] = map.scale * (map.u8[i] - map.zero_point);
+        return true;
+    }
+    if (bytes.size() == count * sizeof(float)) {
+        map.f32.resize(count);
+        std::memcpy(map.f32.data(), bytes.data(), bytes.size());
+        quantize(map);
+        return true;
+    }
+    std::fprintf(stderr, "%s : %zu octets, attendu %zu (uint8) ou %zu (float32)\n",
+                 path.c_str(), bytes.size(), count, count * sizeof(float));
+    return false;
+}
+
+bool parse_args(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            config.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            config.warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--nv12" && i + 2 < argc) {
+            config.nv12_path = argv[++i];
+            if (std::sscanf(argv[++i], "%dx%d", &config.nv12_width, &config.nv12_height) != 2 ||
+                config.nv12_width <= 0 || config.nv12_height <= 0) {
+                std::fprintf(stderr, "Dimensions invalides : %s (attendu LxH)\n", argv[i]);
+                return false;
+            }
+        } else if (arg == "--depth" && i + 1 < argc) {
+            config.depth_path = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--model" && i + 1 < argc) {
+            config.model_path = argv[++i];
+        } else if (arg == "--check-kernels") {
+            config.check_only = true;
+        } else {
+            std::fprintf(stderr,
+                         "Usage : %s [--iterations N] [--warmup N] [--nv12 FICHIER LxH] [--depth FICHIER] [--seed N]"
+                         " [--model FICHIER] [--check-kernels]\n",
+                         argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// --- Suites de mesures ---
+
+void bench_nv12(const Config& config, const Nv12Frame& frame) {
+    const int w = frame.width, h = frame.height;
+    const int64_t pixels = static_cast<int64_t>(w) * h;
+    std::vector<uint8_t> rgb(static_cast<size_t>(pixels) * 3);
+    std::vector<uint8_t> model_input(kModelSize * kModelSize * 3);
+
+    run(config, "convert_yuv420sp_to_rgb " + frame.name, pixels, [&] {
+        convert_yuv420sp_to_rgb(frame.y.data(), frame.uv.data(), w, h, w, w, rgb.data());
+        return static_cast<int64_t>(rgb[rgb.size() / 2]);
+    });
+    run(config, "preprocess_yuv420sp_to_model_input " + frame.name, pixels, [&] {
+        preprocess_yuv420sp_to_model_input(frame.y.data(), frame.uv.data(), w, h, w, w,
+                                           0, 0, 0, 0, model_input.data(), kModelSize, kModelSize);
+        return static_cast<int64_t>(model_input[model_input.size() / 2]);
+    });
+    // Même plan entrelacé lu comme NV21 (V puis U), tourné de 90 degrés (capteur paysage).
+    run(config, "preprocess_yuv420_to_model_input NV21 rotation 90 " + frame.name, pixels, [&] {
+        preprocess_yuv420_to_model_input(frame.y.data(), frame.uv.data() + 1, frame.uv.data(), w, h, w, w, 2,
+                                         90, 0, 0, 0, 0, model_input.data(), kModelSize, kModelSize);
+        return static_cast<int64_t>(model_input[model_input.size() / 2]);
+    });
+
+    // Tenseurs float du modèle non quantifié (normalisation ImageNet, en unités 0..255).
+    const InputTensorFormat formats[] = {
+        {INPUT_TENSOR_F32, INPUT_TENSOR_NHWC, {123.675f, 116.28f, 103.53f}, {58.395f, 57.12f, 57.375f}},
+        {INPUT_TENSOR_F32, INPUT_TENSOR_NCHW, {123.675f, 116.28f, 103.53f}, {58.395f, 57.12f, 57.375f}},
+        {INPUT_TENSOR_F16, INPUT_TENSOR_NHWC, {123.675f, 116.28f, 103.53f}, {58.395f, 57.12f, 57.375f}},
+    };
+    const char* format_names[] = {"f32 NHWC", "f32 NCHW", "f16 NHWC"};
+    std::vector<float> tensor(kModelSize * kModelSize * 3);
+    for (int f = 0; f < 3; ++f) {
+        run(config, std::string("preprocess_yuv420_to_tensor ") + format_names[f] + " " + frame.name, pixels, [&] {
+            preprocess_yuv420_to_tensor(frame.y.data(), frame.uv.data(), frame.uv.data() + 1, w, h, w, w, 2,
+                                        0, 0, 0, 0, 0, &formats[f], tensor.data(), kModelSize, kModelSize);
+            return static_cast<int64_t>(tensor[tensor.size() / 2]);
+        });
+    }
+
+    // Chemin de l'application : dépôt dans la boîte aux lettres (rappel caméra), puis
+    // prise de la trame la plus récente et prétraitement (boucle de traitement).
+    PipelineContext* ctx = pipeline_create(w, h, kModelSize, kModelSize, kMaxPlanes);
+    if (ctx == nullptr) {
+        std::fprintf(stderr, "pipeline_create a échoué\n");
+        return;
+    }
+    int64_t timestamp = 0;
+    run(config, "pipeline_mailbox dépôt " + frame.name, pixels, [&] {
+        pipeline_mailbox_reserve(ctx, static_cast<int>(frame.y.size()), static_cast<int>(frame.uv.size()));
+        std::memcpy(pipeline_mailbox_y_buffer(ctx), frame.y.data(), frame.y.size());
+        std::memcpy(pipeline_mailbox_uv_buffer(ctx), frame.uv.data(), frame.uv.size());
+        return static_cast<int64_t>(pipeline_mailbox_publish(ctx, w, h, w, w, ++timestamp));
+    });
+    run(config, "pipeline_mailbox dépôt + prise + prétraitement " + frame.name, pixels, [&] {
+        pipeline_mailbox_reserve(ctx, static_cast<int>(frame.y.size()), static_cast<int>(frame.uv.size()));
+        std::memcpy(pipeline_mailbox_y_buffer(ctx), frame.y.data(), frame.y.size());
+        std::memcpy(pipeline_mailbox_uv_buffer(ctx), frame.uv.data(), frame.uv.size());
+        pipeline_mailbox_publish(ctx, w, h, w, w, ++timestamp);
+        return static_cast<int64_t>(pipeline_mailbox_take(ctx) + pipeline_preprocess_latest(ctx));
+    });
+    // Trame à trois plans telle que la copie Dart de YUV_420_888 : plans U et V distincts
+    // (pas de pixel 2, le plan V commence un octet plus loin), rotation 90 degrés.
+    const std::vector<uint8_t> v_plane(frame.uv.begin() + 1, frame.uv.end());
+    run(config, "pipeline_mailbox 3 plans + prétraitement rotation 90 " + frame.name, pixels, [&] {
+        pipeline_mailbox_reserve_yuv420(ctx, static_cast<int>(frame.y.size()), static_cast<int>(frame.uv.size()),
+                                        static_cast<int>(v_plane.size()));
+        std::memcpy(pipeline_mailbox_y_buffer(ctx), frame.y.data(), frame.y.size());
+        std::memcpy(pipeline_mailbox_uv_buffer(ctx), frame.uv.data(), frame.uv.size());
+        std::memcpy(pipeline_mailbox_v_buffer(ctx), v_plane.data(), v_plane.size());
+        pipeline_mailbox_publish_yuv420(ctx, w, h, w, w, 2, 90, ++timestamp);
+        return static_cast<int64_t>(pipeline_mailbox_take(ctx) + pipeline_preprocess_latest(ctx));
+    });
+    const MailboxStats stats = *pipeline_mailbox_stats(ctx);
+    std::printf("  boîte aux lettres : %lld déposées, %lld prises, %lld écrasées\n",
+                static_cast<long long>(stats.published), static_cast<long long>(stats.taken),
+                static_cast<long long>(stats.overwritten));
+    pipeline_destroy(ctx);
+}
+
+RansacOptions bench_ransac_options(uint32_t seed) {
+    RansacOptions options;
+    ransac_default_options(&options);
+    options.seed = seed;
+    options.fx = options.fy = kModelSize * 0.8f;
+    options.cx = options.cy = kModelSize * 0.5f;
+    options.distance_threshold = 0.08f;
+    options.min_inliers = 500;
+    options.max_iterations = 50;
+    // Recherche complète à chaque appel (la reprise temporelle est mesurée à part).
+    options.warm_start = 0;
+    return options;
+}
+
+void bench_depth(const Config& config, const DepthMap& map) {
+    const int64_t pixels = static_cast<int64_t>(kModelSize) * kModelSize;
+    DepthStats stats;
+
+    run(config, "compute_depth_stats " + map.name, pixels, [&] {
+        compute_depth_stats(map.f32.data(), kModelSize, kModelSize,
+                            kFreePathThreshold, kHistogramMax, &stats);
+        return static_cast<int64_t>(stats.total_considered);
+    });
+    run(config, "compute_depth_stats_q8 " + map.name, pixels, [&] {
+        compute_depth_stats_q8(map.u8.data(), kModelSize, kModelSize, DEPTH_FORMAT_U8,
+                               map.scale, map.zero_point, kFreePathThreshold, kHistogramMax, &stats);
+        return static_cast<int64_t>(stats.total_considered);
+    });
+
+    // Filtre temporel (état persistant, mis à jour en place à chaque appel).
+    std::vector<float> filter_state(map.f32);
+    run(config, "temporal_filter_depth " + map.name, pixels, [&] {
+        temporal_filter_depth(filter_state.data(), map.f32.data(), static_cast<int>(pixels), 0.4f, 0.2f);
+        return static_cast<int64_t>(filter_state[0] > 0.0f);
+    });
+    run(config, "temporal_filter_depth_q8 " + map.name, pixels, [&] {
+        temporal_filter_depth_q8(filter_state.data(), map.u8.data(), static_cast<int>(pixels),
+                                 DEPTH_FORMAT_U8, map.scale, map.zero_point, 0.4f, 0.2f);
+        return static_cast<int64_t>(filter_state[0] > 0.0f);
+    });
+
+    // Carte polaire d'obstacles : portée qui atteint les murs du couloir (bords de l'image).
+    PolarObstacleOptions polar_options;
+    polar_obstacle_default_options(&polar_options);
+    polar_options.fx = polar_options.fy = kModelSize * 0.8f;
+    polar_options.cx = polar_options.cy = kModelSize * 0.5f;
+    polar_options.obstacle_range = 2.5f;
+    PolarObstacleMap polar_map;
+    run(config, "compute_polar_obstacles " + map.name, pixels, [&] {
+        compute_polar_obstacles(map.f32.data(), kModelSize, kModelSize, &polar_options, &polar_map);
+        return static_cast<int64_t>(polar_map.blocked_mask);
+    });
+    run(config, "compute_polar_obstacles_q8 " + map.name, pixels, [&] {
+        compute_polar_obstacles_q8(map.u8.data(), kModelSize, kModelSize, DEPTH_FORMAT_U8,
+                                   map.scale, map.zero_point, &polar_options, &polar_map);
+        return static_cast<int64_t>(polar_map.blocked_mask);
+    });
+
+    // Composantes connexes : murs proches des bords du couloir au-delà du seuil.
+    ObstacleBlob blobs[OBSTACLE_BLOBS_MAX];
+    run(config, "detect_obstacle_blobs " + map.name, pixels, [&] {
+        return static_cast<int64_t>(detect_obstacle_blobs(map.f32.data(), kModelSize, kModelSize,
+                                                          kBlobThreshold, 32, blobs, OBSTACLE_BLOBS_MAX));
+    });
+
+    // RANSAC : graine fixe (rejeu), chaque appel fait le même travail ; l'appel
+    // historique tire toujours une graine automatique, sa latence varie d'un appel à l'autre.
+    RansacPlaneResult planes[kMaxPlanes];
+    const RansacOptions options = bench_ransac_options(config.seed);
+    run(config, "detect_walls_ransac (legacy) " + map.name, pixels, [&] {
+        return static_cast<int64_t>(detect_walls_ransac(
+            map.f32.data(), kModelSize, kModelSize, options.fx, options.fy, options.cx, options.cy,
+            options.distance_threshold, options.min_inliers, options.max_iterations,
+            planes, kMaxPlanes));
+    });
+    run(config, "detect_walls_ransac_ex " + map.name, pixels, [&] {
+        return static_cast<int64_t>(detect_walls_ransac_ex(
+            map.f32.data(), kModelSize, kModelSize, &options, planes, kMaxPlanes, nullptr));
+    });
+
+    // Chemin de l'application : contexte persistant, options de DepthAnalyzer.
+    PipelineContext* ctx = pipeline_create(0, 0, kModelSize, kModelSize, kMaxPlanes);
+    if (ctx == nullptr) {
+        std::fprintf(stderr, "pipeline_create a échoué\n");
+        return;
+    }
+    *pipeline_ransac_options(ctx) = options;
+    pipeline_ransac_options(ctx)->max_points = 16384;
+    std::memcpy(pipeline_depth_buffer(ctx), map.f32.data(), map.f32.size() * sizeof(float));
+    std::memcpy(pipeline_depth_q8_buffer(ctx), map.u8.data(), map.u8.size());
+
+    pipeline_set_depth_format(ctx, DEPTH_FORMAT_F32, 1.0f, 0);
+    run(config, "pipeline_detect_walls f32 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    pipeline_set_depth_format(ctx, DEPTH_FORMAT_U8, map.scale, map.zero_point);
+    run(config, "pipeline_detect_walls u8 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    // Reprise temporelle : carte identique d'un appel à l'autre, les plans précédents tiennent.
+    pipeline_ransac_options(ctx)->warm_start = 1;
+    run(config, "pipeline_detect_walls u8 reprise " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    pipeline_ransac_options(ctx)->warm_start = 0;
+    // Ajustement en profondeur inverse : ni déprojection ni division.
+    pipeline_ransac_options(ctx)->engine = RANSAC_ENGINE_INVERSE_DEPTH;
+    run(config, "pipeline_detect_walls u8 inverse " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    pipeline_set_depth_format(ctx, DEPTH_FORMAT_F32, 1.0f, 0);
+    run(config, "pipeline_detect_walls f32 inverse " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    // Grossier -> fin : hypothèses sur le niveau 2 (64x64), vérification pleine résolution.
+    pipeline_ransac_options(ctx)->coarse_level = 2;
+    run(config, "pipeline_detect_walls f32 inverse niveau 2 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    pipeline_ransac_options(ctx)->engine = RANSAC_ENGINE_METRIC;
+    run(config, "pipeline_detect_walls f32 niveau 2 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_walls(ctx));
+    });
+    pipeline_ransac_options(ctx)->coarse_level = 0;
+    run(config, "pipeline_build_depth_pyramid f32 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_build_depth_pyramid(ctx, DEPTH_PYRAMID_LEVELS));
+    });
+    run(config, "pipeline_compute_depth_stats niveau 2 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_compute_depth_stats_level(ctx, 2, kFreePathThreshold, kHistogramMax));
+    });
+    pipeline_set_depth_format(ctx, DEPTH_FORMAT_U8, map.scale, map.zero_point);
+    run(config, "pipeline_compute_depth_stats u8 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_compute_depth_stats(ctx, kFreePathThreshold, kHistogramMax));
+    });
+    *pipeline_polar_obstacle_options(ctx) = polar_options;
+    run(config, "pipeline_compute_polar_obstacles u8 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_compute_polar_obstacles(ctx));
+    });
+    run(config, "pipeline_detect_obstacle_blobs u8 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_obstacle_blobs(ctx, kBlobThreshold, 32));
+    });
+    pipeline_set_depth_format(ctx, DEPTH_FORMAT_F32, 1.0f, 0);
+    run(config, "pipeline_detect_obstacle_blobs f32 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_detect_obstacle_blobs(ctx, kBlobThreshold, 32));
+    });
+    // Tables cumulées : construction une fois par carte, puis DEPTH_REGIONS_MAX couloirs
+    // candidats (bandes verticales de la moitié basse, largeurs et positions variées).
+    DepthRegion* regions = pipeline_depth_regions(ctx);
+    for (int i = 0; i < DEPTH_REGIONS_MAX; ++i) {
+        const int strip = kModelSize / 8 * (1 + i % 4);
+        const int x0 = (kModelSize - strip) * (i / 4) / (DEPTH_REGIONS_MAX / 4 - 1);
+        regions[i] = DepthRegion{x0, kModelSize / 2, x0 + strip, kModelSize};
+    }
+    run(config, "pipeline_build_depth_integral f32 " + map.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_build_depth_integral(ctx, kBlobThreshold));
+    });
+    run(config, "pipeline_query_depth_regions x" + std::to_string(DEPTH_REGIONS_MAX), DEPTH_REGIONS_MAX, [&] {
+        return static_cast<int64_t>(pipeline_query_depth_regions(ctx, DEPTH_REGIONS_MAX));
+    });
+
+    // Passage à l'échelle : même appel (graine fixe) avec 1, 2, 4 et 8 threads. Les plans
+    // doivent être identiques quel que soit le nombre de threads.
+    pipeline_set_depth_format(ctx, DEPTH_FORMAT_F32, 1.0f, 0);
+    std::vector<RansacPlaneResult> reference;
+    for (int threads : {1, 2, 4, 8}) {
+        const int effective = pipeline_set_thread_count(ctx, threads);
+        int found = 0;
+        std::string label = "pipeline_detect_walls f32 " + std::to_string(effective) + " thread(s)";
+        if (effective != threads) label += " (" + std::to_string(threads) + " demandés)";
+        run(config, label, pixels, [&] {
+            found = pipeline_detect_walls(ctx);
+            return static_cast<int64_t>(found);
+        });
+        const RansacPlaneResult* result = pipeline_planes_buffer(ctx);
+        if (reference.empty()) {
+            reference.assign(result, result + found);
+        } else if (config.seed != 0 &&
+                   (static_cast<size_t>(found) != reference.size() ||
+                    std::memcmp(reference.data(), result, reference.size() * sizeof(RansacPlaneResult)) != 0)) {
+            std::printf("  ATTENTION : plans différents de ceux obtenus avec 1 thread\n");
+        }
+    }
+    pipeline_destroy(ctx);
+}
+
+// Trame complète en un appel : prétraitement dans le tenseur de l'interpréteur, inférence
+// (CPU), analyse et RANSAC. Un contexte (et un chargement du modèle) par taille de trame,
+// réutilisé à chaque itération comme dans l'application.
+void bench_process_frame(const Config& config, const Nv12Frame& frame) {
+    const int w = frame.width, h = frame.height;
+    PipelineContext* ctx = pipeline_create(w, h, kModelSize, kModelSize, kMaxPlanes);
+    if (ctx == nullptr) {
+        std::fprintf(stderr, "pipeline_create a échoué\n");
+        return;
+    }
+    // Normalisation ImageNet (ignorée si l'entrée du modèle est uint8), puis modèle.
+    pipeline_set_input_format(ctx, INPUT_TENSOR_F32, INPUT_TENSOR_NHWC,
+                              123.675f, 116.28f, 103.53f, 58.395f, 57.12f, 57.375f);
+    const auto load_start = std::chrono::steady_clock::now();
+    const int status = pipeline_load_model(ctx, config.model_path.c_str(), kModelThreads);
+    const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+    if (status != PIPELINE_STATUS_OK) {
+        std::fprintf(stderr, "pipeline_load_model : statut %d (%s)\n", status, config.model_path.c_str());
+        pipeline_destroy(ctx);
+        return;
+    }
+    ProcessMemory memory{};
+    read_process_memory(&memory);
+    std::printf("  chargement du modèle (projeté) : %.1f ms, RSS %lld kio (pic %lld kio)\n", load_ms,
+                static_cast<long long>(memory.rss_kb), static_cast<long long>(memory.peak_rss_kb));
+    *pipeline_ransac_options(ctx) = bench_ransac_options(config.seed);
+    PolarObstacleOptions* polar = pipeline_polar_obstacle_options(ctx);
+    polar->fx = polar->fy = kModelSize * 0.8f;
+    polar->cx = polar->cy = kModelSize * 0.5f;
+
+    const int64_t pixels = static_cast<int64_t>(w) * h;
+    run(config, "pipeline_process_frame " + frame.name, pixels, [&] {
+        return static_cast<int64_t>(pipeline_process_frame(ctx, frame.y.data(), frame.uv.data(), nullptr,
+                                                           w, h, w, w, 2, 0));
+    });
+    const FrameResult result = *pipeline_frame_result(ctx);
+    std::printf("  dernière trame : statut %d, prétraitement %d µs, inférence %d µs, analyse %d µs, "
+                "RANSAC %d µs (%d obstacles, %d plans)\n",
+                result.status, result.preprocess_us, result.inference_us, result.analysis_us,
+                result.ransac_us, result.obstacle_count, result.plane_count);
+    read_process_memory(&memory);
+    std::printf("  après les trames : RSS %lld kio (pic %lld kio)\n",
+                static_cast<long long>(memory.rss_kb), static_cast<long long>(memory.peak_rss_kb));
+    pipeline_destroy(ctx);
+}
+
+// Noyau de comptage d'inliers seul (boucle interne de RANSAC), référence contre actif.
+void bench_inlier_kernels(const Config& config) {
+    constexpr size_t kPoints = 65536;
+    std::vector<float> x(kPoints), y(kPoints), z(kPoints);
+    uint32_t state = 42u;
+    for (size_t i = 0; i < kPoints; ++i) {
+        state = state * 1664525u + 1013904223u;
+        x[i] = ((state >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+        y[i] = ((state >> 4) & 0xFFFF) / 32768.0f - 1.0f;
+        z[i] = 1.0f + (i % 97) * 0.05f;
+    }
+    const CountInliersFn active = count_inliers_kernel();
+    run(config, "count_inliers scalar (65536 pts)", kPoints, [&] {
+        return static_cast<int64_t>(count_inliers_scalar(x.data(), y.data(), z.data(), kPoints,
+                                                         0.2f, 0.1f, 0.97f, -2.0f, 0.08f));
+    });
+    run(config, std::string("count_inliers ") + count_inliers_kernel_name() + " (65536 pts)", kPoints, [&] {
+        return static_cast<int64_t>(active(x.data(), y.data(), z.data(), kPoints,
+                                           0.2f, 0.1f, 0.97f, -2.0f, 0.08f));
+    });
+}
+
+// --- Vérifications ---
+
+// Compare chaque noyau d'inliers compilé et supporté par ce processeur à la référence
+// scalaire : toutes les longueurs de 0 à 67 (queues plus courtes qu'un registre et
+// n % 8 != 0), débuts non alignés, coordonnées NaN et ±inf, points exactement au seuil
+// (exclus : la comparaison est stricte) et juste en deçà. Retourne false au moindre écart.
+bool check_inlier_kernels() {
+    constexpr size_t kMaxCount = 67;
+    constexpr size_t kMaxOffset = 3;
+    constexpr size_t kSize = kMaxCount + kMaxOffset;
+    const float nan = std::nanf("");
+    const float inf = INFINITY;
+
+    // Plan z = 2 (a = b = 0, c = 1, d = -2), seuil 0.5 : z = 1.5 et 2.5 tombent exactement
+    // sur le seuil, nextafter vers 2 juste en deçà. Puis un plan quelconque.
+    struct Plane {
+        float a, b, c, d, threshold;
+    };
+    const Plane planes[] = {{0.0f, 0.0f, 1.0f, -2.0f, 0.5f}, {0.2f, 0.1f, 0.97f, -2.0f, 0.08f}};
+    const float specials[] = {nan, inf, -inf, 1.5f, 2.5f, std::nextafter(1.5f, 2.0f),
+                              std::nextafter(2.5f, 2.0f), 2.0f};
+    constexpr size_t kSpecials = sizeof(specials) / sizeof(specials[0]);
+
+    std::vector<float> x(kSize), y(kSize), z(kSize);
+    uint32_t state = 7u;
+    for (size_t i = 0; i < kSize; ++i) {
+        state = state * 1664525u + 1013904223u;
+        x[i] = ((state >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+        y[i] = ((state >> 4) & 0xFFFF) / 32768.0f - 1.0f;
+        // Un point sur deux porte une valeur particulière, sur z puis (tous les 5) sur x ou y.
+        z[i] = (i % 2 == 0) ? specials[(i / 2) % kSpecials] : 1.0f + (i % 13) * 0.1f;
+        if (i % 5 == 1) x[i] = specials[i % kSpecials];
+        if (i % 7 == 3) y[i] = specials[(i + 3) % kSpecials];
+    }
+
+    const RansacKernel kernels[] = {RansacKernel::Scalar, RansacKernel::Neon, RansacKernel::Sse2,
+                                    RansacKernel::Avx2};
+    bool ok = true;
+    int checked = 0;
+    for (RansacKernel kernel : kernels) {
+        if (!set_count_inliers_kernel(kernel)) continue; // Non compilé ou non supporté ici
+        const CountInliersFn fn = count_inliers_kernel();
+        const char* name = count_inliers_kernel_name();
+        checked++;
+        for (const Plane& p : planes) {
+            for (size_t offset = 0; offset <= kMaxOffset; ++offset) {
+                for (size_t count = 0; count <= kMaxCount; ++count) {
+                    const float* px = x.data() + offset;
+                    const float* py = y.data() + offset;
+                    const float* pz = z.data() + offset;
+                    const int expected = count_inliers_scalar(px, py, pz, count, p.a, p.b, p.c, p.d, p.threshold);
+                    const int got = fn(px, py, pz, count, p.a, p.b, p.c, p.d, p.threshold);
+                    if (got != expected) {
+                        std::fprintf(stderr, "count_inliers %s : %d au lieu de %d (n = %zu, décalage %zu, seuil %g)\n",
+                                     name, got, expected, count, offset, p.threshold);
+                        ok = false;
+                    }
+                }
+            }
+        }
+    }
+    set_count_inliers_kernel(RansacKernel::Auto);
+    std::printf("noyaux d'inliers : %d variante(s) comparée(s) à la référence scalaire, %s\n", checked,
+                ok ? "identiques" : "ÉCARTS");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!parse_args(argc, argv, config)) return 1;
+    if (!check_inlier_kernels()) return 1;
+    if (config.check_only) return 0;
+
+    std::vector<Nv12Frame> frames;
+    if (!config.nv12_path.empty()) {
+        Nv12Frame frame;
+        if (!load_nv12(config.nv12_path, config.nv12_width, config.nv12_height, frame)) return 1;
+        frames.push_back(std::move(frame));
+    } else {
+        frames.push_back(make_nv12(640, 480));
+        frames.push_back(make_nv12(1280, 720));
+        frames.push_back(make_nv12(1920, 1080));
+    }
+
+    DepthMap depth;
+    if (!config.depth_path.empty()) {
+        if (!load_depth(config.depth_path, depth)) return 1;
+    } else {
+        depth = make_corridor_depth();
+        quantize(depth);
+    }
+
+    std::printf("native_bench : %d itérations (+%d de chauffe) par noyau, graine RANSAC %u\n",
+                config.iterations, config.warmup, config.seed);
+    std::printf("%-44s %10s %10s %10s %10s %10s\n", "noyau", "p50 µs", "p90 µs", "p99 µs",
+                "appels/s", "Mpix/s");
+    for (const Nv12Frame& frame : frames) bench_nv12(config, frame);
+    bench_depth(config, depth);
+    bench_inlier_kernels(config);
+    if (!config.model_path.empty()) {
+        if (pipeline_has_tflite() == 0) {
+            std::fprintf(stderr, "--model : native_processing compilée sans TFLite (NATIVE_WITH_TFLITE=OFF)\n");
+            return 1;
+        }
+        for (const Nv12Frame& frame : frames) bench_process_frame(config, frame);
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// android/app/src/main/cpp/depth_filter.cpp
+
+#include "image_utils.h" // Pour les déclarations exportées
+#include "depth_input.h" // Table de déquantification de la sortie 8 bits
+
+#include <limits>   // Pour l'infini (détection de saut désactivée)
+#include <stdint.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Outils internes ---
+
+namespace {
+
+// La sortie 8 bits est déquantifiée par blocs dans un tableau sur la pile, puis
+// filtrée par la même passe vectorielle que la carte float.
+constexpr size_t kBlockSize = 256;
+
+// Mise à jour d'un pixel : moyenne exponentielle, sauf saut (|x - s| > jump : vrai
+// changement de scène, l'estimation repart de la mesure) ; une mesure NaN est ignorée.
+// Même suite d'opérations IEEE que les variantes vectorielles (s + alpha * (x - s),
+// sans FMA) : résultats identiques bit à bit.
+inline float filter_pixel(float state, float x, float alpha, float jump) {
+    if (x != x) return state;                  // Mesure NaN : estimation conservée
+    const float diff = x - state;
+    const float magnitude = diff < 0.0f ? -diff : diff;
+    if (!(magnitude <= jump)) return x;        // Saut (ou estimation NaN)
+    return state + alpha * diff;
+}
+
+// Filtre `count` pixels contigus de `state` avec les mesures `values`.
+void filter_segment(float* state, const float* values, size_t count, float alpha, float jump) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    {
+        const __m128 valpha = _mm_set1_ps(alpha);
+        const __m128 vjump = _mm_set1_ps(jump);
+        const __m128 vabs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        for (; i + 4 <= count; i += 4) {
+            const __m128 s = _mm_loadu_ps(state + i);
+            const __m128 x = _mm_loadu_ps(values + i);
+            const __m128 diff = _mm_sub_ps(x, s);
+            const __m128 smoothed = _mm_add_ps(s, _mm_mul_ps(valpha, diff));
+            const __m128 jumped = _mm_cmpnle_ps(_mm_and_ps(diff, vabs), vjump); // Vrai aussi si NaN
+            const __m128 missing = _mm_cmpunord_ps(x, x);
+            __m128 out = _mm_or_ps(_mm_and_ps(jumped, x), _mm_andnot_ps(jumped, smoothed));
+            out = _mm_or_ps(_mm_and_ps(missing, s), _mm_andnot_ps(missing, out));
+            _mm_storeu_ps(state + i, out);
+        }
+    }
+#elif defined(__aarch64__)
+    {
+        const float32x4_t valpha = vdupq_n_f32(alpha);
+        const float32x4_t vjump = vdupq_n_f32(jump);
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t s = vld1q_f32(state + i);
+            const float32x4_t x = vld1q_f32(values + i);
+            const float32x4_t diff = vsubq_f32(x, s);
+            // vmulq + vaddq séparés (pas de vfmaq) pour garder l'arrondi de la référence.
+            const float32x4_t smoothed = vaddq_f32(s, vmulq_f32(valpha, diff));
+            const uint32x4_t within = vcleq_f32(vabsq_f32(diff), vjump); // Faux si NaN
+            const uint32x4_t present = vceqq_f32(x, x);                  // Faux si NaN
+            float32x4_t out = vbslq_f32(within, smoothed, x);
+            out = vbslq_f32(present, out, s);
+            vst1q_f32(state + i, out);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        state[i] = filter_pixel(state[i], values[i], alpha, jump);
+    }
+}
+
+// Paramètres communs ; jump <= 0 désactive la détection de saut.
+bool valid_filter_params(const float* state, const void* values, int count, float alpha, float& jump) {
+    if (state == nullptr || values == nullptr || count <= 0 || !(alpha > 0.0f && alpha <= 1.0f)) {
+        LOGE("temporal_filter_depth : paramètres invalides (count %d, alpha %f)", count, alpha);
+        return false;
+    }
+    if (!(jump > 0.0f)) jump = std::numeric_limits<float>::infinity();
+    return true;
+}
+
+} // namespace
+
+
+// --- Filtre temporel de la carte de profondeur ---
+
+extern "C" int temporal_filter_depth(float* state,
+                                     const float* depth_map_data,
+                                     int count,
+                                     float alpha,
+                                     float jump_threshold) {
+    if (!valid_filter_params(state, depth_map_data, count, alpha, jump_threshold)) return 0;
+    filter_segment(state, depth_map_data, static_cast<size_t>(count), alpha, jump_threshold);
+    return 1;
+}
+
+extern "C" int temporal_filter_depth_q8(float* state,
+                                        const uint8_t* depth_q8,
+                                        int count,
+                                        int format, float scale, int zero_point,
+                                        float alpha,
+                                        float jump_threshold) {
+    DepthInput input;
+    if (!valid_filter_params(state, depth_q8, count, alpha, jump_threshold) ||
+        !DepthInput::from_q8(depth_q8, format, scale, zero_point, input)) {
+        return 0;
+    }
+    float block[kBlockSize];
+    for (size_t start = 0; start < static_cast<size_t>(count); start += kBlockSize) {
+        const size_t n = static_cast<size_t>(count) - start < kBlockSize ? static_cast<size_t>(count) - start : kBlockSize;
+        for (size_t i = 0; i < n; ++i) block[i] = input.lut[depth_q8[start + i]];
+        filter_segment(state + start, block, n, alpha, jump_threshold);
+    }
+    return 1;
+}
@@ -0,0 +1,51 @@
+// android/app/src/main/cpp/depth_input.h
+// En-tête interne (C++) : vue sur la carte de profondeur en entrée de l'analyse,
+// float ou sortie 8 bits quantifiée du modèle (déquantifiée à la volée).
+
+#ifndef DEPTH_INPUT_H
+#define DEPTH_INPUT_H
+
+#include "image_utils.h" // Pour DEPTH_FORMAT_*
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Carte de profondeur inverse, w * h valeurs.
+// En 8 bits, valeur = scale * (q - zero_point) : les 256 valeurs possibles sont
+// déquantifiées une fois dans une table, la lecture d'un pixel est un accès à cette
+// table. Les résultats sont identiques à ceux obtenus sur la carte déquantifiée en float.
+struct DepthInput {
+    const float* f32 = nullptr;
+    const uint8_t* q8 = nullptr;
+    int32_t format = DEPTH_FORMAT_F32;
+    float lut[256];
+
+    // Carte float (pas de table).
+    static DepthInput from_f32(const float* data) {
+        DepthInput input;
+        input.f32 = data;
+        input.format = DEPTH_FORMAT_F32;
+        return input;
+    }
+
+    // Carte 8 bits (DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8). Retourne false si le format est inconnu.
+    static bool from_q8(const uint8_t* data, int32_t format, float scale, int32_t zero_point,
+                        DepthInput& out) {
+        if (format != DEPTH_FORMAT_U8 && format != DEPTH_FORMAT_S8) return false;
+        out.f32 = nullptr;
+        out.q8 = data;
+        out.format = format;
+        for (int byte = 0; byte < 256; ++byte) {
+            // En int8, l'octet est relu en complément à deux.
+            const int32_t q = format == DEPTH_FORMAT_S8 ? static_cast<int32_t>(static_cast<int8_t>(byte)) : byte;
+            out.lut[byte] = scale * static_cast<float>(q - zero_point);
+        }
+        return true;
+    }
+
+    bool valid() const { return f32 != nullptr || q8 != nullptr; }
+
+    float at(size_t index) const { return q8 != nullptr ? lut[q8[index]] : f32[index]; }
+};
+
+#endif // DEPTH_INPUT_H
@@ -0,0 +1,137 @@
+// android/app/src/main/cpp/depth_integral.cpp
+
+#include "depth_integral.h"
+#include "image_utils.h" // Pour les déclarations exportées
+
+#include <stdint.h>
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Outils internes ---
+
+namespace {
+
+inline int32_t clamp_coordinate(int32_t value, int32_t limit) {
+    return value < 0 ? 0 : (value > limit ? limit : value);
+}
+
+} // namespace
+
+
+// --- Implémentation ---
+
+bool DepthIntegral::reserve(int table_width, int table_height) {
+    const size_t entries = static_cast<size_t>(table_width + 1) * (table_height + 1);
+    return sum.reserve(entries) && valid.reserve(entries) && above.reserve(entries) &&
+           row_buffer.reserve(static_cast<size_t>(table_width));
+}
+
+bool DepthIntegral::build(const DepthInput& depth, int map_width, int map_height, float map_threshold) {
+    built = false;
+    if (!depth.valid() || map_width <= 0 || map_height <= 0) {
+        LOGE("build_depth_integral : paramètres invalides (%dx%d).", map_width, map_height);
+        return false;
+    }
+    if (!reserve(map_width, map_height)) {
+        LOGE("build_depth_integral : échec d'allocation des tables.");
+        return false;
+    }
+    width = map_width;
+    height = map_height;
+    threshold = map_threshold;
+
+    const size_t stride = static_cast<size_t>(width) + 1;
+    double* sums = sum.data();
+    int32_t* valids = valid.data();
+    int32_t* aboves = above.data();
+
+    // Première ligne et première colonne à 0 (rectangles vides).
+    for (size_t x = 0; x < stride; ++x) { sums[x] = 0.0; valids[x] = 0; aboves[x] = 0; }
+
+    // Ligne y + 1 = ligne y + cumul de la ligne courante. Les trois cumuls sont
+    // indépendants : leurs chaînes de dépendance s'entrelacent.
+    float* row_values = row_buffer.data();
+    for (int y = 0; y < height; ++y) {
+        const size_t source = static_cast<size_t>(y) * width;
+        const float* values = depth.f32 + source;
+        if (depth.q8 != nullptr) { // Déquantification de la ligne via la table
+            for (int x = 0; x < width; ++x) row_values[x] = depth.lut[depth.q8[source + x]];
+            values = row_values;
+        }
+        const double* sums_above = sums + static_cast<size_t>(y) * stride;
+        const int32_t* valids_above = valids + static_cast<size_t>(y) * stride;
+        const int32_t* aboves_above = aboves + static_cast<size_t>(y) * stride;
+        double* sums_row = sums + static_cast<size_t>(y + 1) * stride;
+        int32_t* valids_row = valids + static_cast<size_t>(y + 1) * stride;
+        int32_t* aboves_row = aboves + static_cast<size_t>(y + 1) * stride;
+        sums_row[0] = 0.0; valids_row[0] = 0; aboves_row[0] = 0;
+
+        double row_sum = 0.0;
+        int32_t row_valid = 0, row_above = 0;
+        for (int x = 0; x < width; ++x) {
+            const float value = values[x];
+            // NaN / infini : ni somme ni compte (value - value n'est nul que pour un fini).
+            const bool finite = value - value == 0.0f;
+            row_sum += finite ? static_cast<double>(value) : 0.0;
+            row_valid += finite ? 1 : 0;
+            row_above += finite && value > threshold ? 1 : 0;
+            sums_row[x + 1] = sums_above[x + 1] + row_sum;
+            valids_row[x + 1] = valids_above[x + 1] + row_valid;
+            aboves_row[x + 1] = aboves_above[x + 1] + row_above;
+        }
+    }
+    built = true;
+    return true;
+}
+
+RegionStats DepthIntegral::query(const DepthRegion& region) const {
+    RegionStats stats{};
+    if (!built) return stats;
+    const int32_t x0 = clamp_coordinate(region.x0, width), x1 = clamp_coordinate(region.x1, width);
+    const int32_t y0 = clamp_coordinate(region.y0, height), y1 = clamp_coordinate(region.y1, height);
+    if (x1 <= x0 || y1 <= y0) return stats;
+
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const size_t a = y0 * stride + x0, b = y0 * stride + x1;
+    const size_t c = y1 * stride + x0, d = y1 * stride + x1;
+    const int32_t count = valid.data()[d] - valid.data()[b] - valid.data()[c] + valid.data()[a];
+    if (count <= 0) return stats;
+    const double total = sum.data()[d] - sum.data()[b] - sum.data()[c] + sum.data()[a];
+    const int32_t count_above = above.data()[d] - above.data()[b] - above.data()[c] + above.data()[a];
+
+    stats.valid_count = count;
+    stats.mean = static_cast<float>(total / count);
+    stats.fraction_above = static_cast<float>(count_above) / static_cast<float>(count);
+    return stats;
+}
+
+extern "C" int query_depth_regions(const float* depth_map_data,
+                                   int width, int height, float threshold,
+                                   const DepthRegion* regions, int region_count,
+                                   RegionStats* out_stats) {
+    if (depth_map_data == nullptr || regions == nullptr || out_stats == nullptr || region_count < 0) return 0;
+    DepthIntegral integral;
+    if (!integral.build(DepthInput::from_f32(depth_map_data), width, height, threshold)) return 0;
+    for (int i = 0; i < region_count; ++i) out_stats[i] = integral.query(regions[i]);
+    return region_count;
+}
+
+extern "C" int query_depth_regions_q8(const uint8_t* depth_q8,
+                                      int width, int height,
+                                      int format, float scale, int zero_point,
+                                      float threshold,
+                                      const DepthRegion* regions, int region_count,
+                                      RegionStats* out_stats) {
+    DepthInput depth;
+    if (depth_q8 == nullptr || regions == nullptr || out_stats == nullptr || region_count < 0 ||
+        !DepthInput::from_q8(depth_q8, format, scale, zero_point, depth)) {
+        LOGE("query_depth_regions_q8 : paramètres ou format invalides (%d).", format);
+        return 0;
+    }
+    DepthIntegral integral;
+    if (!integral.build(depth, width, height, threshold)) return 0;
+    for (int i = 0; i < region_count; ++i) out_stats[i] = integral.query(regions[i]);
+    return region_count;
+}
@@ -0,0 +1,34 @@
+// android/app/src/main/cpp/depth_integral.h
+// En-tête interne (C++) : tables cumulées de la carte de profondeur, partagé avec le contexte.
+
+#ifndef DEPTH_INTEGRAL_H
+#define DEPTH_INTEGRAL_H
+
+#include "image_utils.h"   // Pour DepthRegion et RegionStats
+#include "native_memory.h" // Pour AlignedBuffer
+#include "depth_input.h"   // Pour DepthInput
+
+#include <stdint.h>
+
+// Tables cumulées (summed-area tables) d'une carte de profondeur, (width + 1) * (height + 1)
+// entrées chacune : l'entrée (x, y) couvre le rectangle [0, x[ x [0, y[. Construites en
+// une passe, elles donnent la somme, le nombre de pixels valides (finis) et le nombre de
+// pixels au-dessus du seuil de n'importe quel rectangle en quatre lectures.
+// Sommes en double : sur 256x256 pixels, un float perdrait les petites régions.
+struct DepthIntegral {
+    AlignedBuffer<double> sum;
+    AlignedBuffer<int32_t> valid;
+    AlignedBuffer<int32_t> above;
+    AlignedBuffer<float> row_buffer; // Ligne déquantifiée (entrée 8 bits)
+    int width = 0, height = 0;
+    float threshold = 0.0f;
+    bool built = false;
+
+    bool reserve(int width, int height);
+    // Construit les tables pour la carte donnée. false si les paramètres sont invalides.
+    bool build(const DepthInput& depth, int width, int height, float threshold);
+    // Statistiques d'un rectangle (ramené à la carte ; vide : tout à 0).
+    RegionStats query(const DepthRegion& region) const;
+};
+
+#endif // DEPTH_INTEGRAL_H
@@ -0,0 +1,124 @@
+// android/app/src/main/cpp/depth_pyramid.cpp
+
+#include "depth_pyramid.h"
+#include "image_utils.h" // Pour les déclarations exportées
+
+#include <stdint.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Outils internes ---
+
+namespace {
+
+// Une ligne du niveau suivant : out[i] = moyenne du bloc 2x2 (top, bottom)[2i, 2i + 1].
+// 4 sorties par itération : somme verticale, puis somme des voisins pairs / impairs
+// (désentrelacement par shuffle en SSE2, par vld2 en NEON).
+void reduce_rows_2x2(const float* top, const float* bottom, int out_width, float* out) {
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    for (; i + 4 <= out_width; i += 4) {
+        const __m128 low = _mm_add_ps(_mm_loadu_ps(top + 2 * i), _mm_loadu_ps(bottom + 2 * i));
+        const __m128 high = _mm_add_ps(_mm_loadu_ps(top + 2 * i + 4), _mm_loadu_ps(bottom + 2 * i + 4));
+        const __m128 even = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 odd = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(even, odd), quarter));
+    }
+#elif defined(__aarch64__)
+    const float32x4_t quarter = vdupq_n_f32(0.25f);
+    for (; i + 4 <= out_width; i += 4) {
+        const float32x4x2_t a = vld2q_f32(top + 2 * i);
+        const float32x4x2_t b = vld2q_f32(bottom + 2 * i);
+        const float32x4_t sum = vaddq_f32(vaddq_f32(a.val[0], a.val[1]), vaddq_f32(b.val[0], b.val[1]));
+        vst1q_f32(out + i, vmulq_f32(sum, quarter));
+    }
+#endif
+    // Même ordre d'opérations que la voie vectorielle : résultat identique.
+    for (; i < out_width; ++i) {
+        const float even = top[2 * i] + bottom[2 * i];
+        const float odd = top[2 * i + 1] + bottom[2 * i + 1];
+        out[i] = (even + odd) * 0.25f;
+    }
+}
+
+// Niveau suivant d'une carte float (width x height -> width / 2 x height / 2).
+void reduce_map_2x2(const float* source, int width, int height, float* out) {
+    const int out_width = width / 2, out_height = height / 2;
+    for (int y = 0; y < out_height; ++y) {
+        const float* top = source + static_cast<size_t>(2 * y) * width;
+        reduce_rows_2x2(top, top + width, out_width, out + static_cast<size_t>(y) * out_width);
+    }
+}
+
+} // namespace
+
+
+// --- Implémentation ---
+
+bool DepthPyramid::reserve(int width, int height) {
+    for (int level = 1; level < DEPTH_PYRAMID_LEVELS; ++level) {
+        const size_t count = static_cast<size_t>(width >> level) * static_cast<size_t>(height >> level);
+        if (count > 0 && !levels[level].reserve(count)) return false;
+    }
+    return row_buffer.reserve(2 * static_cast<size_t>(width));
+}
+
+bool DepthPyramid::build(const DepthInput& depth, int width, int height, int level_count) {
+    built_levels = 0;
+    if (!depth.valid() || width <= 0 || height <= 0 ||
+        level_count < 1 || level_count > DEPTH_PYRAMID_LEVELS ||
+        (width >> (level_count - 1)) < 1 || (height >> (level_count - 1)) < 1) {
+        LOGE("build_depth_pyramid : paramètres invalides (%dx%d, %d niveaux).", width, height, level_count);
+        return false;
+    }
+    if (!reserve(width, height)) {
+        LOGE("build_depth_pyramid : échec d'allocation des niveaux.");
+        return false;
+    }
+    widths[0] = width;
+    heights[0] = height;
+    for (int level = 1; level < level_count; ++level) {
+        widths[level] = width >> level;
+        heights[level] = height >> level;
+    }
+
+    if (level_count > 1) {
+        if (depth.q8 != nullptr) {
+            // Entrée 8 bits : les deux lignes de chaque bloc sont déquantifiées via la table.
+            float* top = row_buffer.data();
+            float* bottom = top + width;
+            for (int y = 0; y < heights[1]; ++y) {
+                const size_t row = static_cast<size_t>(2 * y) * width;
+                for (int x = 0; x < width; ++x) {
+                    top[x] = depth.lut[depth.q8[row + x]];
+                    bottom[x] = depth.lut[depth.q8[row + width + x]];
+                }
+                reduce_rows_2x2(top, bottom, widths[1], levels[1].data() + static_cast<size_t>(y) * widths[1]);
+            }
+        } else {
+            reduce_map_2x2(depth.f32, width, height, levels[1].data());
+        }
+    }
+    for (int level = 2; level < level_count; ++level) {
+        reduce_map_2x2(levels[level - 1].data(), widths[level - 1], heights[level - 1], levels[level].data());
+    }
+    built_levels = level_count;
+    return true;
+}
+
+extern "C" int downsample_depth_2x2(const float* depth_map_data, int width, int height,
+                                    float* out_depth) {
+    if (depth_map_data == nullptr || out_depth == nullptr || width < 2 || height < 2) return 0;
+    reduce_map_2x2(depth_map_data, width, height, out_depth);
+    return 1;
+}
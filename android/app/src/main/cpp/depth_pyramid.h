@@ -0,0 +1,30 @@
+// android/app/src/main/cpp/depth_pyramid.h
+// En-tête interne (C++) : pyramide de la carte de profondeur, partagée avec RANSAC et le contexte.
+
+#ifndef DEPTH_PYRAMID_H
+#define DEPTH_PYRAMID_H
+
+#include "image_utils.h"   // Pour DEPTH_PYRAMID_LEVELS
+#include "native_memory.h" // Pour AlignedBuffer
+#include "depth_input.h"   // Pour DepthInput
+
+// Pyramide (mip) de la carte de profondeur inverse : le niveau l est la moyenne 2x2 du
+// niveau l - 1, de dimensions (largeur >> l, hauteur >> l) ; une ligne ou colonne
+// impaire du niveau précédent est ignorée. Le niveau 0 est la carte source (non copiée).
+// Les niveaux gardent leur capacité d'un appel à l'autre.
+struct DepthPyramid {
+    AlignedBuffer<float> levels[DEPTH_PYRAMID_LEVELS]; // levels[0] inutilisé
+    AlignedBuffer<float> row_buffer;                   // Deux lignes déquantifiées (entrée 8 bits)
+    int widths[DEPTH_PYRAMID_LEVELS] = {};
+    int heights[DEPTH_PYRAMID_LEVELS] = {};
+    int built_levels = 0; // Niveaux valides, source comprise (0 : rien de construit)
+
+    bool reserve(int width, int height);
+    // Construit les niveaux 1 .. level_count - 1 à partir de `depth`.
+    // false si les paramètres sont invalides ou si un niveau serait vide.
+    bool build(const DepthInput& depth, int width, int height, int level_count);
+    // Vue sur le niveau `level` (1 .. built_levels - 1).
+    DepthInput level_input(int level) const { return DepthInput::from_f32(levels[level].data()); }
+};
+
+#endif // DEPTH_PYRAMID_H
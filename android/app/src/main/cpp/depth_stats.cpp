@@ -0,0 +1,285 @@
+// android/app/src/main/cpp/depth_stats.cpp
+
+#include "image_utils.h" // Pour DepthStats et la déclaration exportée
+#include "depth_input.h" // Table de déquantification de la sortie 8 bits
+
+#include <stdint.h>
+#include <string.h>      // Pour memset
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+// --- Outils internes ---
+
+namespace {
+
+// Les pixels sont traités par blocs : les indices de classe d'un bloc sont calculés
+// dans un tableau sur la pile (dans la passe vectorielle), puis l'histogramme est
+// incrémenté (dispersion, forcément scalaire).
+constexpr size_t kBlockSize = 256;
+
+// Accumulateurs indépendants par voie (2 registres de 4 floats) : ni la réduction max
+// ni le comptage ne créent de dépendance d'une itération à l'autre. Variantes SSE2 /
+// NEON explicites (la vectorisation automatique d'un max flottant sans -ffast-math
+// dépend trop du compilateur), boucle scalaire par voies sinon et pour le reste.
+constexpr size_t kLanes = 8;
+
+struct SegmentAccumulator {
+    float lane_max[kLanes];
+    int32_t lane_free[kLanes];
+
+    SegmentAccumulator() {
+        for (size_t l = 0; l < kLanes; ++l) { lane_max[l] = 0.0f; lane_free[l] = 0; }
+    }
+};
+
+// Classe d'histogramme d'une valeur (négatif ou NaN -> 0, au-delà -> dernière classe).
+inline int32_t histogram_bin(float value, float bin_scale, float last_bin) {
+    float bin = value * bin_scale;
+    bin = bin >= 0.0f ? bin : 0.0f;
+    bin = bin < last_bin ? bin : last_bin;
+    return static_cast<int32_t>(bin);
+}
+
+// Parcourt `count` valeurs contiguës : max, pixels libres (< free_threshold) et
+// histogramme. Les NaN ne changent ni le max ni les comptes libres et vont dans la
+// première classe.
+void scan_segment(const float* values, size_t count, float free_threshold, float bin_scale,
+                  SegmentAccumulator& acc, int32_t* histogram) {
+    const float last_bin = static_cast<float>(DEPTH_STATS_HISTOGRAM_BINS - 1);
+    int32_t bins[kBlockSize];
+
+    // Copies locales des voies : pas d'alias possible avec `values` ou `bins`.
+    float lane_max[kLanes];
+    int32_t lane_free[kLanes];
+    for (size_t l = 0; l < kLanes; ++l) { lane_max[l] = acc.lane_max[l]; lane_free[l] = acc.lane_free[l]; }
+
+    for (size_t start = 0; start < count; start += kBlockSize) {
+        const size_t n = count - start < kBlockSize ? count - start : kBlockSize;
+        const float* block = values + start;
+
+        // Max et pixels libres (réductions réparties sur kLanes voies), puis classes.
+        // Le max garde la voie courante si la valeur est NaN, comme la boucle scalaire.
+        size_t i = 0;
+#if defined(__SSE2__)
+        {
+            const __m128 vthr = _mm_set1_ps(free_threshold);
+            const __m128 vscale = _mm_set1_ps(bin_scale);
+            const __m128 vzero = _mm_setzero_ps();
+            const __m128 vlast = _mm_set1_ps(last_bin);
+            __m128 max0 = _mm_loadu_ps(lane_max), max1 = _mm_loadu_ps(lane_max + 4);
+            __m128i free0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane_free));
+            __m128i free1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane_free + 4));
+            for (; i + kLanes <= n; i += kLanes) {
+                const __m128 v0 = _mm_loadu_ps(block + i);
+                const __m128 v1 = _mm_loadu_ps(block + i + 4);
+                max0 = _mm_max_ps(v0, max0); // NaN dans v0 -> max0 conservé
+                max1 = _mm_max_ps(v1, max1);
+                free0 = _mm_sub_epi32(free0, _mm_castps_si128(_mm_cmplt_ps(v0, vthr)));
+                free1 = _mm_sub_epi32(free1, _mm_castps_si128(_mm_cmplt_ps(v1, vthr)));
+                // Classes : max(x, 0) donne 0 pour un NaN (second opérande), puis min(x, last)
+                const __m128 b0 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(v0, vscale), vzero), vlast);
+                const __m128 b1 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(v1, vscale), vzero), vlast);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(bins + i), _mm_cvttps_epi32(b0));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(bins + i + 4), _mm_cvttps_epi32(b1));
+            }
+            _mm_storeu_ps(lane_max, max0);
+            _mm_storeu_ps(lane_max + 4, max1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lane_free), free0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lane_free + 4), free1);
+        }
+#elif defined(__aarch64__)
+        {
+            const float32x4_t vthr = vdupq_n_f32(free_threshold);
+            const float32x4_t vscale = vdupq_n_f32(bin_scale);
+            const float32x4_t vzero = vdupq_n_f32(0.0f);
+            const float32x4_t vlast = vdupq_n_f32(last_bin);
+            float32x4_t max0 = vld1q_f32(lane_max), max1 = vld1q_f32(lane_max + 4);
+            int32x4_t free0 = vld1q_s32(lane_free), free1 = vld1q_s32(lane_free + 4);
+            for (; i + kLanes <= n; i += kLanes) {
+                const float32x4_t v0 = vld1q_f32(block + i);
+                const float32x4_t v1 = vld1q_f32(block + i + 4);
+                // vmaxq propage les NaN : sélection explicite à la place.
+                max0 = vbslq_f32(vcgtq_f32(v0, max0), v0, max0);
+                max1 = vbslq_f32(vcgtq_f32(v1, max1), v1, max1);
+                free0 = vsubq_s32(free0, vreinterpretq_s32_u32(vcltq_f32(v0, vthr)));
+                free1 = vsubq_s32(free1, vreinterpretq_s32_u32(vcltq_f32(v1, vthr)));
+                // Classes : comparaison >= 0 fausse pour un NaN -> 0, puis min(x, last)
+                float32x4_t b0 = vmulq_f32(v0, vscale);
+                float32x4_t b1 = vmulq_f32(v1, vscale);
+                b0 = vminq_f32(vbslq_f32(vcgeq_f32(b0, vzero), b0, vzero), vlast);
+                b1 = vminq_f32(vbslq_f32(vcgeq_f32(b1, vzero), b1, vzero), vlast);
+                vst1q_s32(bins + i, vcvtq_s32_f32(b0));
+                vst1q_s32(bins + i + 4, vcvtq_s32_f32(b1));
+            }
+            vst1q_f32(lane_max, max0);
+            vst1q_f32(lane_max + 4, max1);
+            vst1q_s32(lane_free, free0);
+            vst1q_s32(lane_free + 4, free1);
+        }
+#endif
+        for (; i + kLanes <= n; i += kLanes) {
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float value = block[i + l];
+                lane_max[l] = value > lane_max[l] ? value : lane_max[l];
+                lane_free[l] += value < free_threshold ? 1 : 0;
+                bins[i + l] = histogram_bin(value, bin_scale, last_bin);
+            }
+        }
+        for (; i < n; ++i) { // Reste du bloc
+            const float value = block[i];
+            lane_max[0] = value > lane_max[0] ? value : lane_max[0];
+            lane_free[0] += value < free_threshold ? 1 : 0;
+            bins[i] = histogram_bin(value, bin_scale, last_bin);
+        }
+
+        for (size_t k = 0; k < n; ++k) histogram[bins[k]]++;
+    }
+
+    for (size_t l = 0; l < kLanes; ++l) { acc.lane_max[l] = lane_max[l]; acc.lane_free[l] = lane_free[l]; }
+}
+
+int32_t total_free(const SegmentAccumulator& acc) {
+    int32_t total = 0;
+    for (size_t l = 0; l < kLanes; ++l) total += acc.lane_free[l];
+    return total;
+}
+
+// Comptes des 256 valeurs d'octet d'une carte quantifiée. Quatre sous-tables
+// incrémentées à tour de rôle : des octets identiques consécutifs (fréquents, la
+// carte est lisse) ne s'attendent pas les uns les autres sur la même case mémoire.
+struct ByteCounts {
+    uint32_t sub[4][256];
+
+    ByteCounts() { memset(sub, 0, sizeof(sub)); }
+
+    void add(const uint8_t* values, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            sub[0][values[i]]++;
+            sub[1][values[i + 1]]++;
+            sub[2][values[i + 2]]++;
+            sub[3][values[i + 3]]++;
+        }
+        for (; i < count; ++i) sub[0][values[i]]++;
+    }
+
+    uint32_t total(int byte) const { return sub[0][byte] + sub[1][byte] + sub[2][byte] + sub[3][byte]; }
+};
+
+} // namespace
+
+
+// --- Implémentation ---
+
+extern "C" int compute_depth_stats(const float* depth_map_data,
+                                   int width, int height,
+                                   float free_path_threshold,
+                                   float histogram_max,
+                                   DepthStats* out_stats) {
+    if (depth_map_data == nullptr || out_stats == nullptr ||
+        width <= 0 || height <= 0 || !(histogram_max > 0.0f)) {
+        return 0;
+    }
+
+    DepthStats stats;
+    memset(&stats, 0, sizeof(stats));
+    const float bin_scale = static_cast<float>(DEPTH_STATS_HISTOGRAM_BINS) / histogram_max;
+
+    // Même découpage que l'ancienne boucle Dart : moitié basse à partir de height / 2,
+    // tiers gauche [0, w/3), tiers droit [w - w/3, w), centre entre les deux.
+    const int start_y = height / 2;
+    const int third = width / 3;
+    const size_t row = static_cast<size_t>(width);
+
+    // Moitié haute : seuls le max et l'histogramme comptent (comptes libres ignorés).
+    SegmentAccumulator top;
+    scan_segment(depth_map_data, row * start_y, free_path_threshold, bin_scale, top, stats.histogram);
+
+    // Moitié basse : un accumulateur par secteur, même passe.
+    SegmentAccumulator left, center, right;
+    for (int y = start_y; y < height; ++y) {
+        const float* line = depth_map_data + row * y;
+        scan_segment(line, third, free_path_threshold, bin_scale, left, stats.histogram);
+        scan_segment(line + third, width - 2 * third, free_path_threshold, bin_scale, center, stats.histogram);
+        scan_segment(line + width - third, third, free_path_threshold, bin_scale, right, stats.histogram);
+    }
+
+    float max_value = 0.0f;
+    const SegmentAccumulator* accumulators[] = {&top, &left, &center, &right};
+    for (const SegmentAccumulator* acc : accumulators) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            max_value = acc->lane_max[l] > max_value ? acc->lane_max[l] : max_value;
+        }
+    }
+    stats.max_closeness = max_value;
+    stats.free_left = total_free(left);
+    stats.free_center = total_free(center);
+    stats.free_right = total_free(right);
+    stats.total_considered = (height - start_y) * width;
+
+    *out_stats = stats;
+    return 1;
+}
+
+extern "C" int compute_depth_stats_q8(const uint8_t* depth_q8,
+                                      int width, int height,
+                                      int format, float scale, int zero_point,
+                                      float free_path_threshold,
+                                      float histogram_max,
+                                      DepthStats* out_stats) {
+    DepthInput depth;
+    if (depth_q8 == nullptr || out_stats == nullptr ||
+        width <= 0 || height <= 0 || !(histogram_max > 0.0f) ||
+        !DepthInput::from_q8(depth_q8, format, scale, zero_point, depth)) {
+        return 0;
+    }
+
+    // Une seule passe sur la carte : comptage des octets par secteur (même découpage
+    // que compute_depth_stats). Tout le reste ne dépend que des 256 valeurs possibles.
+    const int start_y = height / 2;
+    const int third = width / 3;
+    const size_t row = static_cast<size_t>(width);
+
+    ByteCounts top, left, center, right;
+    top.add(depth_q8, row * start_y);
+    for (int y = start_y; y < height; ++y) {
+        const uint8_t* line = depth_q8 + row * y;
+        left.add(line, third);
+        center.add(line + third, width - 2 * third);
+        right.add(line + width - third, third);
+    }
+
+    DepthStats stats;
+    memset(&stats, 0, sizeof(stats));
+    const float bin_scale = static_cast<float>(DEPTH_STATS_HISTOGRAM_BINS) / histogram_max;
+    const float last_bin = static_cast<float>(DEPTH_STATS_HISTOGRAM_BINS - 1);
+    float max_value = 0.0f;
+    for (int byte = 0; byte < 256; ++byte) {
+        const uint32_t in_left = left.total(byte);
+        const uint32_t in_center = center.total(byte);
+        const uint32_t in_right = right.total(byte);
+        const uint32_t in_map = top.total(byte) + in_left + in_center + in_right;
+        if (in_map == 0) continue;
+
+        // Mêmes comparaisons que le chemin float, sur la valeur déquantifiée.
+        const float value = depth.lut[byte];
+        max_value = value > max_value ? value : max_value;
+        stats.histogram[histogram_bin(value, bin_scale, last_bin)] += static_cast<int32_t>(in_map);
+        if (value < free_path_threshold) {
+            stats.free_left += static_cast<int32_t>(in_left);
+            stats.free_center += static_cast<int32_t>(in_center);
+            stats.free_right += static_cast<int32_t>(in_right);
+        }
+    }
+    stats.max_closeness = max_value;
+    stats.total_considered = (height - start_y) * width;
+
+    *out_stats = stats;
+    return 1;
+}
@@ -0,0 +1,50 @@
+// android/app/src/main/cpp/frame_mailbox.cpp
+
+#include "frame_mailbox.h"
+
+
+bool FrameMailbox::reserve_all(size_t y_bytes, size_t uv_bytes, size_t v_bytes) {
+    for (FrameSlot& slot : slots_) {
+        if (!slot.y_plane.reserve(y_bytes) || !slot.uv_plane.reserve(uv_bytes) ||
+            !slot.v_plane.reserve(v_bytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameMailbox::reserve(size_t y_bytes, size_t uv_bytes, size_t v_bytes) {
+    FrameSlot& slot = write_slot();
+    return slot.y_plane.reserve(y_bytes) && slot.uv_plane.reserve(uv_bytes) && slot.v_plane.reserve(v_bytes);
+}
+
+void FrameMailbox::publish(const FrameInfo& info) {
+    FrameSlot& slot = write_slot();
+    slot.info = info;
+    slot.info.sequence = published_.load(std::memory_order_relaxed) + 1;
+
+    // release : les plans et l'info sont visibles avant l'index ; acquire : l'emplacement
+    // récupéré n'est plus lu par le consommateur (il l'a rendu par son propre échange).
+    const uint32_t previous = ready_.exchange(write_index_ | kFreshBit, std::memory_order_acq_rel);
+    write_index_ = previous & kIndexMask;
+
+    if ((previous & kFreshBit) != 0) overwritten_.fetch_add(1, std::memory_order_relaxed);
+    published_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool FrameMailbox::take() {
+    if ((ready_.load(std::memory_order_acquire) & kFreshBit) == 0) return false;
+    // Le producteur ne peut que republier entre-temps : l'échange rend toujours une trame fraîche.
+    const uint32_t previous = ready_.exchange(read_index_, std::memory_order_acq_rel);
+    read_index_ = previous & kIndexMask;
+    taken_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+MailboxStats FrameMailbox::stats() const {
+    MailboxStats stats;
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.taken = taken_.load(std::memory_order_relaxed);
+    stats.overwritten = overwritten_.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,73 @@
+// android/app/src/main/cpp/frame_mailbox.h
+// En-tête interne (C++) : boîte aux lettres de trames caméra du contexte de pipeline.
+
+#ifndef FRAME_MAILBOX_H
+#define FRAME_MAILBOX_H
+
+#include "image_utils.h"   // Pour FrameInfo et MailboxStats
+#include "native_memory.h" // Pour AlignedBuffer
+
+#include <atomic>
+#include <stdint.h>
+
+// Une trame déposée : plans Y/UV (capacités en octets) et leurs métadonnées.
+// Trame à trois plans : uv_plane reçoit le plan U et v_plane le plan V.
+struct FrameSlot {
+    AlignedBuffer<uint8_t> y_plane;
+    AlignedBuffer<uint8_t> uv_plane;
+    AlignedBuffer<uint8_t> v_plane;
+    FrameInfo info{};
+};
+
+// Triple tampon « la plus récente gagne », un producteur (rappel caméra) et un
+// consommateur (boucle de traitement), sans verrou :
+// - le producteur remplit son emplacement (write_slot()), puis publish() l'échange
+//   avec l'emplacement « prêt » ;
+// - le consommateur, via take(), échange son emplacement avec l'emplacement prêt
+//   s'il contient une trame qu'il n'a pas encore vue.
+// Chaque côté possède toujours un emplacement à lui : le dépôt ne bloque jamais, et
+// une trame publiée puis remplacée avant d'être prise est comptée comme écrasée.
+class FrameMailbox {
+public:
+    FrameMailbox() = default;
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    // Pré-alloue les plans des trois emplacements (création du contexte, avant tout dépôt).
+    bool reserve_all(size_t y_bytes, size_t uv_bytes, size_t v_bytes = 0);
+
+    // --- Côté producteur ---
+    // Emplacement en cours de remplissage (propriété exclusive du producteur).
+    FrameSlot& write_slot() { return slots_[write_index_]; }
+    // Garantit la capacité des plans de write_slot(). false si l'allocation échoue.
+    bool reserve(size_t y_bytes, size_t uv_bytes, size_t v_bytes = 0);
+    // Publie write_slot() avec `info` (sa séquence est attribuée ici) ; le producteur
+    // reçoit un autre emplacement.
+    void publish(const FrameInfo& info);
+
+    // --- Côté consommateur ---
+    // Récupère la trame la plus récente si elle n'a pas encore été prise.
+    // Retourne false sinon (read_slot() reste la trame précédente).
+    bool take();
+    // Dernière trame prise (propriété exclusive du consommateur jusqu'au take() suivant).
+    const FrameSlot& read_slot() const { return slots_[read_index_]; }
+
+    // Compteurs (lisibles depuis n'importe quel thread).
+    MailboxStats stats() const;
+
+private:
+    // Bit de l'index prêt : la trame n'a pas encore été prise.
+    static constexpr uint32_t kFreshBit = 0x4;
+    static constexpr uint32_t kIndexMask = 0x3;
+
+    FrameSlot slots_[3];
+    uint32_t write_index_ = 0;           // Producteur uniquement
+    uint32_t read_index_ = 1;            // Consommateur uniquement
+    std::atomic<uint32_t> ready_{2};     // Emplacement échangé (index | kFreshBit)
+
+    std::atomic<int64_t> published_{0};
+    std::atomic<int64_t> taken_{0};
+    std::atomic<int64_t> overwritten_{0};
+};
+
+#endif // FRAME_MAILBOX_H
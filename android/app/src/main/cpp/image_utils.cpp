@@ -1,20 +1,29 @@
 // android/app/src/main/cpp/image_utils.cpp
 
 #include "image_utils.h" // Notre en-tête
+#include "input_tensor.h" // Pour convert_rgb_rows (sortie float / fp16)
 #include <stdint.h>     // Pour uint8_t
+#include <vector>       // Pour les tables de colonnes du redimensionnement
 
+// libyuv : obligatoire sur Android, optionnelle sur Linux (NATIVE_HAS_LIBYUV est
+// défini par CMake). Sans libyuv, convert_yuv420sp_to_rgb utilise le repli portable
+// en fin de fichier.
+#ifndef NATIVE_HAS_LIBYUV
+#define NATIVE_HAS_LIBYUV 1
+#endif
+
+#if NATIVE_HAS_LIBYUV
 // Inclut l'en-tête principal de libyuv
 // NE COMPILERA PAS si libyuv n'est pas correctement intégré via CMake
 #include "libyuv.h" // Assurez-vous que ce chemin est trouvable par CMake après add_subdirectory
+#endif
 
-// Logging Android
-#include <android/log.h>
-#define LOG_TAG "NativeLib"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
 
 
 // --- Implémentation de la conversion YUV -> RGB (UTILISANT LIBYUV) ---
+#if NATIVE_HAS_LIBYUV
 
 // Cette version appelle libyuv pour une conversion performante.
 // Utilise NV12ToRAW (plan Y, puis plan UV entrelacé U, V, U, V...).
@@ -51,7 +60,331 @@ extern "C" void convert_yuv420sp_to_rgb(const uint8_t* y_plane,
     //     LOGD("Fin convert_yuv420sp_to_rgb (via libyuv::NV12ToRAW) : Succès");
     // }
 } // Fin de la fonction
+#endif // NATIVE_HAS_LIBYUV
+
+
+// --- Implémentation du prétraitement fusionné YUV -> entrée du modèle ---
+
+namespace {
+
+// Sature un entier dans [0, 255].
+inline uint8_t clamp_to_u8(int value) {
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// Conversion YUV -> RGB en virgule fixe 8 bits (BT.601, plage limitée :
+// 298 / 409 / 100 / 208 / 516). Même matrice que libyuv::NV12ToRAW (ancien chemin),
+// mais pas ses constantes (YG, UB, VR...) : les sorties peuvent différer d'une unité.
+inline void yuv_to_rgb(int y, int u, int v, uint8_t* out_rgb) {
+    const int c = (y - 16) * 298;
+    const int d = u - 128;
+    const int e = v - 128;
+    out_rgb[0] = clamp_to_u8((c + 409 * e + 128) >> 8);          // R
+    out_rgb[1] = clamp_to_u8((c - 100 * d - 208 * e + 128) >> 8); // G
+    out_rgb[2] = clamp_to_u8((c + 516 * d + 128) >> 8);          // B
+}
+
+// Échantillonnage d'un axe : pour chaque pixel de sortie, les deux pixels source
+// voisins, le poids bilinéaire (sur 8 bits) et l'échantillon chroma (demi-résolution),
+// déjà convertis en décalages d'octets dans les plans (stride pour les lignes, pas de
+// pixel pour les colonnes) : un pixel de sortie additionne un échantillon de chaque axe.
+struct AxisSample {
+    size_t y0, y1; // Décalages des deux échantillons luma voisins
+    size_t uv;     // Décalage de l'échantillon chroma le plus proche
+    int weight;    // Poids de y1, dans [0, 256]
+};
+
+// Construit la table d'échantillonnage d'un axe, en alignant les centres des pixels.
+// Calcul en virgule fixe 16.16 pour éviter les flottants dans la boucle principale.
+// `reversed` : table dans l'ordre inverse (axe retourné par la rotation) ; la sortie
+// tournée est ainsi exactement l'image redimensionnée, puis tournée.
+void build_axis_samples(int src_offset, int src_size, int dst_size,
+                        size_t luma_step, size_t chroma_step, bool reversed,
+                        std::vector<AxisSample>& out) {
+    out.resize(dst_size);
+    const int64_t step = (static_cast<int64_t>(src_size) << 16) / dst_size;
+    int64_t pos = (static_cast<int64_t>(src_offset) << 16) + step / 2 - (1 << 15);
+    const int64_t min_pos = static_cast<int64_t>(src_offset) << 16;
+    const int last = src_offset + src_size - 1;
+    for (int i = 0; i < dst_size; ++i, pos += step) {
+        const int64_t p = pos < min_pos ? min_pos : pos;
+        int i0 = static_cast<int>(p >> 16);
+        if (i0 > last) i0 = last;
+        const int i1 = i0 < last ? i0 + 1 : last;
+        const int weight = static_cast<int>((p >> 8) & 0xFF);
+        // Pixel le plus proche (arrondi), puis passage en demi-résolution pour la chroma.
+        const int nearest = weight >= 128 ? i1 : i0;
+        AxisSample& s = out[reversed ? dst_size - 1 - i : i];
+        s.y0 = static_cast<size_t>(i0) * luma_step;
+        s.y1 = static_cast<size_t>(i1) * luma_step;
+        s.uv = static_cast<size_t>(nearest >> 1) * chroma_step;
+        s.weight = weight;
+    }
+}
+
+// Plans d'une trame YUV 4:2:0 ; U et V lus au même décalage (entrelacés ou non).
+struct Yuv420Planes {
+    const uint8_t* y;
+    const uint8_t* u;
+    const uint8_t* v;
+};
+
+// Un pixel de sortie : 4 échantillons Y (bilinéaire) et 1 échantillon U/V (le plus proche).
+inline void sample_rgb(const Yuv420Planes& planes, const AxisSample& row, const AxisSample& col,
+                       uint8_t* out_rgb) {
+    const uint8_t* y_row0 = planes.y + row.y0;
+    const uint8_t* y_row1 = planes.y + row.y1;
+    const int wx = col.weight;
+    const int wy = row.weight;
+    const int top = y_row0[col.y0] * (256 - wx) + y_row0[col.y1] * wx;
+    const int bottom = y_row1[col.y0] * (256 - wx) + y_row1[col.y1] * wx;
+    const int luma = (top * (256 - wy) + bottom * wy + (1 << 15)) >> 16;
+    const size_t chroma = row.uv + col.uv;
+    yuv_to_rgb(luma, planes.u[chroma], planes.v[chroma], out_rgb);
+}
+
+// Tables d'échantillonnage d'une trame (recadrage, rotation, dimensions de sortie).
+// À 90 et 270 degrés, les lignes de sortie parcourent les colonnes source.
+// Sortie (ox, oy) <- source : 90 : (oy, H-1-ox) ; 180 : (W-1-ox, H-1-oy) ; 270 : (W-1-oy, ox).
+struct ResampleTables {
+    std::vector<AxisSample> cols; // Colonnes source, indexées par ox (oy si transposed)
+    std::vector<AxisSample> rows; // Lignes source, indexées par oy (ox si transposed)
+    bool transposed = false;
+};
+
+// Tables conservées d'un appel à l'autre (par thread) : pas d'allocation
+// en régime permanent, seulement un remplissage de out_width + out_height entrées.
+const ResampleTables& build_resample_tables(int y_stride, int uv_stride, int uv_pixel_stride, int rotation,
+                                            int crop_x, int crop_y, int crop_width, int crop_height,
+                                            int out_width, int out_height) {
+    static thread_local ResampleTables tables;
+    tables.transposed = rotation == 90 || rotation == 270;
+    build_axis_samples(crop_x, crop_width, tables.transposed ? out_height : out_width,
+                       1, static_cast<size_t>(uv_pixel_stride), rotation == 180 || rotation == 270, tables.cols);
+    build_axis_samples(crop_y, crop_height, tables.transposed ? out_width : out_height,
+                       static_cast<size_t>(y_stride), static_cast<size_t>(uv_stride),
+                       rotation == 90 || rotation == 180, tables.rows);
+    return tables;
+}
+
+// Lignes de sortie [row_begin, row_end[ en RGB888, écrites à partir de out_rows.
+void resample_rows(const Yuv420Planes& planes, const ResampleTables& tables,
+                   int row_begin, int row_end, uint8_t* out_rows, int out_width) {
+    const size_t out_row_bytes = static_cast<size_t>(out_width) * 3;
+    if (!tables.transposed) {
+        uint8_t* out = out_rows;
+        for (int oy = row_begin; oy < row_end; ++oy) {
+            const AxisSample row = tables.rows[oy]; // Copie locale : les écritures d'octets pourraient l'aliaser
+            for (int ox = 0; ox < out_width; ++ox, out += 3) sample_rgb(planes, row, tables.cols[ox], out);
+        }
+    } else {
+        // Parcours par colonne de sortie, qui suit une ligne source : lectures séquentielles
+        // dans les plans, écritures espacées d'une ligne dans la sortie (qui tient en cache).
+        for (int ox = 0; ox < out_width; ++ox) {
+            const AxisSample row = tables.rows[ox];
+            uint8_t* column = out_rows + static_cast<size_t>(ox) * 3;
+            for (int oy = row_begin; oy < row_end; ++oy, column += out_row_bytes) {
+                sample_rgb(planes, row, tables.cols[oy], column);
+            }
+        }
+    }
+}
+
+// Cœur commun des prétraitements RGB888 : recadrage, rotation horaire (0, 90, 180, 270),
+// redimensionnement et conversion en une passe sur la sortie. Paramètres déjà validés.
+void resample_yuv420(const Yuv420Planes& planes,
+                     int y_stride, int uv_stride, int uv_pixel_stride, int rotation,
+                     int crop_x, int crop_y, int crop_width, int crop_height,
+                     uint8_t* out_model_input, int out_width, int out_height) {
+    const ResampleTables& tables = build_resample_tables(y_stride, uv_stride, uv_pixel_stride, rotation,
+                                                         crop_x, crop_y, crop_width, crop_height,
+                                                         out_width, out_height);
+    resample_rows(planes, tables, 0, out_height, out_model_input, out_width);
+}
+
+// Zone de recadrage : image entière par défaut, sinon bornée à l'image.
+// Retourne false si la zone est hors image.
+bool clamp_crop(int width, int height, int& crop_x, int& crop_y, int& crop_width, int& crop_height) {
+    if (crop_width <= 0 || crop_height <= 0) {
+        crop_x = 0; crop_y = 0; crop_width = width; crop_height = height;
+    }
+    if (crop_x < 0) crop_x = 0;
+    if (crop_y < 0) crop_y = 0;
+    if (crop_x + crop_width > width) crop_width = width - crop_x;
+    if (crop_y + crop_height > height) crop_height = height - crop_y;
+    return crop_width > 0 && crop_height > 0;
+}
+
+} // namespace
+
+// Une seule passe sur la sortie : chaque pixel du modèle lit 4 échantillons Y
+// (bilinéaire) et 1 échantillon UV (le plus proche), puis convertit en RGB.
+extern "C" void preprocess_yuv420sp_to_model_input(const uint8_t* y_plane,
+                                                   const uint8_t* uv_plane,
+                                                   int width, int height,
+                                                   int y_stride, int uv_stride,
+                                                   int crop_x, int crop_y,
+                                                   int crop_width, int crop_height,
+                                                   uint8_t* out_model_input,
+                                                   int out_width, int out_height) {
+    if (y_plane == nullptr || uv_plane == nullptr || out_model_input == nullptr ||
+        width <= 0 || height <= 0 || out_width <= 0 || out_height <= 0) {
+        LOGE("preprocess_yuv420sp_to_model_input : paramètres invalides (%dx%d -> %dx%d)",
+             width, height, out_width, out_height);
+        return;
+    }
+    if (!clamp_crop(width, height, crop_x, crop_y, crop_width, crop_height)) {
+        LOGE("preprocess_yuv420sp_to_model_input : zone de recadrage hors image");
+        return;
+    }
+
+    // NV12 : U puis V dans le plan entrelacé.
+    const Yuv420Planes planes{y_plane, uv_plane, uv_plane + 1};
+    resample_yuv420(planes, y_stride, uv_stride, 2, 0,
+                    crop_x, crop_y, crop_width, crop_height,
+                    out_model_input, out_width, out_height);
+}
+
+extern "C" int yuv420_layout(const uint8_t* u_plane, const uint8_t* v_plane, int uv_pixel_stride) {
+    if (u_plane == nullptr || v_plane == nullptr || uv_pixel_stride < 1) return -1;
+    if (uv_pixel_stride == 1) return YUV_LAYOUT_I420;
+    if (uv_pixel_stride == 2 && v_plane == u_plane + 1) return YUV_LAYOUT_NV12;
+    if (uv_pixel_stride == 2 && u_plane == v_plane + 1) return YUV_LAYOUT_NV21;
+    return YUV_LAYOUT_STRIDED;
+}
+
+namespace {
+
+// Lignes produites puis converties ensemble par preprocess_yuv420_to_tensor : la bande
+// RGB888 (16 * 256 * 3 octets pour le modèle) reste en cache L1 jusqu'à sa conversion.
+constexpr int kTensorBandRows = 16;
+
+// Validation commune des prétraitements à trois plans ; ramène la rotation dans
+// [0, 360[ et borne la zone de recadrage. Retourne false (avec un log) si invalide.
+bool check_yuv420_args(const char* caller, const uint8_t* y_plane,
+                       const uint8_t* u_plane, const uint8_t* v_plane,
+                       int width, int height, int uv_pixel_stride, int& rotation,
+                       int& crop_x, int& crop_y, int& crop_width, int& crop_height,
+                       const void* out, int out_width, int out_height) {
+    if (y_plane == nullptr || out == nullptr || yuv420_layout(u_plane, v_plane, uv_pixel_stride) < 0 ||
+        width <= 0 || height <= 0 || out_width <= 0 || out_height <= 0) {
+        LOGE("%s : paramètres invalides (%dx%d -> %dx%d, pas chroma %d)",
+             caller, width, height, out_width, out_height, uv_pixel_stride);
+        return false;
+    }
+    rotation %= 360;
+    if (rotation < 0) rotation += 360;
+    if (rotation % 90 != 0) {
+        LOGE("%s : rotation %d non multiple de 90", caller, rotation);
+        return false;
+    }
+    if (!clamp_crop(width, height, crop_x, crop_y, crop_width, crop_height)) {
+        LOGE("%s : zone de recadrage hors image", caller);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Même passe que preprocess_yuv420sp_to_model_input : U et V sont lus au même décalage
+// dans leurs plans respectifs, si bien que NV12, NV21, I420 et les plans copiés à part
+// ne diffèrent que par les pointeurs et le pas de pixel.
+extern "C" int preprocess_yuv420_to_model_input(const uint8_t* y_plane,
+                                                const uint8_t* u_plane,
+                                                const uint8_t* v_plane,
+                                                int width, int height,
+                                                int y_stride, int uv_stride, int uv_pixel_stride,
+                                                int rotation,
+                                                int crop_x, int crop_y,
+                                                int crop_width, int crop_height,
+                                                uint8_t* out_model_input,
+                                                int out_width, int out_height) {
+    if (!check_yuv420_args("preprocess_yuv420_to_model_input", y_plane, u_plane, v_plane,
+                           width, height, uv_pixel_stride, rotation,
+                           crop_x, crop_y, crop_width, crop_height,
+                           out_model_input, out_width, out_height)) {
+        return 0;
+    }
+
+    const Yuv420Planes planes{y_plane, u_plane, v_plane};
+    resample_yuv420(planes, y_stride, uv_stride, uv_pixel_stride, rotation,
+                    crop_x, crop_y, crop_width, crop_height,
+                    out_model_input, out_width, out_height);
+    return 1;
+}
+
+// Par bandes de kTensorBandRows lignes : rééchantillonnage RGB888 dans un tampon de bande,
+// puis conversion vers le tenseur. En uint8 NHWC, écriture directe (aucune bande).
+extern "C" int preprocess_yuv420_to_tensor(const uint8_t* y_plane,
+                                           const uint8_t* u_plane,
+                                           const uint8_t* v_plane,
+                                           int width, int height,
+                                           int y_stride, int uv_stride, int uv_pixel_stride,
+                                           int rotation,
+                                           int crop_x, int crop_y,
+                                           int crop_width, int crop_height,
+                                           const InputTensorFormat* format,
+                                           void* out_tensor,
+                                           int out_width, int out_height) {
+    if (format == nullptr || !input_format_valid(*format)) {
+        LOGE("preprocess_yuv420_to_tensor : format de tenseur invalide");
+        return 0;
+    }
+    if (!check_yuv420_args("preprocess_yuv420_to_tensor", y_plane, u_plane, v_plane,
+                           width, height, uv_pixel_stride, rotation,
+                           crop_x, crop_y, crop_width, crop_height,
+                           out_tensor, out_width, out_height)) {
+        return 0;
+    }
+
+    const Yuv420Planes planes{y_plane, u_plane, v_plane};
+    const ResampleTables& tables = build_resample_tables(y_stride, uv_stride, uv_pixel_stride, rotation,
+                                                         crop_x, crop_y, crop_width, crop_height,
+                                                         out_width, out_height);
+    if (input_format_is_rgb(*format)) {
+        resample_rows(planes, tables, 0, out_height, static_cast<uint8_t*>(out_tensor), out_width);
+        return 1;
+    }
+
+    static thread_local std::vector<uint8_t> band;
+    band.resize(static_cast<size_t>(out_width) * 3 * kTensorBandRows);
+    for (int row = 0; row < out_height; row += kTensorBandRows) {
+        const int row_end = row + kTensorBandRows < out_height ? row + kTensorBandRows : out_height;
+        resample_rows(planes, tables, row, row_end, band.data(), out_width);
+        convert_rgb_rows(band.data(), out_width, out_height, row, row_end - row, *format, out_tensor);
+    }
+    return 1;
+}
 
 
 // NOTE: L'implémentation de detect_walls_ransac se trouve dans ransac.cpp
-// (version minimale qui retourne 0 pour l'instant)
\ No newline at end of file
+// (version minimale qui retourne 0 pour l'instant)
+
+
+// --- Repli portable de convert_yuv420sp_to_rgb (build Linux sans libyuv) ---
+#if !NATIVE_HAS_LIBYUV
+// Virgule fixe BT.601 plage limitée de yuv_to_rgb (pas les constantes de libyuv : peut
+// différer d'une unité de NV12ToRAW), sortie R, G, B ; chroma au plus proche.
+// Sert aux benchmarks desktop : plus lent que libyuv, ne pas comparer les deux chiffres.
+extern "C" void convert_yuv420sp_to_rgb(const uint8_t* y_plane,
+                                        const uint8_t* uv_plane,
+                                        int width, int height,
+                                        int y_stride, int uv_stride,
+                                        uint8_t* out_rgb_buffer) {
+    if (y_plane == nullptr || uv_plane == nullptr || out_rgb_buffer == nullptr ||
+        width <= 0 || height <= 0) {
+        LOGE("convert_yuv420sp_to_rgb : paramètres invalides (%dx%d)", width, height);
+        return;
+    }
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* y_row = y_plane + static_cast<size_t>(y) * y_stride;
+        const uint8_t* uv_row = uv_plane + static_cast<size_t>(y >> 1) * uv_stride;
+        uint8_t* out = out_rgb_buffer + static_cast<size_t>(y) * width * 3;
+        for (int x = 0; x < width; ++x) {
+            const uint8_t* uv = uv_row + (x & ~1);
+            yuv_to_rgb(y_row[x], uv[0], uv[1], out + x * 3);
+        }
+    }
+}
+#endif // !NATIVE_HAS_LIBYUV
@@ -9,10 +9,263 @@
 typedef struct {
     float a, b, c, d;
     int32_t inlier_count;
+    // Centroïde des inliers et écart quadratique moyen des inliers au plan
+    // (renseignés par le raffinement moindres carrés, 0 sinon ; rms en unités de
+    // profondeur inverse avec RANSAC_ENGINE_INVERSE_DEPTH).
+    float centroid_x, centroid_y, centroid_z;
+    float rms;
+    // Fraction des points du nuage (ROI échantillonnée) inliers du plan : indépendante
+    // du pas, sert à juger si le plan tient encore à la trame suivante (warm_start).
+    float inlier_ratio;
 } RansacPlaneResult;
 
+// Paramètres de RANSAC (remplis par ransac_default_options puis ajustés par l'appelant).
+typedef struct {
+    // Paramètres intrinsèques caméra (pixels) pour la déprojection 2D -> 3D.
+    float fx, fy, cx, cy;
+    // Distance max point-plan pour être inlier (unités du nuage 3D).
+    float distance_threshold;
+    // Nombre min d'inliers pour accepter un plan.
+    int32_t min_inliers;
+    // Sans itérations adaptatives : nombre d'hypothèses par plan.
+    // Dans tous les cas : fixe le budget total d'évaluations (max_iterations * N points).
+    int32_t max_iterations;
+    // 1 : score par blocs de chunk_size points et abandon d'une hypothèse dès
+    // qu'elle ne peut plus battre la meilleure (résultat identique, moins d'évaluations).
+    int32_t early_termination;
+    int32_t chunk_size;
+    // 1 : nombre d'itérations recalculé d'après le taux d'inliers observé
+    // (arrêt dès que la probabilité `confidence` d'avoir tiré un triplet pur est atteinte).
+    int32_t adaptive_iterations;
+    float confidence;
+    // Sous-échantillonnage de la déprojection : un pixel sur pixel_stride dans chaque
+    // direction, limité au rectangle ROI (roi_w/roi_h <= 0 : jusqu'au bord de la carte).
+    // Si max_points > 0, le pas est augmenté jusqu'à ce que le nuage tienne dans max_points.
+    // min_inliers reste exprimé en pixels pleine résolution (divisé par pas^2 en interne).
+    int32_t pixel_stride;
+    int32_t roi_x, roi_y, roi_w, roi_h;
+    int32_t max_points;
+    // 1 : après l'ajustement sur le sous-ensemble, recompte les inliers de chaque plan
+    // sur tous les pixels de la ROI (inlier_count pleine résolution).
+    // 0 : inlier_count compte les points échantillonnés.
+    int32_t refine_full_resolution;
+    // 1 : le plan retenu est réajusté par moindres carrés sur ses inliers
+    // (normale = vecteur propre de la plus petite valeur propre de leur covariance).
+    int32_t refine_least_squares;
+    // Graine des tirages. 0 : nouvelle graine à chaque appel (renvoyée dans
+    // RansacStats.seed). Sinon, mode rejeu : même carte + même graine + mêmes options
+    // donnent les mêmes plans, sur toutes les plateformes et quel que soit le noyau.
+    uint32_t seed;
+    // 1 : les plans de l'appel précédent (contexte de pipeline, ou prior_planes de
+    // detect_walls_ransac_warm) sont essayés avant tout tirage. Un plan précédent est
+    // repris, puis réajusté, si son taux d'inliers atteint warm_start_retention fois
+    // celui de la trame précédente ; sinon il sert de score à battre aux tirages.
+    int32_t warm_start;
+    float warm_start_retention;
+    // Espace de l'ajustement (RANSAC_ENGINE_*). En profondeur inverse, un plan 3D est
+    // une fonction affine de l'image (1/Z = alpha*u + beta*v + gamma) : les hypothèses
+    // sont ajustées et scorées directement sur (u, v, profondeur inverse), sans
+    // déprojection ni division, et un pixel est inlier si
+    // |alpha*u + beta*v + gamma - 1/Z| < inverse_depth_threshold (unités de la carte).
+    // Les plans rendus sont dans tous les cas métriques (a, b, c, d du repère caméra).
+    int32_t engine;
+    float inverse_depth_threshold;
+    // Mode grossier -> fin (0 : désactivé). Les hypothèses sont tirées et scorées sur le
+    // niveau coarse_level de la pyramide de profondeur (moyennes 2x2, taille >> niveau,
+    // intrinsèques mises à l'échelle), puis chaque plan retenu est vérifié (inliers
+    // recomptés, min_inliers appliqué) et réajusté sur le nuage pleine résolution.
+    // 1 .. DEPTH_PYRAMID_LEVELS - 1.
+    int32_t coarse_level;
+} RansacOptions;
+
+// Espaces d'ajustement de RANSAC (RansacOptions.engine).
+#define RANSAC_ENGINE_METRIC        0 // Nuage de points 3D déprojeté, distance point-plan
+#define RANSAC_ENGINE_INVERSE_DEPTH 1 // (u, v, profondeur inverse), écart de profondeur inverse
+
+// Coût effectif d'un appel RANSAC.
+typedef struct {
+    int64_t point_evaluations; // Évaluations point-plan réellement effectuées
+    int32_t iterations;        // Hypothèses tirées (tous plans confondus)
+    int32_t early_exits;       // Hypothèses abandonnées avant la fin du score
+    uint32_t seed;             // Graine utilisée (à recopier dans RansacOptions.seed pour rejouer l'appel)
+    int32_t warm_starts;       // Plans repris de l'appel précédent (sans tirage)
+} RansacStats;
+
+// Format de la carte de profondeur en entrée de l'analyse (statistiques, RANSAC).
+#define DEPTH_FORMAT_F32 0 // float : profondeur inverse
+#define DEPTH_FORMAT_U8  1 // uint8 quantifié (sortie du modèle) : valeur = scale * (q - zero_point)
+#define DEPTH_FORMAT_S8  2 // int8 quantifié, même formule
+
+// Type et disposition du tenseur d'entrée du modèle (InputTensorFormat).
+#define INPUT_TENSOR_U8   0 // uint8 RGB brut (modèle quantifié) : mean / std ignorés
+#define INPUT_TENSOR_F32  1 // float32 : (valeur - mean[c]) / std[c]
+#define INPUT_TENSOR_F16  2 // float16 (IEEE binary16), même formule
+#define INPUT_TENSOR_NHWC 0 // R, G, B entrelacés par pixel
+#define INPUT_TENSOR_NCHW 1 // Plan R, puis plan G, puis plan B
+
+// Format du tenseur d'entrée écrit par le prétraitement.
+typedef struct {
+    int32_t type;    // INPUT_TENSOR_U8 / F32 / F16
+    int32_t layout;  // INPUT_TENSOR_NHWC / NCHW
+    float mean[3];   // Moyenne par canal R, G, B (unités 0..255)
+    float std[3];    // Écart-type par canal (unités 0..255, > 0)
+} InputTensorFormat;
+
+// Nombre de classes de l'histogramme de DepthStats.
+#define DEPTH_STATS_HISTOGRAM_BINS 32
+
+// Statistiques de la carte de profondeur inverse (plus haut = plus proche),
+// calculées en une passe par compute_depth_stats.
+typedef struct {
+    // Valeur max de la carte (0 si aucune valeur positive).
+    float max_closeness;
+    // Pixels de la moitié basse plus lointains que le seuil de chemin libre,
+    // par tiers de largeur (gauche / centre / droite).
+    int32_t free_left, free_center, free_right;
+    // Pixels de la moitié basse examinés.
+    int32_t total_considered;
+    // Histogramme des valeurs sur [0, histogram_max) ; les valeurs hors
+    // intervalle vont dans la première / dernière classe.
+    int32_t histogram[DEPTH_STATS_HISTOGRAM_BINS];
+} DepthStats;
+
+// Niveaux de la pyramide de profondeur, pleine résolution comprise (256 -> 128, 64, 32).
+#define DEPTH_PYRAMID_LEVELS 4
+
+// Nombre de secteurs de cap de PolarObstacleMap (32 : un masque de bits les couvre tous).
+#define POLAR_OBSTACLE_BINS 32
+
+// Paramètres de la carte polaire d'obstacles (remplis par polar_obstacle_default_options).
+// Distances et hauteurs dans les unités de la carte : Z = 1 / profondeur inverse.
+typedef struct {
+    // Paramètres intrinsèques caméra (pixels), les mêmes que RansacOptions.
+    float fx, fy, cx, cy;
+    // Un pixel est un obstacle s'il est plus proche que obstacle_range ...
+    float obstacle_range;
+    // ... et si sa hauteur Y (repère caméra, vers le haut) est dans [min_height, max_height] :
+    // exclut le sol et le plafond. min_height >= max_height : pas de filtre de hauteur.
+    float min_height, max_height;
+    // Pixels obstacles à partir desquels un secteur est bloqué (filtre le bruit).
+    int32_t min_obstacle_pixels;
+    // Largeur angulaire minimale d'un passage praticable (radians).
+    float min_gap_width;
+} PolarObstacleOptions;
+
+// Carte polaire d'obstacles devant l'utilisateur : le champ horizontal de la caméra
+// est découpé en POLAR_OBSTACLE_BINS secteurs de cap égaux (radians, 0 = tout droit,
+// positif = vers la droite).
+typedef struct {
+    // Caps des bords gauche et droit du champ.
+    float heading_min, heading_max;
+    // Distance de l'obstacle le plus proche par secteur (0 : aucun obstacle à portée).
+    float nearest[POLAR_OBSTACLE_BINS];
+    // Pixels obstacles par secteur.
+    int32_t obstacle_pixels[POLAR_OBSTACLE_BINS];
+    // Bit b à 1 : secteur b bloqué (au moins min_obstacle_pixels pixels obstacles).
+    uint32_t blocked_mask;
+    // Plus large passage : secteurs libres consécutifs [gap_start, gap_end], le plus
+    // proche de l'axe à largeur égale (-1, -1 si aucun passage d'au moins min_gap_width).
+    int32_t gap_start, gap_end;
+    // Cap du centre du passage et sa largeur angulaire (0 si aucun passage).
+    float gap_heading, gap_width;
+} PolarObstacleMap;
+
+// Capacité du tableau de composantes du contexte (pipeline_obstacle_blobs).
+#define OBSTACLE_BLOBS_MAX 16
+
+// Composante connexe (connexité 8) de pixels plus proches que le seuil.
+typedef struct {
+    // Boîte englobante, bornes incluses (pixels de la carte).
+    int32_t x_min, y_min, x_max, y_max;
+    // Nombre de pixels.
+    int32_t area;
+    // Centre de gravité des pixels.
+    float centroid_x, centroid_y;
+    // Profondeur inverse maximale (le point le plus proche).
+    float peak_closeness;
+} ObstacleBlob;
+
+// Capacité des tableaux de rectangles du contexte (pipeline_depth_regions).
+#define DEPTH_REGIONS_MAX 64
+
+// Rectangle de la carte de profondeur : [x0, x1[ x [y0, y1[ (pixels, ramené à la carte).
+typedef struct {
+    int32_t x0, y0, x1, y1;
+} DepthRegion;
+
+// Statistiques d'un rectangle (pixels valides seulement : NaN et infinis ignorés).
+typedef struct {
+    float mean;            // Profondeur inverse moyenne (0 si aucun pixel valide)
+    float fraction_above;  // Part des pixels au-dessus du seuil des tables (0..1)
+    int32_t valid_count;   // Pixels valides dans le rectangle
+} RegionStats;
+
+// Disposition des plans chroma d'une trame YUV 4:2:0 (yuv420_layout).
+#define YUV_LAYOUT_I420    0 // Plans U et V séparés, un octet par échantillon
+#define YUV_LAYOUT_NV12    1 // Plan entrelacé U, V, U, V... (V = U + 1, pas de pixel 2)
+#define YUV_LAYOUT_NV21    2 // Plan entrelacé V, U, V, U... (U = V + 1, pas de pixel 2)
+#define YUV_LAYOUT_STRIDED 3 // Plans U et V séparés, pas de pixel > 1 (plans copiés à part)
+
+// Métadonnées d'une trame caméra déposée dans la boîte aux lettres du contexte.
+typedef struct {
+    int32_t width, height;        // Dimensions de l'image (capteur, avant rotation)
+    int32_t y_stride, uv_stride;  // Octets par ligne des plans Y et UV (ou U et V)
+    int64_t timestamp_us;         // Horodatage fourni au dépôt
+    int64_t sequence;             // Numéro de dépôt (à partir de 1 ; 0 : aucune trame)
+    int32_t uv_pixel_stride;      // Octets entre deux échantillons chroma d'une ligne
+    int32_t rotation;             // Rotation horaire appliquée au prétraitement (degrés)
+    int32_t layout;               // Disposition des plans chroma (YUV_LAYOUT_*)
+} FrameInfo;
+
+// Compteurs de la boîte aux lettres depuis la création du contexte.
+typedef struct {
+    int64_t published;   // Trames déposées
+    int64_t taken;       // Trames prises par le traitement
+    int64_t overwritten; // Trames remplacées par une plus récente avant d'être prises
+} MailboxStats;
+
+// Codes de retour du traitement de trame complet (pipeline_load_model, pipeline_process_frame).
+#define PIPELINE_STATUS_OK                  0
+#define PIPELINE_STATUS_INVALID_ARGUMENT   -1 // Contexte nul, plans ou dimensions invalides
+#define PIPELINE_STATUS_NO_TFLITE          -2 // Bibliothèque compilée sans TFLite (NATIVE_WITH_TFLITE=OFF)
+#define PIPELINE_STATUS_MODEL_ERROR        -3 // Modèle illisible ou interpréteur non créé
+#define PIPELINE_STATUS_MODEL_MISMATCH     -4 // Tenseurs du modèle incompatibles avec le contexte
+#define PIPELINE_STATUS_NO_MODEL           -5 // Aucun modèle chargé
+#define PIPELINE_STATUS_NO_FRAME           -6 // Aucune trame prise (pipeline_process_latest)
+#define PIPELINE_STATUS_PREPROCESS_FAILED  -7 // Prétraitement refusé (plans trop petits...)
+#define PIPELINE_STATUS_INFERENCE_FAILED   -8 // Échec de l'interpréteur
+
+// Seuils de l'analyse enchaînée par pipeline_process_frame. Les options RANSAC, de la
+// carte polaire et du filtre temporel restent celles du contexte.
+typedef struct {
+    float free_path_threshold;  // Statistiques : seuil de chemin libre ...
+    float histogram_max;        // ... et borne haute de l'histogramme
+    float obstacle_threshold;   // Composantes d'obstacles : seuil de proximité ...
+    int32_t obstacle_min_area;  // ... et aire minimale (pixels)
+    int32_t detect_walls;       // 0 : RANSAC sauté (plane_count = 0)
+} FrameProcessOptions;
+
+// Résultat compact d'une trame traitée de bout en bout. Le détail reste dans les
+// tampons du contexte (pipeline_planes_buffer, pipeline_obstacle_blobs, ...).
+typedef struct {
+    int32_t status;               // PIPELINE_STATUS_* (les champs suivants ne valent que si OK)
+    int32_t obstacle_count;       // Composantes d'obstacles (pipeline_obstacle_blobs)
+    int32_t plane_count;          // Plans RANSAC (pipeline_planes_buffer)
+    int32_t gap_start, gap_end;   // Plus large passage de la carte polaire (-1 si aucun)
+    float max_closeness;          // Profondeur inverse maximale (DepthStats)
+    float gap_heading, gap_width; // Cap et largeur du passage (radians)
+    int64_t timestamp_us;         // Horodatage de la trame (0 pour pipeline_process_frame)
+    // Durées des étapes (µs) : prétraitement, inférence, analyse (filtre, statistiques,
+    // composantes, carte polaire), RANSAC.
+    int32_t preprocess_us, inference_us, analysis_us, ransac_us;
+} FrameResult;
+
+// Mémoire résidente du processus (/proc/self/status), en kio.
+typedef struct {
+    int64_t rss_kb;       // VmRSS : actuelle
+    int64_t peak_rss_kb;  // VmHWM : pic depuis le lancement
+} ProcessMemory;
 
-// Définit une macro JNI_EXPORT.
 // Si le compilateur est GCC ou Clang (qui définissent __GNUC__),
 // la macro sera remplacée par les attributs de visibilité nécessaires pour FFI.
 // Sinon (par exemple, pour l'IntelliSense VS Code s'il utilise un mode MSVC),
@@ -42,11 +295,123 @@ void convert_yuv420sp_to_rgb(const uint8_t* y_plane,
                              uint8_t* out_rgb_buffer);
 
 
+// --- Déclaration du prétraitement fusionné YUV -> entrée du modèle ---
+/**
+ * @brief Produit directement l'entrée RGB888 du modèle (HWC) depuis les plans NV12,
+ *        en une seule passe : recadrage + redimensionnement bilinéaire + conversion couleur.
+ *        Aucun tampon RGB pleine résolution n'est créé.
+ * @param y_plane, uv_plane Plans Y et UV entrelacé (U, V, U, V...) de la caméra.
+ * @param width, height Dimensions de l'image caméra.
+ * @param y_stride, uv_stride Octets par ligne des plans Y et UV.
+ * @param crop_x, crop_y, crop_width, crop_height Zone source à utiliser
+ *        (crop_width <= 0 ou crop_height <= 0 : image entière).
+ * @param out_model_input Tampon de sortie (out_width * out_height * 3 octets).
+ * @param out_width, out_height Dimensions de l'entrée du modèle (ex: 256x256).
+ */
+JNI_EXPORT
+void preprocess_yuv420sp_to_model_input(const uint8_t* y_plane,
+                                        const uint8_t* uv_plane,
+                                        int width, int height,
+                                        int y_stride, int uv_stride,
+                                        int crop_x, int crop_y,
+                                        int crop_width, int crop_height,
+                                        uint8_t* out_model_input,
+                                        int out_width, int out_height);
+
+/**
+ * @brief Disposition des plans chroma d'une trame YUV_420_888, d'après leurs adresses
+ *        et le pas de pixel : I420 (pas 1), NV12 / NV21 (plans U et V entrelacés dans
+ *        la même mémoire), sinon plans U et V distincts à pas > 1.
+ * @return YUV_LAYOUT_*, ou -1 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int yuv420_layout(const uint8_t* u_plane, const uint8_t* v_plane, int uv_pixel_stride);
+
+/**
+ * @brief preprocess_yuv420sp_to_model_input pour une trame YUV_420_888 à trois plans
+ *        (NV12, NV21, I420 ou plans copiés à part), avec rotation : recadrage, rotation,
+ *        redimensionnement bilinéaire et conversion couleur en une seule passe, sans
+ *        entrelacer ni copier les plans chroma.
+ * @param y_plane, u_plane, v_plane Plans de la caméra (U et V peuvent se chevaucher).
+ * @param width, height Dimensions de l'image capteur.
+ * @param y_stride Octets par ligne du plan Y.
+ * @param uv_stride, uv_pixel_stride Octets par ligne et entre deux échantillons des plans U et V.
+ * @param rotation Rotation horaire à appliquer (0, 90, 180 ou 270 : sensorOrientation).
+ * @param crop_x, crop_y, crop_width, crop_height Zone source, en pixels capteur
+ *        (crop_width <= 0 ou crop_height <= 0 : image entière).
+ * @param out_model_input Tampon de sortie RGB888 HWC (out_width * out_height * 3 octets).
+ * @param out_width, out_height Dimensions de l'entrée du modèle (image tournée).
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int preprocess_yuv420_to_model_input(const uint8_t* y_plane,
+                                     const uint8_t* u_plane,
+                                     const uint8_t* v_plane,
+                                     int width, int height,
+                                     int y_stride, int uv_stride, int uv_pixel_stride,
+                                     int rotation,
+                                     int crop_x, int crop_y,
+                                     int crop_width, int crop_height,
+                                     uint8_t* out_model_input,
+                                     int out_width, int out_height);
+
+
+// --- Tenseur d'entrée float / fp16 ---
+/**
+ * @brief Taille en octets d'un tenseur d'entrée width x height x 3 au format donné.
+ * @return La taille, ou 0 si le format est invalide.
+ */
+JNI_EXPORT
+int64_t input_tensor_bytes(const InputTensorFormat* format, int width, int height);
+
+/**
+ * @brief Convertit une image RGB888 HWC (entrée uint8 du modèle) vers un tenseur au format
+ *        donné : uint8 / float32 / float16, NHWC ou NCHW, normalisé par canal.
+ * @param out_tensor Tampon de l'appelant (input_tensor_bytes octets).
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int convert_rgb_to_input_tensor(const uint8_t* rgb, int width, int height,
+                                const InputTensorFormat* format, void* out_tensor);
+
+/**
+ * @brief preprocess_yuv420_to_model_input, sortie écrite directement au format du tenseur
+ *        (par bandes de lignes converties dès qu'elles sont produites, sans image RGB
+ *        intermédiaire complète).
+ * @param format Type, disposition et normalisation du tenseur.
+ * @param out_tensor Tampon de l'appelant (input_tensor_bytes(format, out_width, out_height) octets).
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int preprocess_yuv420_to_tensor(const uint8_t* y_plane,
+                                const uint8_t* u_plane,
+                                const uint8_t* v_plane,
+                                int width, int height,
+                                int y_stride, int uv_stride, int uv_pixel_stride,
+                                int rotation,
+                                int crop_x, int crop_y,
+                                int crop_width, int crop_height,
+                                const InputTensorFormat* format,
+                                void* out_tensor,
+                                int out_width, int out_height);
+
+
 // --- Déclaration de la fonction de détection de murs RANSAC ---
 /**
  * @brief Détecte des plans (murs potentiels) dans une carte de profondeur via RANSAC.
+ *        RANSAC séquentiel : jusqu'à max_planes plans, les inliers de chaque plan
+ *        sont retirés avant la recherche suivante. Le budget total d'évaluations
+ *        reste celui d'une recherche mono-plan (max_iterations sur tout le nuage).
+ *        Changements pour les appelants existants :
+ *        - tirage localisé : le 1er point est uniforme, les 2e et 3e sont pris dans une
+ *          fenêtre de ±1/16 du nuage autour de lui (pixels voisins), et non plus
+ *          uniformément. Les triplets sur une même surface sont bien plus fréquents ;
+ *          les plans trouvés diffèrent de ceux des versions précédentes, y compris avec
+ *          max_planes == 1 (seul le nombre d'itérations est alors inchangé) ;
+ *        - avec max_planes > 1, le budget est partagé entre les plans : le premier plan
+ *          dispose de moins d'itérations qu'une recherche mono-plan.
  * ... (params) ...
- * @return Le nombre de plans détectés.
+ * @return Le nombre de plans détectés (par ordre de découverte).
  */
 // Applique la macro AVANT le type de retour.
 JNI_EXPORT
@@ -60,6 +425,538 @@ int detect_walls_ransac(const float* depth_map_data,
                         int max_planes);
 
 
+// --- RANSAC paramétrable ---
+/**
+ * @brief Remplit `out_options` avec les valeurs par défaut (terminaison anticipée et
+ *        itérations adaptatives activées, confiance 0.99, blocs de 1024 points,
+ *        graine automatique, reprise des plans précédents avec rétention 0.8).
+ */
+JNI_EXPORT
+void ransac_default_options(RansacOptions* out_options);
+
+/**
+ * @brief Variante de detect_walls_ransac pilotée par RansacOptions.
+ * @param out_stats Coût effectif de l'appel (peut être NULL).
+ * @return Le nombre de plans détectés.
+ */
+JNI_EXPORT
+int detect_walls_ransac_ex(const float* depth_map_data,
+                           int width, int height,
+                           const RansacOptions* options,
+                           RansacPlaneResult* out_planes_buffer,
+                           int max_planes,
+                           RansacStats* out_stats);
+
+/**
+ * @brief Variante de detect_walls_ransac_ex avec reprise temporelle : les plans de la
+ *        trame précédente sont essayés avant tout tirage (si options->warm_start vaut 1).
+ *        Dans un couloir parcouru à vitesse régulière, chaque plan coûte alors deux
+ *        passes sur le nuage (vérification, retrait des inliers) au lieu des tirages.
+ * @param prior_planes Plans retournés par l'appel précédent (peut être NULL).
+ * @param prior_count Nombre de plans dans prior_planes.
+ * @param out_planes_buffer Ne doit pas recouvrir prior_planes.
+ * @return Le nombre de plans détectés.
+ */
+JNI_EXPORT
+int detect_walls_ransac_warm(const float* depth_map_data,
+                             int width, int height,
+                             const RansacOptions* options,
+                             const RansacPlaneResult* prior_planes,
+                             int prior_count,
+                             RansacPlaneResult* out_planes_buffer,
+                             int max_planes,
+                             RansacStats* out_stats);
+
+/**
+ * @brief Variante de detect_walls_ransac_ex sur la sortie 8 bits quantifiée du modèle,
+ *        déquantifiée à la volée (aucune carte float intermédiaire).
+ * @param depth_q8 Carte quantifiée, width * height octets.
+ * @param format DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8.
+ * @param scale, zero_point Paramètres de quantification du tenseur de sortie.
+ * @return Le nombre de plans détectés.
+ */
+JNI_EXPORT
+int detect_walls_ransac_q8(const uint8_t* depth_q8,
+                           int width, int height,
+                           int format, float scale, int zero_point,
+                           const RansacOptions* options,
+                           RansacPlaneResult* out_planes_buffer,
+                           int max_planes,
+                           RansacStats* out_stats);
+
+
+// --- Statistiques de la carte de profondeur ---
+/**
+ * @brief Max, comptes de chemin libre par secteur et histogramme, en une seule passe
+ *        vectorisable sur la carte aplatie (remplace les boucles Dart de DepthAnalyzer).
+ * @param depth_map_data Carte de profondeur inverse, width * height floats.
+ * @param free_path_threshold Une valeur < seuil est considérée comme libre (lointaine).
+ * @param histogram_max Borne haute de l'histogramme (> 0).
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int compute_depth_stats(const float* depth_map_data,
+                        int width, int height,
+                        float free_path_threshold,
+                        float histogram_max,
+                        DepthStats* out_stats);
+
+/**
+ * @brief compute_depth_stats sur la sortie 8 bits quantifiée du modèle. Une passe de
+ *        comptage des octets par secteur ; max, comptes libres et histogramme en sont
+ *        déduits via les 256 valeurs déquantifiées (résultat identique au chemin float).
+ * @param format DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8.
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int compute_depth_stats_q8(const uint8_t* depth_q8,
+                           int width, int height,
+                           int format, float scale, int zero_point,
+                           float free_path_threshold,
+                           float histogram_max,
+                           DepthStats* out_stats);
+
+
+// --- Pyramide de profondeur ---
+/**
+ * @brief Réduit la carte d'un facteur 2 : out[y][x] = moyenne du bloc 2x2
+ *        (2y .. 2y+1, 2x .. 2x+1). Une ligne ou colonne impaire finale est ignorée.
+ * @param out_depth Tampon de sortie, (width / 2) * (height / 2) floats.
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int downsample_depth_2x2(const float* depth_map_data, int width, int height,
+                         float* out_depth);
+
+
+// --- Carte polaire d'obstacles ---
+
+/** @brief Remplit les paramètres par défaut (intrinsèques à 0 : à renseigner). */
+JNI_EXPORT
+void polar_obstacle_default_options(PolarObstacleOptions* out_options);
+
+/**
+ * @brief Projette la carte de profondeur inverse dans une carte polaire d'obstacles
+ *        (cap de chaque colonne d'après les intrinsèques, distance Z = 1 / profondeur
+ *        inverse) et choisit le plus large passage praticable. Une seule passe
+ *        vectorisée sur la carte, sans division par pixel ; sortie de taille fixe.
+ * @param depth_map_data Carte de profondeur inverse, width * height floats.
+ * @param width Au moins POLAR_OBSTACLE_BINS colonnes.
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int compute_polar_obstacles(const float* depth_map_data,
+                            int width, int height,
+                            const PolarObstacleOptions* options,
+                            PolarObstacleMap* out_map);
+
+/**
+ * @brief compute_polar_obstacles sur la sortie 8 bits quantifiée du modèle.
+ * @param format DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8.
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int compute_polar_obstacles_q8(const uint8_t* depth_q8,
+                               int width, int height,
+                               int format, float scale, int zero_point,
+                               const PolarObstacleOptions* options,
+                               PolarObstacleMap* out_map);
+
+
+// --- Segmentation des obstacles (composantes connexes) ---
+/**
+ * @brief Segmente la carte seuillée (profondeur inverse > closeness_threshold) en
+ *        composantes connexes (connexité 8) : suites horizontales par ligne, fusionnées
+ *        avec celles de la ligne précédente par union-find.
+ * @param min_area Aire minimale (pixels) d'une composante retenue.
+ * @param out_blobs Tampon de sortie (max_blobs entrées), rempli par aire décroissante.
+ * @return Nombre de composantes écrites (0 si aucune ou si les paramètres sont invalides).
+ */
+JNI_EXPORT
+int detect_obstacle_blobs(const float* depth_map_data,
+                          int width, int height,
+                          float closeness_threshold, int min_area,
+                          ObstacleBlob* out_blobs, int max_blobs);
+
+/**
+ * @brief detect_obstacle_blobs sur la sortie 8 bits quantifiée du modèle.
+ * @param format DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8.
+ */
+JNI_EXPORT
+int detect_obstacle_blobs_q8(const uint8_t* depth_q8,
+                             int width, int height,
+                             int format, float scale, int zero_point,
+                             float closeness_threshold, int min_area,
+                             ObstacleBlob* out_blobs, int max_blobs);
+
+
+// --- Requêtes de rectangles (tables cumulées) ---
+/**
+ * @brief Construit les tables cumulées (somme, pixels valides, pixels > threshold) de la
+ *        carte en une passe, puis répond à region_count rectangles en temps constant
+ *        chacun (moyenne et part au-dessus du seuil).
+ * @param threshold Seuil de profondeur inverse de fraction_above.
+ * @param out_stats Tampon de sortie (region_count entrées).
+ * @return Nombre de rectangles traités (0 si les paramètres sont invalides).
+ */
+JNI_EXPORT
+int query_depth_regions(const float* depth_map_data,
+                        int width, int height, float threshold,
+                        const DepthRegion* regions, int region_count,
+                        RegionStats* out_stats);
+
+/**
+ * @brief query_depth_regions sur la sortie 8 bits quantifiée du modèle.
+ * @param format DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8.
+ */
+JNI_EXPORT
+int query_depth_regions_q8(const uint8_t* depth_q8,
+                           int width, int height,
+                           int format, float scale, int zero_point,
+                           float threshold,
+                           const DepthRegion* regions, int region_count,
+                           RegionStats* out_stats);
+
+
+// --- Filtre temporel de la carte de profondeur ---
+/**
+ * @brief Met à jour en place une estimation par pixel à partir d'une nouvelle carte :
+ *        s += alpha * (x - s) (moyenne exponentielle, atténue le scintillement de MiDaS),
+ *        sauf si |x - s| > jump_threshold (vrai changement : s = x, sans traîne sur un
+ *        obstacle qui apparaît). Les mesures NaN laissent l'estimation inchangée.
+ * @param state Estimation, count floats (initialisée par l'appelant, ex : première carte).
+ * @param alpha Poids de la nouvelle mesure, dans ]0, 1] (1 : pas de lissage).
+ * @param jump_threshold Écart au-delà duquel l'estimation repart de la mesure (<= 0 : jamais).
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int temporal_filter_depth(float* state,
+                          const float* depth_map_data,
+                          int count,
+                          float alpha,
+                          float jump_threshold);
+
+/**
+ * @brief temporal_filter_depth sur la sortie 8 bits quantifiée du modèle (déquantifiée
+ *        à la volée ; résultat identique au chemin float).
+ * @param format DEPTH_FORMAT_U8 ou DEPTH_FORMAT_S8.
+ * @return 1 si succès, 0 si les paramètres sont invalides.
+ */
+JNI_EXPORT
+int temporal_filter_depth_q8(float* state,
+                             const uint8_t* depth_q8,
+                             int count,
+                             int format, float scale, int zero_point,
+                             float alpha,
+                             float jump_threshold);
+
+
+// --- Contexte de pipeline persistant ---
+// Créé une fois avec les dimensions caméra et modèle, il possède des tampons alignés
+// réutilisés à chaque trame (boîte aux lettres de trames YUV, entrée du modèle, carte de profondeur,
+// résultats RANSAC, mémoire de travail). Plus aucun calloc/free par trame.
+// Type opaque côté FFI : Dart ne manipule qu'un pointeur.
+typedef struct PipelineContext PipelineContext;
+
+/**
+ * @brief Crée le contexte et pré-alloue (et pré-touche) tous ses tampons.
+ * @param camera_width, camera_height Dimensions caméra attendues (0 si inconnues : les
+ *        emplacements de trames seront dimensionnés par pipeline_mailbox_reserve).
+ * @param model_width, model_height Dimensions de l'entrée / sortie du modèle.
+ * @param max_planes Capacité du tampon de résultats RANSAC.
+ * @return Le contexte, ou NULL en cas d'échec d'allocation.
+ */
+JNI_EXPORT
+PipelineContext* pipeline_create(int camera_width, int camera_height,
+                                 int model_width, int model_height,
+                                 int max_planes);
+
+/** @brief Libère le contexte et tous ses tampons. Accepte NULL. */
+JNI_EXPORT
+void pipeline_destroy(PipelineContext* ctx);
+
+// Accès aux tampons (pointeurs stables tant que leur capacité ne change pas).
+JNI_EXPORT uint8_t* pipeline_model_input_buffer(PipelineContext* ctx);
+JNI_EXPORT float* pipeline_depth_buffer(PipelineContext* ctx);
+JNI_EXPORT uint8_t* pipeline_depth_q8_buffer(PipelineContext* ctx);
+JNI_EXPORT RansacPlaneResult* pipeline_planes_buffer(PipelineContext* ctx);
+
+// --- Boîte aux lettres de trames (la plus récente gagne) ---
+// Le rappel caméra (producteur) dépose chaque trame sans jamais attendre l'analyse ;
+// la boucle de traitement (consommateur) prend toujours la plus récente. Un seul
+// producteur et un seul consommateur, éventuellement sur deux threads différents.
+
+/**
+ * @brief Producteur : garantit la capacité des plans de l'emplacement de dépôt, puis
+ *        pipeline_mailbox_y_buffer / pipeline_mailbox_uv_buffer donnent où les copier.
+ *        Ces pointeurs changent à chaque pipeline_mailbox_publish : les relire à chaque trame.
+ * @return 1 si l'emplacement est prêt, 0 en cas d'échec d'allocation.
+ */
+JNI_EXPORT
+int pipeline_mailbox_reserve(PipelineContext* ctx, int y_bytes, int uv_bytes);
+JNI_EXPORT uint8_t* pipeline_mailbox_y_buffer(PipelineContext* ctx);
+JNI_EXPORT uint8_t* pipeline_mailbox_uv_buffer(PipelineContext* ctx);
+
+/**
+ * @brief Producteur, trame à trois plans : comme pipeline_mailbox_reserve, avec un plan V
+ *        séparé. Le plan U se copie dans pipeline_mailbox_uv_buffer, le plan V dans
+ *        pipeline_mailbox_v_buffer.
+ * @return 1 si l'emplacement est prêt, 0 en cas d'échec d'allocation.
+ */
+JNI_EXPORT
+int pipeline_mailbox_reserve_yuv420(PipelineContext* ctx, int y_bytes, int u_bytes, int v_bytes);
+JNI_EXPORT uint8_t* pipeline_mailbox_v_buffer(PipelineContext* ctx);
+
+/**
+ * @brief Producteur : publie la trame copiée dans l'emplacement de dépôt. Si la trame
+ *        publiée précédemment n'a pas été prise, elle est remplacée (comptée comme écrasée).
+ * @return 1 si succès, 0 si les dimensions ne tiennent pas dans les plans réservés.
+ */
+JNI_EXPORT
+int pipeline_mailbox_publish(PipelineContext* ctx,
+                             int width, int height,
+                             int y_stride, int uv_stride,
+                             int64_t timestamp_us);
+
+/**
+ * @brief Producteur : publie une trame à trois plans (voir pipeline_mailbox_reserve_yuv420).
+ * @param uv_stride, uv_pixel_stride Octets par ligne et entre deux échantillons des plans U et V.
+ * @param rotation Rotation horaire appliquée par pipeline_preprocess_latest (0, 90, 180, 270).
+ * @return 1 si succès, 0 si les paramètres sont invalides ou si les plans ne tiennent pas.
+ */
+JNI_EXPORT
+int pipeline_mailbox_publish_yuv420(PipelineContext* ctx,
+                                    int width, int height,
+                                    int y_stride, int uv_stride, int uv_pixel_stride,
+                                    int rotation,
+                                    int64_t timestamp_us);
+
+/**
+ * @brief Consommateur : prend la trame la plus récente si elle est nouvelle.
+ * @return 1 si une nouvelle trame est prise, 0 sinon (la trame prise reste la précédente).
+ */
+JNI_EXPORT
+int pipeline_mailbox_take(PipelineContext* ctx);
+
+/**
+ * @brief Consommateur : prétraitement de la dernière trame prise vers l'entrée du modèle
+ *        (NV12 si elle a été publiée par pipeline_mailbox_publish ; plans U et V séparés
+ *        et rotation si elle l'a été par pipeline_mailbox_publish_yuv420).
+ * @return 1 si succès, 0 si aucune trame n'a encore été prise.
+ */
+JNI_EXPORT
+int pipeline_preprocess_latest(PipelineContext* ctx);
+
+// Métadonnées de la dernière trame prise (consommateur) ; compteurs, relus à chaque appel.
+JNI_EXPORT const FrameInfo* pipeline_mailbox_frame_info(PipelineContext* ctx);
+JNI_EXPORT MailboxStats* pipeline_mailbox_stats(PipelineContext* ctx);
+
+/**
+ * @brief Choisit la carte de profondeur lue par l'analyse : pipeline_depth_buffer
+ *        (DEPTH_FORMAT_F32) ou pipeline_depth_q8_buffer (DEPTH_FORMAT_U8 / S8, avec
+ *        les paramètres de quantification du tenseur de sortie). F32 par défaut.
+ * @return 1 si succès, 0 si le format est inconnu.
+ */
+JNI_EXPORT
+int pipeline_set_depth_format(PipelineContext* ctx, int format, float scale, int zero_point);
+
+/**
+ * @brief Choisit le format du tenseur d'entrée écrit par le prétraitement du contexte
+ *        (uint8 NHWC par défaut : pipeline_model_input_buffer). Tout autre format est
+ *        écrit dans pipeline_input_tensor_buffer, réservé ici.
+ * @param type, layout INPUT_TENSOR_U8 / F32 / F16 et INPUT_TENSOR_NHWC / NCHW.
+ * @param mean_r, mean_g, mean_b, std_r, std_g, std_b Normalisation par canal (unités 0..255).
+ * @return 1 si succès, 0 si le format est invalide ou en cas d'échec d'allocation.
+ */
+JNI_EXPORT
+int pipeline_set_input_format(PipelineContext* ctx, int type, int layout,
+                              float mean_r, float mean_g, float mean_b,
+                              float std_r, float std_g, float std_b);
+/** @brief Tenseur d'entrée au format choisi (pipeline_model_input_buffer en uint8 NHWC). */
+JNI_EXPORT void* pipeline_input_tensor_buffer(PipelineContext* ctx);
+/** @brief Taille en octets de pipeline_input_tensor_buffer. */
+JNI_EXPORT int64_t pipeline_input_tensor_bytes(PipelineContext* ctx);
+
+/**
+ * @brief Active (enabled = 1) ou désactive le filtre temporel du contexte. Activé, la
+ *        carte filtrée (pipeline_filtered_depth_buffer) remplace la carte brute pour
+ *        pipeline_compute_depth_stats et pipeline_detect_walls, dès le premier
+ *        pipeline_filter_depth. Repart de la prochaine carte (comme pipeline_reset_depth_filter).
+ * @return 1 si succès, 0 si les paramètres sont invalides (voir temporal_filter_depth).
+ */
+JNI_EXPORT
+int pipeline_set_temporal_filter(PipelineContext* ctx, int enabled, float alpha, float jump_threshold);
+
+/**
+ * @brief Intègre la carte de profondeur du contexte (selon son format) dans l'estimation
+ *        filtrée. À appeler une fois par trame, après l'inférence et avant l'analyse.
+ *        Sans effet si le filtre est désactivé. La première carte initialise l'estimation.
+ * @return 1 si succès, 0 sinon.
+ */
+JNI_EXPORT
+int pipeline_filter_depth(PipelineContext* ctx);
+
+/** @brief Oublie l'estimation filtrée : la prochaine carte la réinitialise. */
+JNI_EXPORT
+void pipeline_reset_depth_filter(PipelineContext* ctx);
+
+JNI_EXPORT float* pipeline_filtered_depth_buffer(PipelineContext* ctx);
+
+// Options et statistiques RANSAC du contexte (initialisées par ransac_default_options ;
+// Dart les ajuste une fois, puis les relit après chaque appel).
+JNI_EXPORT RansacOptions* pipeline_ransac_options(PipelineContext* ctx);
+JNI_EXPORT RansacStats* pipeline_ransac_stats(PipelineContext* ctx);
+
+/**
+ * @brief Change le nombre de threads du contexte, appelant compris (par défaut :
+ *        4, ou le nombre de cœurs s'il est plus petit).
+ *        Les threads sont recréés ici, une fois, puis réutilisés à chaque trame.
+ *        RANSAC répartit le score de ses hypothèses sur ces threads ; le résultat
+ *        ne dépend pas du nombre de threads.
+ * @param thread_count 8 au plus ; <= 0 : nombre de cœurs ; 1 : exécution série.
+ *        Sur un processeur à un seul cœur, l'exécution reste série quel que soit
+ *        thread_count (les threads supplémentaires ne font que dégrader la latence).
+ * @return Le nombre de threads effectif (moins que demandé si le système en refuse).
+ */
+JNI_EXPORT
+int pipeline_set_thread_count(PipelineContext* ctx, int thread_count);
+
+/**
+ * @brief RANSAC sur la carte de profondeur du contexte (selon son format), avec ses options ;
+ *        plans dans son tampon de plans, coût dans ses statistiques. Le contexte garde
+ *        ces plans pour l'appel suivant (reprise temporelle, voir RansacOptions.warm_start).
+ * @return Le nombre de plans détectés (au plus max_planes du contexte).
+ */
+JNI_EXPORT
+int pipeline_detect_walls(PipelineContext* ctx);
+
+/** @brief Oublie les plans de l'appel précédent (changement de scène, de caméra...). */
+JNI_EXPORT
+void pipeline_reset_warm_start(PipelineContext* ctx);
+
+/**
+ * @brief compute_depth_stats[_q8] sur la carte de profondeur du contexte ; résultat
+ *        dans ses statistiques de profondeur (voir pipeline_depth_stats).
+ * @return 1 si succès, 0 sinon.
+ */
+JNI_EXPORT
+int pipeline_compute_depth_stats(PipelineContext* ctx,
+                                 float free_path_threshold,
+                                 float histogram_max);
+JNI_EXPORT DepthStats* pipeline_depth_stats(PipelineContext* ctx);
+
+/**
+ * @brief Construit la pyramide de la carte de profondeur du contexte (niveaux 1 ..
+ *        level_count - 1, carte analysée = niveau 0). pipeline_detect_walls la
+ *        reconstruit elle-même jusqu'à RansacOptions.coarse_level si besoin.
+ * @return 1 si succès, 0 sinon.
+ */
+JNI_EXPORT
+int pipeline_build_depth_pyramid(PipelineContext* ctx, int level_count);
+/** @brief Niveau `level` de la pyramide ((model_width >> level) * (model_height >> level) floats), nul s'il n'est pas construit. */
+JNI_EXPORT float* pipeline_depth_level_buffer(PipelineContext* ctx, int level);
+/**
+ * @brief pipeline_compute_depth_stats sur le niveau `level` de la pyramide (0 : carte
+ *        analysée). Les comptes de l'histogramme sont en pixels du niveau.
+ * @return 1 si succès, 0 si le niveau n'est pas construit.
+ */
+JNI_EXPORT
+int pipeline_compute_depth_stats_level(PipelineContext* ctx, int level,
+                                       float free_path_threshold,
+                                       float histogram_max);
+
+/**
+ * @brief compute_polar_obstacles[_q8] sur la carte de profondeur du contexte, avec ses
+ *        options (pipeline_polar_obstacle_options) ; résultat dans sa carte polaire.
+ * @return 1 si succès, 0 sinon.
+ */
+JNI_EXPORT
+int pipeline_compute_polar_obstacles(PipelineContext* ctx);
+JNI_EXPORT PolarObstacleOptions* pipeline_polar_obstacle_options(PipelineContext* ctx);
+JNI_EXPORT PolarObstacleMap* pipeline_polar_obstacles(PipelineContext* ctx);
+
+/**
+ * @brief detect_obstacle_blobs[_q8] sur la carte de profondeur du contexte, avec sa
+ *        mémoire de travail persistante ; composantes dans pipeline_obstacle_blobs
+ *        (OBSTACLE_BLOBS_MAX entrées au plus).
+ * @return Nombre de composantes écrites.
+ */
+JNI_EXPORT
+int pipeline_detect_obstacle_blobs(PipelineContext* ctx, float closeness_threshold, int min_area);
+JNI_EXPORT ObstacleBlob* pipeline_obstacle_blobs(PipelineContext* ctx);
+
+/**
+ * @brief Construit les tables cumulées de la carte de profondeur du contexte (une fois
+ *        par carte, après le filtre temporel). Les requêtes suivantes les réutilisent.
+ * @return 1 si succès, 0 sinon.
+ */
+JNI_EXPORT
+int pipeline_build_depth_integral(PipelineContext* ctx, float threshold);
+/**
+ * @brief Répond aux region_count premiers rectangles de pipeline_depth_regions
+ *        (DEPTH_REGIONS_MAX au plus) dans pipeline_depth_region_stats.
+ * @return Nombre de rectangles traités (0 si les tables ne sont pas construites).
+ */
+JNI_EXPORT
+int pipeline_query_depth_regions(PipelineContext* ctx, int region_count);
+JNI_EXPORT DepthRegion* pipeline_depth_regions(PipelineContext* ctx);
+JNI_EXPORT RegionStats* pipeline_depth_region_stats(PipelineContext* ctx);
+
+// --- Traitement de trame complet (interpréteur TFLite natif, optionnel) ---
+// Le contexte possède un interpréteur (API C de TFLite) : une trame traverse
+// prétraitement, inférence, analyse et RANSAC en un seul appel, sans repasser par Dart.
+
+/** @brief 1 si la bibliothèque est compilée avec TFLite (NATIVE_WITH_TFLITE), 0 sinon. */
+JNI_EXPORT
+int pipeline_has_tflite(void);
+
+/**
+ * @brief Charge un modèle .tflite et alloue ses tenseurs une fois. Le fichier est projeté
+ *        en mémoire (mmap) et l'interpréteur construit directement sur la projection :
+ *        les poids ne sont jamais copiés. Le tenseur d'entrée devient pipeline_input_tensor_buffer : son type et
+ *        sa disposition viennent du modèle (la normalisation reste celle de
+ *        pipeline_set_input_format). Le format de la sortie fixe pipeline_set_depth_format.
+ * @param thread_count Threads de l'interpréteur (<= 0 : choix de TFLite).
+ * @return PIPELINE_STATUS_OK, ou PIPELINE_STATUS_NO_TFLITE / MODEL_ERROR / MODEL_MISMATCH
+ *         (le modèle précédent est alors déchargé).
+ */
+JNI_EXPORT
+int pipeline_load_model(PipelineContext* ctx, const char* model_path, int thread_count);
+
+/**
+ * @brief Traite une trame YUV 4:2:0 de bout en bout : prétraitement dans le tenseur
+ *        d'entrée de l'interpréteur, inférence, filtre temporel, statistiques, composantes
+ *        d'obstacles, carte polaire et RANSAC (seuils : pipeline_frame_options).
+ *        Résultat dans pipeline_frame_result.
+ * @param u_plane, v_plane Plans chroma ; v_plane NULL : NV12 (u_plane entrelacé U, V).
+ * @return PIPELINE_STATUS_* (recopié dans FrameResult.status).
+ */
+JNI_EXPORT
+int pipeline_process_frame(PipelineContext* ctx,
+                           const uint8_t* y_plane, const uint8_t* u_plane, const uint8_t* v_plane,
+                           int width, int height, int y_stride, int uv_stride,
+                           int uv_pixel_stride, int rotation);
+
+/**
+ * @brief pipeline_process_frame sur la dernière trame prise de la boîte aux lettres
+ *        (après pipeline_mailbox_take).
+ * @return PIPELINE_STATUS_*, PIPELINE_STATUS_NO_FRAME si aucune trame n'a été prise.
+ */
+JNI_EXPORT
+int pipeline_process_latest(PipelineContext* ctx);
+
+// Seuils de l'analyse (modifiables en place) et résultat de la dernière trame traitée.
+JNI_EXPORT FrameProcessOptions* pipeline_frame_options(PipelineContext* ctx);
+JNI_EXPORT FrameResult* pipeline_frame_result(PipelineContext* ctx);
+
+/**
+ * @brief Lit la mémoire résidente actuelle et le pic du processus (/proc/self/status).
+ * @return 1 si succès, 0 si les valeurs sont indisponibles.
+ */
+JNI_EXPORT
+int read_process_memory(ProcessMemory* out);
+
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
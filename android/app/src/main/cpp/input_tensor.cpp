@@ -0,0 +1,272 @@
+// android/app/src/main/cpp/input_tensor.cpp
+
+#include "input_tensor.h"
+#include "image_utils.h" // Pour les déclarations exportées
+
+#include <math.h>        // Pour isfinite
+#include <stdint.h>
+#include <string.h>      // Pour memcpy
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Outils internes ---
+
+namespace {
+
+// Pixels normalisés par bloc avant conversion en float16 (valeurs float sur la pile).
+constexpr size_t kHalfChunkPixels = 256;
+
+// Normalisation par canal sous forme affine : x * scale[c] + bias[c],
+// avec scale = 1 / std et bias = -mean / std.
+struct ChannelAffine {
+    float scale[3];
+    float bias[3];
+};
+
+ChannelAffine channel_affine(const InputTensorFormat& format) {
+    ChannelAffine affine;
+    for (int c = 0; c < 3; ++c) {
+        affine.scale[c] = 1.0f / format.std[c];
+        affine.bias[c] = -format.mean[c] / format.std[c];
+    }
+    return affine;
+}
+
+// float -> binary16, arrondi au plus proche pair (sous-normaux, infinis et NaN compris).
+inline uint16_t float_to_half(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    if (magnitude >= 0x7F800000u) {                       // Infini ou NaN (NaN reste silencieux)
+        return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x0200u : 0u));
+    }
+    if (magnitude >= 0x477FF000u) {                       // >= 65520 : arrondi à l'infini
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (magnitude < 0x38800000u) {                        // < 2^-14 : sous-normal (ou zéro)
+        if (magnitude < 0x33000000u) return static_cast<uint16_t>(sign); // < 2^-25
+        const uint32_t exponent = magnitude >> 23;
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126u - exponent;           // Unités de 2^-24
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t midpoint = 1u << (shift - 1u);
+        if (remainder > midpoint || (remainder == midpoint && (half & 1u) != 0)) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+    // Normal : exposant rebiaisé (127 -> 15), 13 bits de mantisse arrondis au plus proche pair
+    // (une retenue passe naturellement dans l'exposant).
+    magnitude -= 112u << 23;
+    return static_cast<uint16_t>(sign | ((magnitude + 0x0FFFu + ((magnitude >> 13) & 1u)) >> 13));
+}
+
+void floats_to_half(const float* values, size_t count, uint16_t* out) {
+    size_t i = 0;
+#if defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(values + i))));
+    }
+#elif defined(__F16C__)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i),
+                         _mm_cvtps_ph(_mm_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+    for (; i < count; ++i) out[i] = float_to_half(values[i]);
+}
+
+// `count` valeurs R, G, B entrelacées (count multiple de 3) -> floats normalisés, entrelacés.
+// 48 valeurs (16 pixels) par itération : douze vecteurs de 4 dont les canaux suivent un
+// motif de période 3 vecteurs.
+void normalize_interleaved(const uint8_t* rgb, size_t count, const ChannelAffine& affine, float* out) {
+    size_t i = 0;
+#if defined(__SSE2__) || defined(__aarch64__)
+    float pattern_scale[12], pattern_bias[12];
+    for (int k = 0; k < 12; ++k) {
+        pattern_scale[k] = affine.scale[k % 3];
+        pattern_bias[k] = affine.bias[k % 3];
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128 vscale[3] = {_mm_loadu_ps(pattern_scale), _mm_loadu_ps(pattern_scale + 4), _mm_loadu_ps(pattern_scale + 8)};
+    const __m128 vbias[3] = {_mm_loadu_ps(pattern_bias), _mm_loadu_ps(pattern_bias + 4), _mm_loadu_ps(pattern_bias + 8)};
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 48 <= count; i += 48) {
+        for (int part = 0; part < 3; ++part) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + i + 16 * part));
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            const __m128 values[4] = {
+                _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)),
+                _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero))};
+            for (int q = 0; q < 4; ++q) {
+                const int k = part * 4 + q;
+                _mm_storeu_ps(out + i + 4 * k,
+                              _mm_add_ps(_mm_mul_ps(values[q], vscale[k % 3]), vbias[k % 3]));
+            }
+        }
+    }
+#elif defined(__aarch64__)
+    const float32x4_t vscale[3] = {vld1q_f32(pattern_scale), vld1q_f32(pattern_scale + 4), vld1q_f32(pattern_scale + 8)};
+    const float32x4_t vbias[3] = {vld1q_f32(pattern_bias), vld1q_f32(pattern_bias + 4), vld1q_f32(pattern_bias + 8)};
+    for (; i + 48 <= count; i += 48) {
+        for (int part = 0; part < 3; ++part) {
+            const uint8x16_t bytes = vld1q_u8(rgb + i + 16 * part);
+            const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+            const float32x4_t values[4] = {
+                vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))),
+                vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), vcvtq_f32_u32(vmovl_u16(vget_high_u16(high)))};
+            for (int q = 0; q < 4; ++q) {
+                const int k = part * 4 + q;
+                vst1q_f32(out + i + 4 * k, vmlaq_f32(vbias[k % 3], values[q], vscale[k % 3]));
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const int c = static_cast<int>(i % 3);
+        out[i] = static_cast<float>(rgb[i]) * affine.scale[c] + affine.bias[c];
+    }
+}
+
+// `pixels` pixels RGB888 -> trois plans de floats normalisés (NEON : désentrelacement vld3).
+void normalize_planar(const uint8_t* rgb, size_t pixels, const ChannelAffine& affine,
+                      float* out_r, float* out_g, float* out_b) {
+    float* const planes[3] = {out_r, out_g, out_b};
+    size_t i = 0;
+#if defined(__aarch64__)
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x3_t channels = vld3q_u8(rgb + 3 * i);
+        for (int c = 0; c < 3; ++c) {
+            const float32x4_t scale = vdupq_n_f32(affine.scale[c]);
+            const float32x4_t bias = vdupq_n_f32(affine.bias[c]);
+            const uint16x8_t low = vmovl_u8(vget_low_u8(channels.val[c]));
+            const uint16x8_t high = vmovl_u8(vget_high_u8(channels.val[c]));
+            float* out = planes[c] + i;
+            vst1q_f32(out, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), scale));
+            vst1q_f32(out + 4, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))), scale));
+            vst1q_f32(out + 8, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), scale));
+            vst1q_f32(out + 12, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), scale));
+        }
+    }
+#endif
+    for (; i < pixels; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            planes[c][i] = static_cast<float>(rgb[3 * i + c]) * affine.scale[c] + affine.bias[c];
+        }
+    }
+}
+
+// `pixels` pixels RGB888 -> trois plans d'octets.
+void deinterleave_rgb(const uint8_t* rgb, size_t pixels, uint8_t* out_r, uint8_t* out_g, uint8_t* out_b) {
+    size_t i = 0;
+#if defined(__aarch64__)
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x3_t channels = vld3q_u8(rgb + 3 * i);
+        vst1q_u8(out_r + i, channels.val[0]);
+        vst1q_u8(out_g + i, channels.val[1]);
+        vst1q_u8(out_b + i, channels.val[2]);
+    }
+#endif
+    for (; i < pixels; ++i) {
+        out_r[i] = rgb[3 * i];
+        out_g[i] = rgb[3 * i + 1];
+        out_b[i] = rgb[3 * i + 2];
+    }
+}
+
+} // namespace
+
+
+// --- Implémentation ---
+
+bool input_format_valid(const InputTensorFormat& format) {
+    if (format.type != INPUT_TENSOR_U8 && format.type != INPUT_TENSOR_F32 && format.type != INPUT_TENSOR_F16) {
+        return false;
+    }
+    if (format.layout != INPUT_TENSOR_NHWC && format.layout != INPUT_TENSOR_NCHW) return false;
+    if (format.type == INPUT_TENSOR_U8) return true; // Normalisation ignorée
+    for (int c = 0; c < 3; ++c) {
+        if (!(format.std[c] > 0.0f) || !isfinite(format.std[c]) || !isfinite(format.mean[c])) return false;
+    }
+    return true;
+}
+
+size_t input_tensor_size(const InputTensorFormat& format, int width, int height) {
+    const size_t element = format.type == INPUT_TENSOR_F32 ? 4 : (format.type == INPUT_TENSOR_F16 ? 2 : 1);
+    return static_cast<size_t>(width) * height * 3 * element;
+}
+
+void convert_rgb_rows(const uint8_t* rgb, int width, int height,
+                      int first_row, int row_count,
+                      const InputTensorFormat& format, void* tensor) {
+    const size_t pixels = static_cast<size_t>(width) * row_count;
+    const size_t first = static_cast<size_t>(first_row) * width; // Premier pixel écrit
+    const size_t plane = static_cast<size_t>(width) * height;    // Pixels par plan (NCHW)
+    const bool planar = format.layout == INPUT_TENSOR_NCHW;
+
+    if (format.type == INPUT_TENSOR_U8) {
+        uint8_t* out = static_cast<uint8_t*>(tensor);
+        if (planar) {
+            deinterleave_rgb(rgb, pixels, out + first, out + plane + first, out + 2 * plane + first);
+        } else {
+            memcpy(out + first * 3, rgb, pixels * 3);
+        }
+        return;
+    }
+
+    const ChannelAffine affine = channel_affine(format);
+    if (format.type == INPUT_TENSOR_F32) {
+        float* out = static_cast<float*>(tensor);
+        if (planar) {
+            normalize_planar(rgb, pixels, affine, out + first, out + plane + first, out + 2 * plane + first);
+        } else {
+            normalize_interleaved(rgb, pixels * 3, affine, out + first * 3);
+        }
+        return;
+    }
+
+    // float16 : normalisation en float par blocs, puis conversion.
+    uint16_t* out = static_cast<uint16_t*>(tensor);
+    float chunk[3 * kHalfChunkPixels];
+    for (size_t p = 0; p < pixels; p += kHalfChunkPixels) {
+        const size_t n = pixels - p < kHalfChunkPixels ? pixels - p : kHalfChunkPixels;
+        if (planar) {
+            normalize_planar(rgb + 3 * p, n, affine, chunk, chunk + kHalfChunkPixels, chunk + 2 * kHalfChunkPixels);
+            for (size_t c = 0; c < 3; ++c) {
+                floats_to_half(chunk + c * kHalfChunkPixels, n, out + c * plane + first + p);
+            }
+        } else {
+            normalize_interleaved(rgb + 3 * p, 3 * n, affine, chunk);
+            floats_to_half(chunk, 3 * n, out + (first + p) * 3);
+        }
+    }
+}
+
+extern "C" int64_t input_tensor_bytes(const InputTensorFormat* format, int width, int height) {
+    if (format == nullptr || !input_format_valid(*format) || width <= 0 || height <= 0) return 0;
+    return static_cast<int64_t>(input_tensor_size(*format, width, height));
+}
+
+extern "C" int convert_rgb_to_input_tensor(const uint8_t* rgb, int width, int height,
+                                           const InputTensorFormat* format, void* out_tensor) {
+    if (rgb == nullptr || format == nullptr || out_tensor == nullptr || width <= 0 || height <= 0 ||
+        !input_format_valid(*format)) {
+        LOGE("convert_rgb_to_input_tensor : paramètres invalides (%dx%d)", width, height);
+        return 0;
+    }
+    convert_rgb_rows(rgb, width, height, 0, height, *format, out_tensor);
+    return 1;
+}
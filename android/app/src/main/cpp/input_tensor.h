@@ -0,0 +1,31 @@
+// android/app/src/main/cpp/input_tensor.h
+// En-tête interne (C++) : conversion de l'entrée RGB888 du modèle vers un tenseur
+// uint8 / float32 / float16, partagée par le prétraitement fusionné et le contexte.
+
+#ifndef INPUT_TENSOR_H
+#define INPUT_TENSOR_H
+
+#include "image_utils.h" // Pour InputTensorFormat
+
+#include <stddef.h>
+#include <stdint.h>
+
+// true si le type, la disposition et les écarts-types (> 0, finis) sont utilisables.
+bool input_format_valid(const InputTensorFormat& format);
+
+// true pour uint8 NHWC : le tenseur est l'image RGB888 elle-même (aucune conversion).
+inline bool input_format_is_rgb(const InputTensorFormat& format) {
+    return format.type == INPUT_TENSOR_U8 && format.layout == INPUT_TENSOR_NHWC;
+}
+
+// Octets d'un tenseur width x height x 3 (format supposé valide).
+size_t input_tensor_size(const InputTensorFormat& format, int width, int height);
+
+// Écrit les lignes [first_row, first_row + row_count[ d'une image de width x height pixels
+// dans le tenseur, à partir de `rgb` qui ne contient que ces lignes (RGB888 HWC).
+// En NCHW, chaque plan fait width * height valeurs : les lignes vont à leur place dans les trois.
+void convert_rgb_rows(const uint8_t* rgb, int width, int height,
+                      int first_row, int row_count,
+                      const InputTensorFormat& format, void* tensor);
+
+#endif // INPUT_TENSOR_H
@@ -0,0 +1,47 @@
+// android/app/src/main/cpp/mapped_file.cpp
+
+#include "mapped_file.h"
+
+#include <errno.h>
+#include <fcntl.h>    // Pour open
+#include <string.h>   // Pour strerror
+#include <sys/mman.h> // Pour mmap, madvise, munmap
+#include <sys/stat.h> // Pour fstat
+#include <unistd.h>   // Pour close
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+bool MappedFile::open(const char* path) {
+    reset();
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("MappedFile : ouverture impossible (%s) : %s", path, strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        LOGE("MappedFile : fichier vide ou illisible (%s)", path);
+        close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // La projection garde le fichier ouvert
+    if (data == MAP_FAILED) {
+        LOGE("MappedFile : projection impossible (%s) : %s", path, strerror(errno));
+        return false;
+    }
+    // Lecture anticipée en arrière-plan : les poids sont tous lus à la préparation de
+    // l'interpréteur, juste après.
+    madvise(data, size, MADV_WILLNEED);
+    data_ = data;
+    size_ = size;
+    return true;
+}
+
+void MappedFile::reset() {
+    if (data_ != nullptr) munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+}
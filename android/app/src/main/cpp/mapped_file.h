@@ -0,0 +1,32 @@
+// android/app/src/main/cpp/mapped_file.h
+// En-tête interne (C++) : fichier projeté en mémoire en lecture seule (modèle .tflite).
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+
+// Projection privée en lecture seule d'un fichier entier. Les pages sont celles du
+// cache du noyau : lues à la demande, partagées et récupérables sous pression mémoire
+// (aucune copie sur le tas, ni en Dart ni en natif).
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { reset(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Projette `path` (l'ancienne projection est libérée). false si le fichier est
+    // absent, vide ou non projetable.
+    bool open(const char* path);
+    void reset();
+
+    const void* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // MAPPED_FILE_H
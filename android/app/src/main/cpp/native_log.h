@@ -0,0 +1,36 @@
+// android/app/src/main/cpp/native_log.h
+// En-tête interne (C++) : journalisation de la bibliothèque native.
+// Sur Android : logcat (__android_log_print). Ailleurs (build Linux, benchmarks) :
+// stderr, avec les messages de debug désactivés sauf si NATIVE_LOG_VERBOSE est défini
+// (RANSAC journalise chaque appel, ce qui fausserait les mesures).
+
+#ifndef NATIVE_LOG_H
+#define NATIVE_LOG_H
+
+#ifndef LOG_TAG
+#define LOG_TAG "NativeLib"
+#endif
+
+#if defined(__ANDROID__)
+
+#include <android/log.h>
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__) // Warning
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#else
+
+#include <stdio.h>
+#define NATIVE_LOG_STDERR(level, ...) \
+    do { fprintf(stderr, "%s/%s: ", level, LOG_TAG); fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } while (0)
+#if defined(NATIVE_LOG_VERBOSE)
+#define LOGD(...) NATIVE_LOG_STDERR("D", __VA_ARGS__)
+#else
+#define LOGD(...) do { } while (0)
+#endif
+#define LOGW(...) NATIVE_LOG_STDERR("W", __VA_ARGS__)
+#define LOGE(...) NATIVE_LOG_STDERR("E", __VA_ARGS__)
+
+#endif
+
+#endif // NATIVE_LOG_H
@@ -0,0 +1,53 @@
+// android/app/src/main/cpp/native_memory.h
+
+#ifndef NATIVE_MEMORY_H
+#define NATIVE_MEMORY_H
+
+#include <stddef.h> // Pour size_t
+#include <stdlib.h> // Pour posix_memalign, free
+#include <string.h> // Pour memset
+
+// Alignement des tampons natifs : une ligne de cache (et suffisant pour NEON/AVX).
+constexpr size_t kNativeBufferAlignment = 64;
+
+// Tampon aligné réutilisable, propriétaire de sa mémoire.
+// - reserve() ne réalloue que si la capacité demandée dépasse la capacité actuelle :
+//   en régime permanent (mêmes dimensions à chaque trame), aucune allocation.
+// - La mémoire est mise à zéro à l'allocation, ce qui touche toutes les pages
+//   une fois pour toutes (pas de défauts de page pendant la boucle de trames).
+// posix_memalign plutôt que aligned_alloc : disponible dès l'API Android 16.
+template <typename T>
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+    ~AlignedBuffer() { free(data_); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    // Garantit au moins `count` éléments. Retourne false si l'allocation échoue
+    // (l'ancien contenu est alors conservé).
+    bool reserve(size_t count) {
+        if (count <= capacity_) return true;
+        void* memory = nullptr;
+        const size_t bytes = count * sizeof(T);
+        if (posix_memalign(&memory, kNativeBufferAlignment, bytes) != 0 || memory == nullptr) {
+            return false;
+        }
+        memset(memory, 0, bytes);
+        free(data_);
+        data_ = static_cast<T*>(memory);
+        capacity_ = count;
+        return true;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    T* data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+#endif // NATIVE_MEMORY_H
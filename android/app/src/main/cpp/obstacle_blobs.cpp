@@ -0,0 +1,234 @@
+// android/app/src/main/cpp/obstacle_blobs.cpp
+
+#include "obstacle_blobs.h"
+#include "image_utils.h" // Pour les déclarations exportées
+
+#include <stdint.h>
+#include <string.h>      // Pour memcpy
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Outils internes ---
+
+namespace {
+
+// Masque seuillé d'une ligne float : 0xFF si valeur > seuil (NaN : 0), 0 sinon.
+// 16 pixels par itération, comparaisons rétrécies en octets.
+void threshold_row(const float* values, size_t count, float threshold, uint8_t* mask) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 vthreshold = _mm_set1_ps(threshold);
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(values + i), vthreshold));
+        const __m128i b = _mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(values + i + 4), vthreshold));
+        const __m128i c = _mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(values + i + 8), vthreshold));
+        const __m128i d = _mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(values + i + 12), vthreshold));
+        // -1 / 0 en int32 -> int16 -> int8 (saturation signée : reste -1 / 0).
+        const __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i), bytes);
+    }
+#elif defined(__aarch64__)
+    const float32x4_t vthreshold = vdupq_n_f32(threshold);
+    for (; i + 16 <= count; i += 16) {
+        const uint16x4_t a = vmovn_u32(vcgtq_f32(vld1q_f32(values + i), vthreshold));
+        const uint16x4_t b = vmovn_u32(vcgtq_f32(vld1q_f32(values + i + 4), vthreshold));
+        const uint16x4_t c = vmovn_u32(vcgtq_f32(vld1q_f32(values + i + 8), vthreshold));
+        const uint16x4_t d = vmovn_u32(vcgtq_f32(vld1q_f32(values + i + 12), vthreshold));
+        const uint8x16_t bytes = vcombine_u8(vmovn_u16(vcombine_u16(a, b)), vmovn_u16(vcombine_u16(c, d)));
+        vst1q_u8(mask + i, bytes);
+    }
+#endif
+    for (; i < count; ++i) mask[i] = values[i] > threshold ? 0xFF : 0;
+}
+
+// Racine de la suite i (compression de chemin par moitiés).
+inline int32_t find_root(int32_t* parent, int32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Fusion : la racine d'indice le plus grand est rattachée à l'autre, si bien qu'une
+// racine précède toujours les suites de sa composante (ordre de balayage).
+inline void unite(int32_t* parent, int32_t a, int32_t b) {
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a == b) return;
+    if (a < b) parent[b] = a; else parent[a] = b;
+}
+
+} // namespace
+
+
+// --- Implémentation ---
+
+bool BlobScratch::reserve(int width, int height) {
+    const size_t max_runs = static_cast<size_t>(height) * ((static_cast<size_t>(width) + 1) / 2);
+    return runs.reserve(max_runs) && parent.reserve(max_runs) && label.reserve(max_runs) &&
+           blobs.reserve(max_runs) && row_mask.reserve(static_cast<size_t>(width));
+}
+
+int obstacle_blobs(const DepthInput& depth, int width, int height,
+                   float closeness_threshold, int min_area,
+                   ObstacleBlob* out_blobs, int max_blobs,
+                   BlobScratch& scratch) {
+    if (!depth.valid() || out_blobs == nullptr || width <= 0 || height <= 0 || max_blobs <= 0) {
+        LOGE("detect_obstacle_blobs : paramètres invalides (%dx%d, %d composantes).", width, height, max_blobs);
+        return 0;
+    }
+    if (!scratch.reserve(width, height)) {
+        LOGE("detect_obstacle_blobs : échec d'allocation de la mémoire de travail.");
+        return 0;
+    }
+
+    // En 8 bits, le seuil est appliqué une fois aux 256 valeurs de la table.
+    uint8_t above_q8[256];
+    if (depth.q8 != nullptr) {
+        for (int q = 0; q < 256; ++q) above_q8[q] = depth.lut[q] > closeness_threshold ? 0xFF : 0;
+    }
+
+    PixelRun* runs = scratch.runs.data();
+    int32_t* parent = scratch.parent.data();
+    uint8_t* mask = scratch.row_mask.data();
+
+    // --- 1. Suites par ligne, fusionnées avec celles de la ligne précédente ---
+    // Deux suites de lignes voisines se touchent (connexité 8) si leurs intervalles
+    // élargis d'un pixel se recouvrent : a.x0 <= b.x1 et a.x1 >= b.x0.
+    int32_t run_count = 0;
+    int32_t previous_begin = 0, previous_end = 0;
+    for (int y = 0; y < height; ++y) {
+        const size_t row = static_cast<size_t>(y) * width;
+        if (depth.q8 != nullptr) {
+            for (int x = 0; x < width; ++x) mask[x] = above_q8[depth.q8[row + x]];
+        } else {
+            threshold_row(depth.f32 + row, static_cast<size_t>(width), closeness_threshold, mask);
+        }
+
+        const int32_t current_begin = run_count;
+        int32_t p = previous_begin;
+        int x = 0;
+        while (x < width) {
+            // Saut des zones libres, 8 octets à la fois.
+            while (x + 8 <= width) {
+                uint64_t word;
+                memcpy(&word, mask + x, sizeof(word));
+                if (word != 0) break;
+                x += 8;
+            }
+            while (x < width && mask[x] == 0) ++x;
+            if (x >= width) break;
+
+            PixelRun& run = runs[run_count];
+            run.y = y;
+            run.x0 = x;
+            float peak = depth.at(row + x);
+            for (++x; x < width && mask[x] != 0; ++x) {
+                const float value = depth.at(row + x);
+                peak = value > peak ? value : peak;
+            }
+            run.x1 = x;
+            run.peak = peak;
+            parent[run_count] = run_count;
+
+            // Suites de la ligne précédente encore à gauche : plus aucune suite
+            // de cette ligne (plus à droite) ne peut les toucher.
+            while (p < previous_end && runs[p].x1 < run.x0) ++p;
+            for (int32_t q = p; q < previous_end && runs[q].x0 <= run.x1; ++q) {
+                unite(parent, q, run_count);
+            }
+            ++run_count;
+        }
+        previous_begin = current_begin;
+        previous_end = run_count;
+    }
+
+    // --- 2. Statistiques par composante ---
+    // Les racines précèdent leurs suites : une composante est numérotée à sa première suite.
+    int32_t* label = scratch.label.data();
+    BlobAccumulator* blobs = scratch.blobs.data();
+    int32_t blob_count = 0;
+    for (int32_t i = 0; i < run_count; ++i) {
+        const int32_t root = find_root(parent, i);
+        const PixelRun& run = runs[i];
+        const int64_t length = run.x1 - run.x0;
+        if (root == i) {
+            label[i] = blob_count;
+            BlobAccumulator& blob = blobs[blob_count++];
+            blob.area = 0;
+            blob.sum_x = blob.sum_y = 0;
+            blob.x_min = run.x0;
+            blob.x_max = run.x1 - 1;
+            blob.y_min = blob.y_max = run.y;
+            blob.peak = run.peak;
+        }
+        BlobAccumulator& blob = blobs[label[root]];
+        blob.area += length;
+        // Somme de x0 .. x1 - 1 (produit toujours pair : les deux facteurs sont de parités opposées).
+        blob.sum_x += (static_cast<int64_t>(run.x0) + run.x1 - 1) * length / 2;
+        blob.sum_y += static_cast<int64_t>(run.y) * length;
+        blob.x_min = run.x0 < blob.x_min ? run.x0 : blob.x_min;
+        blob.x_max = run.x1 - 1 > blob.x_max ? run.x1 - 1 : blob.x_max;
+        blob.y_max = run.y; // Balayage ligne par ligne : la dernière suite est la plus basse
+        blob.peak = run.peak > blob.peak ? run.peak : blob.peak;
+    }
+
+    // --- 3. Les max_blobs plus grandes composantes, par aire décroissante ---
+    // (tri par insertion dans le tableau de sortie, borné ; à aire égale, ordre de balayage)
+    int written = 0;
+    for (int32_t b = 0; b < blob_count; ++b) {
+        const BlobAccumulator& blob = blobs[b];
+        if (blob.area < min_area) continue;
+        if (written == max_blobs && blob.area <= out_blobs[written - 1].area) continue;
+
+        int slot = written < max_blobs ? written++ : max_blobs - 1;
+        while (slot > 0 && out_blobs[slot - 1].area < blob.area) {
+            out_blobs[slot] = out_blobs[slot - 1];
+            --slot;
+        }
+        ObstacleBlob& out = out_blobs[slot];
+        out.x_min = blob.x_min;
+        out.y_min = blob.y_min;
+        out.x_max = blob.x_max;
+        out.y_max = blob.y_max;
+        out.area = static_cast<int32_t>(blob.area);
+        out.centroid_x = static_cast<float>(static_cast<double>(blob.sum_x) / static_cast<double>(blob.area));
+        out.centroid_y = static_cast<float>(static_cast<double>(blob.sum_y) / static_cast<double>(blob.area));
+        out.peak_closeness = blob.peak;
+    }
+    return written;
+}
+
+extern "C" int detect_obstacle_blobs(const float* depth_map_data,
+                                     int width, int height,
+                                     float closeness_threshold, int min_area,
+                                     ObstacleBlob* out_blobs, int max_blobs) {
+    if (depth_map_data == nullptr) return 0;
+    BlobScratch scratch;
+    return obstacle_blobs(DepthInput::from_f32(depth_map_data), width, height,
+                          closeness_threshold, min_area, out_blobs, max_blobs, scratch);
+}
+
+extern "C" int detect_obstacle_blobs_q8(const uint8_t* depth_q8,
+                                        int width, int height,
+                                        int format, float scale, int zero_point,
+                                        float closeness_threshold, int min_area,
+                                        ObstacleBlob* out_blobs, int max_blobs) {
+    DepthInput depth;
+    if (depth_q8 == nullptr || !DepthInput::from_q8(depth_q8, format, scale, zero_point, depth)) {
+        LOGE("detect_obstacle_blobs_q8 : format invalide (%d).", format);
+        return 0;
+    }
+    BlobScratch scratch;
+    return obstacle_blobs(depth, width, height, closeness_threshold, min_area, out_blobs, max_blobs, scratch);
+}
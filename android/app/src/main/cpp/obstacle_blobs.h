@@ -0,0 +1,49 @@
+// android/app/src/main/cpp/obstacle_blobs.h
+// En-tête interne (C++) : composantes connexes de la carte seuillée, partagé avec le contexte.
+
+#ifndef OBSTACLE_BLOBS_H
+#define OBSTACLE_BLOBS_H
+
+#include "image_utils.h"   // Pour ObstacleBlob
+#include "native_memory.h" // Pour AlignedBuffer
+#include "depth_input.h"   // Pour DepthInput
+
+#include <stdint.h>
+
+// Suite horizontale de pixels obstacles d'une ligne : [x0, x1[ sur la ligne y.
+struct PixelRun {
+    int32_t y;
+    int32_t x0, x1;
+    float peak; // Profondeur inverse maximale de la suite
+};
+
+// Statistiques cumulées d'une composante (une par racine de l'union-find).
+struct BlobAccumulator {
+    int64_t area;
+    int64_t sum_x, sum_y;
+    int32_t x_min, y_min, x_max, y_max;
+    float peak;
+};
+
+// Mémoire de travail de la segmentation, réutilisable d'un appel à l'autre (le contexte
+// de pipeline en possède une instance). Au pire une suite pour deux pixels par ligne :
+// height * (width + 1) / 2 suites, réservées une fois pour la résolution du modèle.
+struct BlobScratch {
+    AlignedBuffer<PixelRun> runs;
+    AlignedBuffer<int32_t> parent;           // Union-find sur les indices de suites
+    AlignedBuffer<int32_t> label;            // Racine -> indice de composante
+    AlignedBuffer<BlobAccumulator> blobs;    // Une entrée par composante
+    AlignedBuffer<uint8_t> row_mask;         // Masque seuillé d'une ligne (0 / 0xFF)
+
+    bool reserve(int width, int height);
+};
+
+// Cœur de detect_obstacle_blobs[_q8] et de pipeline_detect_obstacle_blobs.
+// Écrit au plus max_blobs composantes d'au moins min_area pixels, par aire décroissante.
+// Retourne le nombre écrit (0 si aucun obstacle ou si les paramètres sont invalides).
+int obstacle_blobs(const DepthInput& depth, int width, int height,
+                   float closeness_threshold, int min_area,
+                   ObstacleBlob* out_blobs, int max_blobs,
+                   BlobScratch& scratch);
+
+#endif // OBSTACLE_BLOBS_H
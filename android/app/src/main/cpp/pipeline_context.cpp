@@ -0,0 +1,678 @@
+// android/app/src/main/cpp/pipeline_context.cpp
+
+#include "pipeline_context.h" // Définition du contexte
+#include "image_utils.h"      // API C exportée
+#include "input_tensor.h"     // Pour input_format_valid
+#include "ransac.h"           // Pour ransac_detect_planes
+#include "polar_obstacles.h"  // Pour polar_obstacles
+
+#include <chrono>             // Pour les durées des étapes (FrameResult)
+#include <cstring>            // Pour std::memcpy
+#include <limits>             // Pour std::numeric_limits
+#include <new>                // Pour std::nothrow
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Création / destruction ---
+
+// Threads par défaut, appelant compris (moins si l'appareil a moins de cœurs). Au-delà
+// de 4, les téléphones big.LITTLE ajoutent surtout des petits cœurs, qui ralentissent
+// chaque lot au lieu de l'accélérer.
+constexpr int kDefaultThreadCount = 4;
+
+extern "C" PipelineContext* pipeline_create(int camera_width, int camera_height,
+                                            int model_width, int model_height,
+                                            int max_planes) {
+    if (model_width <= 0 || model_height <= 0 || max_planes < 0 ||
+        camera_width < 0 || camera_height < 0) {
+        LOGE("pipeline_create : dimensions invalides (caméra %dx%d, modèle %dx%d, plans %d)",
+             camera_width, camera_height, model_width, model_height, max_planes);
+        return nullptr;
+    }
+
+    PipelineContext* ctx = new (std::nothrow) PipelineContext();
+    if (ctx == nullptr) return nullptr;
+
+    ctx->model_width = model_width;
+    ctx->model_height = model_height;
+    ctx->max_planes = max_planes;
+    ransac_default_options(&ctx->ransac_options);
+    polar_obstacle_default_options(&ctx->polar_options);
+
+    const size_t model_pixels = static_cast<size_t>(model_width) * model_height;
+    // Emplacements de la boîte aux lettres. NV12 : Y = w*h octets, UV = w*h/2 octets
+    // (sans padding ; le stride réel est pris en compte par pipeline_mailbox_reserve).
+    // Trames à trois plans : U et V au plus w*h/2 octets chacun (pas de pixel 2).
+    const size_t camera_pixels = static_cast<size_t>(camera_width) * camera_height;
+
+    bool ok = ctx->model_input.reserve(model_pixels * 3) &&
+              ctx->depth_map.reserve(model_pixels) &&
+              ctx->depth_q8.reserve(model_pixels) &&
+              ctx->filtered_depth.reserve(model_pixels) &&
+              ctx->planes.reserve(max_planes > 0 ? max_planes : 1) &&
+              ctx->prior_planes.reserve(max_planes > 0 ? max_planes : 1) &&
+              // Le nuage de points peut contenir au plus un point par pixel de la carte.
+              ctx->ransac_scratch.point_cloud.reserve(model_pixels) &&
+              ctx->blob_scratch.reserve(model_width, model_height) &&
+              ctx->depth_integral.reserve(model_width, model_height) &&
+              ctx->depth_pyramid.reserve(model_width, model_height);
+    if (ok && camera_pixels > 0) {
+        ok = ctx->mailbox.reserve_all(camera_pixels, camera_pixels / 2, camera_pixels / 2);
+    }
+    if (!ok) {
+        LOGE("pipeline_create : échec d'allocation des tampons");
+        delete ctx;
+        return nullptr;
+    }
+
+    ctx->workers.start(WorkerPool::hardware_threads() < kDefaultThreadCount ? WorkerPool::hardware_threads()
+                                                                            : kDefaultThreadCount);
+
+    LOGD("Contexte de pipeline créé (caméra %dx%d, modèle %dx%d, %d plans max, %d threads)",
+         camera_width, camera_height, model_width, model_height, max_planes,
+         ctx->workers.thread_count());
+    return ctx;
+}
+
+extern "C" void pipeline_destroy(PipelineContext* ctx) {
+    delete ctx;
+}
+
+
+// --- Accès aux tampons ---
+
+extern "C" uint8_t* pipeline_model_input_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->model_input.data() : nullptr;
+}
+
+extern "C" float* pipeline_depth_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->depth_map.data() : nullptr;
+}
+
+extern "C" uint8_t* pipeline_depth_q8_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->depth_q8.data() : nullptr;
+}
+
+extern "C" RansacPlaneResult* pipeline_planes_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->planes.data() : nullptr;
+}
+
+
+// --- Étapes du pipeline sur les tampons du contexte ---
+
+namespace {
+
+// Octets lus dans un plan chroma 4:2:0 : (height + 1) / 2 lignes de (width + 1) / 2
+// échantillons espacés de pixel_stride.
+size_t chroma_bytes(int width, int height, int uv_stride, int uv_pixel_stride) {
+    return static_cast<size_t>(uv_stride) * ((height + 1) / 2 - 1) +
+           static_cast<size_t>(uv_pixel_stride) * ((width + 1) / 2 - 1) + 1;
+}
+
+// Tenseur écrit par le prétraitement : celui de l'interpréteur si un modèle est chargé,
+// sinon model_input (uint8 NHWC) ou input_tensor.
+void* context_input_tensor(PipelineContext* ctx) {
+    if (ctx->model.loaded()) return ctx->model.input_data();
+    return input_format_is_rgb(ctx->input_format) ? static_cast<void*>(ctx->model_input.data())
+                                                  : static_cast<void*>(ctx->input_tensor.data());
+}
+
+// Prétraitement des plans donnés (capacités en octets) vers l'entrée modèle du contexte.
+// v_plane nul : NV12, V entrelacé après U dans uv_plane ; sinon uv_plane est le plan U.
+int preprocess_planes(PipelineContext* ctx, const char* caller,
+                      const uint8_t* y_plane, size_t y_capacity,
+                      const uint8_t* uv_plane, size_t uv_capacity,
+                      const uint8_t* v_plane, size_t v_capacity,
+                      int width, int height, int y_stride, int uv_stride,
+                      int uv_pixel_stride, int rotation) {
+    if (width <= 0 || height <= 0) return 0;
+
+    // Vérifie que les plans copiés tiennent dans les tampons.
+    const size_t y_needed = static_cast<size_t>(y_stride) * (height - 1) + width;
+    const size_t chroma_needed = chroma_bytes(width, height, uv_stride, uv_pixel_stride);
+    const bool interleaved = v_plane == nullptr;
+    if (y_needed > y_capacity || chroma_needed + (interleaved ? 1 : 0) > uv_capacity ||
+        (!interleaved && chroma_needed > v_capacity)) {
+        LOGE("%s : plans caméra plus grands que les tampons du contexte", caller);
+        return 0;
+    }
+
+    void* tensor = context_input_tensor(ctx);
+    if (input_format_is_rgb(ctx->input_format)) {
+        return preprocess_yuv420_to_model_input(y_plane, uv_plane, interleaved ? uv_plane + 1 : v_plane,
+                                                width, height, y_stride, uv_stride, uv_pixel_stride,
+                                                rotation,
+                                                0, 0, 0, 0,
+                                                static_cast<uint8_t*>(tensor),
+                                                ctx->model_width, ctx->model_height);
+    }
+    return preprocess_yuv420_to_tensor(y_plane, uv_plane, interleaved ? uv_plane + 1 : v_plane,
+                                       width, height, y_stride, uv_stride, uv_pixel_stride,
+                                       rotation,
+                                       0, 0, 0, 0,
+                                       &ctx->input_format, tensor,
+                                       ctx->model_width, ctx->model_height);
+}
+
+} // namespace
+
+
+// --- Boîte aux lettres de trames ---
+
+extern "C" int pipeline_mailbox_reserve(PipelineContext* ctx, int y_bytes, int uv_bytes) {
+    if (ctx == nullptr || y_bytes < 0 || uv_bytes < 0) return 0;
+    if (!ctx->mailbox.reserve(static_cast<size_t>(y_bytes), static_cast<size_t>(uv_bytes))) {
+        LOGE("pipeline_mailbox_reserve : échec d'allocation (Y %d, UV %d octets)", y_bytes, uv_bytes);
+        return 0;
+    }
+    return 1;
+}
+
+extern "C" uint8_t* pipeline_mailbox_y_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->mailbox.write_slot().y_plane.data() : nullptr;
+}
+
+extern "C" uint8_t* pipeline_mailbox_uv_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->mailbox.write_slot().uv_plane.data() : nullptr;
+}
+
+extern "C" int pipeline_mailbox_reserve_yuv420(PipelineContext* ctx, int y_bytes, int u_bytes, int v_bytes) {
+    if (ctx == nullptr || y_bytes < 0 || u_bytes < 0 || v_bytes < 0) return 0;
+    if (!ctx->mailbox.reserve(static_cast<size_t>(y_bytes), static_cast<size_t>(u_bytes),
+                              static_cast<size_t>(v_bytes))) {
+        LOGE("pipeline_mailbox_reserve_yuv420 : échec d'allocation (Y %d, U %d, V %d octets)",
+             y_bytes, u_bytes, v_bytes);
+        return 0;
+    }
+    return 1;
+}
+
+extern "C" uint8_t* pipeline_mailbox_v_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->mailbox.write_slot().v_plane.data() : nullptr;
+}
+
+extern "C" int pipeline_mailbox_publish(PipelineContext* ctx,
+                                        int width, int height,
+                                        int y_stride, int uv_stride,
+                                        int64_t timestamp_us) {
+    if (ctx == nullptr || width <= 0 || height <= 0 || y_stride < width || uv_stride < width) return 0;
+    const FrameSlot& slot = ctx->mailbox.write_slot();
+    const size_t y_needed = static_cast<size_t>(y_stride) * (height - 1) + width;
+    const size_t uv_needed = chroma_bytes(width, height, uv_stride, 2) + 1; // Dernier V compris
+    if (y_needed > slot.y_plane.capacity() || uv_needed > slot.uv_plane.capacity()) {
+        LOGE("pipeline_mailbox_publish : trame %dx%d plus grande que les plans réservés", width, height);
+        return 0;
+    }
+
+    FrameInfo info{};
+    info.width = width;
+    info.height = height;
+    info.y_stride = y_stride;
+    info.uv_stride = uv_stride;
+    info.timestamp_us = timestamp_us;
+    info.uv_pixel_stride = 2;
+    info.rotation = 0;
+    info.layout = YUV_LAYOUT_NV12;
+    ctx->mailbox.publish(info);
+    return 1;
+}
+
+extern "C" int pipeline_mailbox_publish_yuv420(PipelineContext* ctx,
+                                               int width, int height,
+                                               int y_stride, int uv_stride, int uv_pixel_stride,
+                                               int rotation,
+                                               int64_t timestamp_us) {
+    if (ctx == nullptr || width <= 0 || height <= 0 || y_stride < width || uv_pixel_stride < 1 ||
+        uv_stride < uv_pixel_stride * ((width + 1) / 2 - 1) + 1 || rotation % 90 != 0) {
+        LOGE("pipeline_mailbox_publish_yuv420 : paramètres invalides (%dx%d, pas chroma %d, rotation %d)",
+             width, height, uv_pixel_stride, rotation);
+        return 0;
+    }
+    const FrameSlot& slot = ctx->mailbox.write_slot();
+    const size_t y_needed = static_cast<size_t>(y_stride) * (height - 1) + width;
+    const size_t chroma_needed = chroma_bytes(width, height, uv_stride, uv_pixel_stride);
+    if (y_needed > slot.y_plane.capacity() || chroma_needed > slot.uv_plane.capacity() ||
+        chroma_needed > slot.v_plane.capacity()) {
+        LOGE("pipeline_mailbox_publish_yuv420 : trame %dx%d plus grande que les plans réservés", width, height);
+        return 0;
+    }
+
+    FrameInfo info{};
+    info.width = width;
+    info.height = height;
+    info.y_stride = y_stride;
+    info.uv_stride = uv_stride;
+    info.timestamp_us = timestamp_us;
+    info.uv_pixel_stride = uv_pixel_stride;
+    info.rotation = ((rotation % 360) + 360) % 360;
+    // Plans U et V copiés à part : I420 (pas 1) ou plans séparés à pas 2.
+    info.layout = yuv420_layout(slot.uv_plane.data(), slot.v_plane.data(), uv_pixel_stride);
+    ctx->mailbox.publish(info);
+    return 1;
+}
+
+extern "C" int pipeline_mailbox_take(PipelineContext* ctx) {
+    return ctx != nullptr && ctx->mailbox.take() ? 1 : 0;
+}
+
+extern "C" int pipeline_preprocess_latest(PipelineContext* ctx) {
+    if (ctx == nullptr) return 0;
+    const FrameSlot& slot = ctx->mailbox.read_slot();
+    if (slot.info.sequence == 0) return 0; // Aucune trame prise
+    const bool interleaved = slot.info.layout == YUV_LAYOUT_NV12;
+    return preprocess_planes(ctx, "pipeline_preprocess_latest",
+                             slot.y_plane.data(), slot.y_plane.capacity(),
+                             slot.uv_plane.data(), slot.uv_plane.capacity(),
+                             interleaved ? nullptr : slot.v_plane.data(), slot.v_plane.capacity(),
+                             slot.info.width, slot.info.height,
+                             slot.info.y_stride, slot.info.uv_stride,
+                             slot.info.uv_pixel_stride, slot.info.rotation);
+}
+
+extern "C" const FrameInfo* pipeline_mailbox_frame_info(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->mailbox.read_slot().info : nullptr;
+}
+
+extern "C" MailboxStats* pipeline_mailbox_stats(PipelineContext* ctx) {
+    if (ctx == nullptr) return nullptr;
+    ctx->mailbox_stats = ctx->mailbox.stats();
+    return &ctx->mailbox_stats;
+}
+
+extern "C" int pipeline_set_depth_format(PipelineContext* ctx, int format, float scale, int zero_point) {
+    if (ctx == nullptr) return 0;
+    if (format != DEPTH_FORMAT_F32 && format != DEPTH_FORMAT_U8 && format != DEPTH_FORMAT_S8) {
+        LOGE("pipeline_set_depth_format : format inconnu (%d)", format);
+        return 0;
+    }
+    ctx->depth_format = format;
+    ctx->depth_scale = scale;
+    ctx->depth_zero_point = zero_point;
+    ctx->filter_primed = false; // Nouvelle quantification : l'estimation repart de la prochaine carte
+    LOGD("Format de la carte de profondeur : %d (scale %f, zero_point %d)", format, scale, zero_point);
+    return 1;
+}
+
+extern "C" int pipeline_set_input_format(PipelineContext* ctx, int type, int layout,
+                                         float mean_r, float mean_g, float mean_b,
+                                         float std_r, float std_g, float std_b) {
+    if (ctx == nullptr) return 0;
+    const InputTensorFormat format{type, layout, {mean_r, mean_g, mean_b}, {std_r, std_g, std_b}};
+    if (!input_format_valid(format)) {
+        LOGE("pipeline_set_input_format : format invalide (type %d, disposition %d)", type, layout);
+        return 0;
+    }
+    // Modèle natif chargé : le tenseur est celui de l'interpréteur, seule la normalisation change.
+    if (ctx->model.loaded() && (type != ctx->input_format.type || layout != ctx->input_format.layout)) {
+        LOGE("pipeline_set_input_format : type %d / disposition %d différents du modèle chargé", type, layout);
+        return 0;
+    }
+    if (!input_format_is_rgb(format) &&
+        !ctx->input_tensor.reserve(input_tensor_size(format, ctx->model_width, ctx->model_height))) {
+        LOGE("pipeline_set_input_format : échec d'allocation du tenseur d'entrée");
+        return 0;
+    }
+    ctx->input_format = format;
+    LOGD("Format du tenseur d'entrée : type %d, disposition %d", type, layout);
+    return 1;
+}
+
+extern "C" void* pipeline_input_tensor_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? context_input_tensor(ctx) : nullptr;
+}
+
+extern "C" int64_t pipeline_input_tensor_bytes(PipelineContext* ctx) {
+    if (ctx == nullptr) return 0;
+    return static_cast<int64_t>(input_tensor_size(ctx->input_format, ctx->model_width, ctx->model_height));
+}
+
+// --- Filtre temporel ---
+
+extern "C" int pipeline_set_temporal_filter(PipelineContext* ctx, int enabled, float alpha, float jump_threshold) {
+    if (ctx == nullptr) return 0;
+    if (enabled != 0 && !(alpha > 0.0f && alpha <= 1.0f)) {
+        LOGE("pipeline_set_temporal_filter : alpha invalide (%f)", alpha);
+        return 0;
+    }
+    ctx->filter_enabled = enabled != 0;
+    ctx->filter_primed = false;
+    ctx->filter_alpha = alpha;
+    ctx->filter_jump = jump_threshold;
+    return 1;
+}
+
+extern "C" int pipeline_filter_depth(PipelineContext* ctx) {
+    if (ctx == nullptr) return 0;
+    if (!ctx->filter_enabled) return 1;
+    const int count = ctx->model_width * ctx->model_height;
+    float* state = ctx->filtered_depth.data();
+    // Première carte : alpha = 1 recopie la mesure (les NaN gardent le 0 initial).
+    float alpha = ctx->filter_alpha;
+    if (!ctx->filter_primed) {
+        for (int i = 0; i < count; ++i) state[i] = 0.0f;
+        alpha = 1.0f;
+    }
+    const int ok = ctx->depth_format != DEPTH_FORMAT_F32
+        ? temporal_filter_depth_q8(state, ctx->depth_q8.data(), count, ctx->depth_format,
+                                   ctx->depth_scale, ctx->depth_zero_point, alpha, ctx->filter_jump)
+        : temporal_filter_depth(state, ctx->depth_map.data(), count, alpha, ctx->filter_jump);
+    ctx->filter_primed = ok != 0;
+    return ok;
+}
+
+extern "C" void pipeline_reset_depth_filter(PipelineContext* ctx) {
+    if (ctx != nullptr) ctx->filter_primed = false;
+}
+
+extern "C" float* pipeline_filtered_depth_buffer(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->filtered_depth.data() : nullptr;
+}
+
+// L'analyse lit-elle l'estimation filtrée plutôt que la carte brute ?
+static bool context_uses_filtered_depth(const PipelineContext* ctx) {
+    return ctx->filter_enabled && ctx->filter_primed;
+}
+
+// Vue sur la carte de profondeur analysée : estimation filtrée, sinon carte brute selon son format.
+static DepthInput context_depth_input(const PipelineContext* ctx) {
+    if (context_uses_filtered_depth(ctx)) return DepthInput::from_f32(ctx->filtered_depth.data());
+    DepthInput depth = DepthInput::from_f32(ctx->depth_map.data());
+    if (ctx->depth_format != DEPTH_FORMAT_F32) {
+        DepthInput::from_q8(ctx->depth_q8.data(), ctx->depth_format,
+                            ctx->depth_scale, ctx->depth_zero_point, depth);
+    }
+    return depth;
+}
+
+extern "C" RansacOptions* pipeline_ransac_options(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->ransac_options : nullptr;
+}
+
+extern "C" RansacStats* pipeline_ransac_stats(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->ransac_stats : nullptr;
+}
+
+extern "C" int pipeline_set_thread_count(PipelineContext* ctx, int thread_count) {
+    if (ctx == nullptr) return 0;
+    return ctx->workers.start(thread_count);
+}
+
+extern "C" int pipeline_detect_walls(PipelineContext* ctx) {
+    if (ctx == nullptr) return 0;
+    const DepthInput depth = context_depth_input(ctx);
+    // Mode grossier -> fin : niveau grossier reconstruit pour la carte courante, dans la
+    // pyramide du contexte (réutilisable ensuite par l'analyse).
+    const int coarse_level = ctx->ransac_options.coarse_level;
+    const DepthPyramid* pyramid = nullptr;
+    if (coarse_level > 0 && coarse_level < DEPTH_PYRAMID_LEVELS &&
+        ctx->depth_pyramid.build(depth, ctx->model_width, ctx->model_height, coarse_level + 1)) {
+        pyramid = &ctx->depth_pyramid;
+    }
+    const int found = ransac_detect_planes(depth, ctx->model_width, ctx->model_height,
+                                           ctx->ransac_options,
+                                           ctx->planes.data(), ctx->max_planes,
+                                           ctx->ransac_scratch, &ctx->ransac_stats, &ctx->workers,
+                                           ctx->prior_planes.data(), ctx->prior_count, pyramid);
+    // Plans gardés pour la trame suivante (aucun plan : la suivante repart des tirages).
+    for (int i = 0; i < found; ++i) ctx->prior_planes.data()[i] = ctx->planes.data()[i];
+    ctx->prior_count = found;
+    return found;
+}
+
+extern "C" void pipeline_reset_warm_start(PipelineContext* ctx) {
+    if (ctx != nullptr) ctx->prior_count = 0;
+}
+
+extern "C" int pipeline_compute_depth_stats(PipelineContext* ctx,
+                                            float free_path_threshold,
+                                            float histogram_max) {
+    if (ctx == nullptr) return 0;
+    if (context_uses_filtered_depth(ctx)) {
+        return compute_depth_stats(ctx->filtered_depth.data(), ctx->model_width, ctx->model_height,
+                                   free_path_threshold, histogram_max, &ctx->depth_stats);
+    }
+    if (ctx->depth_format != DEPTH_FORMAT_F32) {
+        return compute_depth_stats_q8(ctx->depth_q8.data(), ctx->model_width, ctx->model_height,
+                                      ctx->depth_format, ctx->depth_scale, ctx->depth_zero_point,
+                                      free_path_threshold, histogram_max, &ctx->depth_stats);
+    }
+    return compute_depth_stats(ctx->depth_map.data(), ctx->model_width, ctx->model_height,
+                               free_path_threshold, histogram_max, &ctx->depth_stats);
+}
+
+extern "C" DepthStats* pipeline_depth_stats(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->depth_stats : nullptr;
+}
+
+extern "C" int pipeline_build_depth_pyramid(PipelineContext* ctx, int level_count) {
+    if (ctx == nullptr) return 0;
+    return ctx->depth_pyramid.build(context_depth_input(ctx), ctx->model_width, ctx->model_height,
+                                    level_count) ? 1 : 0;
+}
+
+extern "C" float* pipeline_depth_level_buffer(PipelineContext* ctx, int level) {
+    if (ctx == nullptr || level < 1 || level >= ctx->depth_pyramid.built_levels) return nullptr;
+    return ctx->depth_pyramid.levels[level].data();
+}
+
+extern "C" int pipeline_compute_depth_stats_level(PipelineContext* ctx, int level,
+                                                  float free_path_threshold,
+                                                  float histogram_max) {
+    if (ctx == nullptr) return 0;
+    if (level == 0) return pipeline_compute_depth_stats(ctx, free_path_threshold, histogram_max);
+    const float* level_depth = pipeline_depth_level_buffer(ctx, level);
+    if (level_depth == nullptr) {
+        LOGE("pipeline_compute_depth_stats_level : niveau %d non construit.", level);
+        return 0;
+    }
+    return compute_depth_stats(level_depth, ctx->depth_pyramid.widths[level], ctx->depth_pyramid.heights[level],
+                               free_path_threshold, histogram_max, &ctx->depth_stats);
+}
+
+extern "C" int pipeline_compute_polar_obstacles(PipelineContext* ctx) {
+    if (ctx == nullptr) return 0;
+    return polar_obstacles(context_depth_input(ctx), ctx->model_width, ctx->model_height,
+                           ctx->polar_options, ctx->polar_map);
+}
+
+extern "C" PolarObstacleOptions* pipeline_polar_obstacle_options(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->polar_options : nullptr;
+}
+
+extern "C" PolarObstacleMap* pipeline_polar_obstacles(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->polar_map : nullptr;
+}
+
+extern "C" int pipeline_detect_obstacle_blobs(PipelineContext* ctx, float closeness_threshold, int min_area) {
+    if (ctx == nullptr) return 0;
+    return obstacle_blobs(context_depth_input(ctx), ctx->model_width, ctx->model_height,
+                          closeness_threshold, min_area, ctx->obstacle_blobs, OBSTACLE_BLOBS_MAX,
+                          ctx->blob_scratch);
+}
+
+extern "C" ObstacleBlob* pipeline_obstacle_blobs(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->obstacle_blobs : nullptr;
+}
+
+extern "C" int pipeline_build_depth_integral(PipelineContext* ctx, float threshold) {
+    if (ctx == nullptr) return 0;
+    return ctx->depth_integral.build(context_depth_input(ctx), ctx->model_width, ctx->model_height,
+                                     threshold) ? 1 : 0;
+}
+
+extern "C" int pipeline_query_depth_regions(PipelineContext* ctx, int region_count) {
+    if (ctx == nullptr || !ctx->depth_integral.built) return 0;
+    const int count = region_count < 0 ? 0 : (region_count > DEPTH_REGIONS_MAX ? DEPTH_REGIONS_MAX : region_count);
+    for (int i = 0; i < count; ++i) ctx->region_stats[i] = ctx->depth_integral.query(ctx->depth_regions[i]);
+    return count;
+}
+
+extern "C" DepthRegion* pipeline_depth_regions(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->depth_regions : nullptr;
+}
+
+extern "C" RegionStats* pipeline_depth_region_stats(PipelineContext* ctx) {
+    return ctx != nullptr ? ctx->region_stats : nullptr;
+}
+
+
+// --- Traitement de trame complet (interpréteur TFLite natif) ---
+
+extern "C" int pipeline_has_tflite(void) {
+    return TfLiteRunner::available() ? 1 : 0;
+}
+
+extern "C" int pipeline_load_model(PipelineContext* ctx, const char* model_path, int thread_count) {
+    if (ctx == nullptr || model_path == nullptr) return PIPELINE_STATUS_INVALID_ARGUMENT;
+    if (!TfLiteRunner::available()) {
+        LOGE("pipeline_load_model : bibliothèque compilée sans TFLite (NATIVE_WITH_TFLITE=OFF)");
+        return PIPELINE_STATUS_NO_TFLITE;
+    }
+    if (!ctx->model.load(model_path, thread_count)) return PIPELINE_STATUS_MODEL_ERROR;
+
+    // Tenseurs du modèle : mêmes dimensions que le contexte, types supportés, et tailles
+    // égales à celles qu'écrivent le prétraitement et l'analyse.
+    const RunnerInput& input = ctx->model.input();
+    const RunnerOutput& output = ctx->model.output();
+    InputTensorFormat format = ctx->input_format; // Normalisation choisie par l'appelant
+    format.type = input.type;
+    format.layout = input.layout;
+    const size_t model_pixels = static_cast<size_t>(ctx->model_width) * ctx->model_height;
+    const size_t output_bytes = model_pixels * (output.format == DEPTH_FORMAT_F32 ? sizeof(float) : 1);
+    if (!input_format_valid(format) || input.width != ctx->model_width || input.height != ctx->model_height ||
+        input.bytes != input_tensor_size(format, ctx->model_width, ctx->model_height) ||
+        output.format < 0 || output.width != ctx->model_width || output.height != ctx->model_height ||
+        output.bytes != output_bytes) {
+        LOGE("pipeline_load_model : tenseurs incompatibles avec le contexte %dx%d (entrée %dx%d type %d, "
+             "sortie %dx%d format %d)", ctx->model_width, ctx->model_height,
+             input.width, input.height, input.type, output.width, output.height, output.format);
+        ctx->model.reset();
+        return PIPELINE_STATUS_MODEL_MISMATCH;
+    }
+    ctx->input_format = format;
+    pipeline_set_depth_format(ctx, output.format, output.scale, output.zero_point);
+    return PIPELINE_STATUS_OK;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Microsecondes écoulées depuis `start`, qui repart de maintenant.
+int32_t lap_us(Clock::time_point& start) {
+    const Clock::time_point now = Clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+    start = now;
+    return static_cast<int32_t>(elapsed);
+}
+
+// Enchaîne les étapes d'une trame sur les plans donnés (voir preprocess_planes) ; le
+// résultat va dans ctx->frame_result, son statut est renvoyé.
+int process_planes(PipelineContext* ctx, const char* caller,
+                   const uint8_t* y_plane, size_t y_capacity,
+                   const uint8_t* uv_plane, size_t uv_capacity,
+                   const uint8_t* v_plane, size_t v_capacity,
+                   int width, int height, int y_stride, int uv_stride,
+                   int uv_pixel_stride, int rotation, int64_t timestamp_us) {
+    FrameResult& result = ctx->frame_result;
+    result = FrameResult{};
+    result.gap_start = -1;
+    result.gap_end = -1;
+    result.timestamp_us = timestamp_us;
+    if (!ctx->model.loaded()) {
+        result.status = TfLiteRunner::available() ? PIPELINE_STATUS_NO_MODEL : PIPELINE_STATUS_NO_TFLITE;
+        return result.status;
+    }
+
+    // 1. Prétraitement, directement dans le tenseur d'entrée de l'interpréteur.
+    Clock::time_point start = Clock::now();
+    if (preprocess_planes(ctx, caller, y_plane, y_capacity, uv_plane, uv_capacity, v_plane, v_capacity,
+                          width, height, y_stride, uv_stride, uv_pixel_stride, rotation) != 1) {
+        result.status = PIPELINE_STATUS_PREPROCESS_FAILED;
+        return result.status;
+    }
+    result.preprocess_us = lap_us(start);
+
+    // 2. Inférence. La sortie est recopiée dans la carte du contexte (256 Ko au plus) :
+    // filtre temporel, analyse et vues Dart continuent de lire les tampons habituels.
+    if (!ctx->model.invoke()) {
+        LOGE("%s : échec de l'inférence", caller);
+        result.status = PIPELINE_STATUS_INFERENCE_FAILED;
+        return result.status;
+    }
+    const RunnerOutput& output = ctx->model.output();
+    void* depth = output.format == DEPTH_FORMAT_F32 ? static_cast<void*>(ctx->depth_map.data())
+                                                    : static_cast<void*>(ctx->depth_q8.data());
+    std::memcpy(depth, ctx->model.output_data(), output.bytes);
+    result.inference_us = lap_us(start);
+
+    // 3. Analyse : mêmes étapes que DepthAnalyzer, sur la carte filtrée.
+    const FrameProcessOptions& options = ctx->frame_options;
+    pipeline_filter_depth(ctx);
+    if (pipeline_compute_depth_stats(ctx, options.free_path_threshold, options.histogram_max) == 1) {
+        result.max_closeness = ctx->depth_stats.max_closeness;
+    }
+    result.obstacle_count = pipeline_detect_obstacle_blobs(ctx, options.obstacle_threshold,
+                                                           options.obstacle_min_area);
+    if (pipeline_compute_polar_obstacles(ctx) == 1) {
+        result.gap_start = ctx->polar_map.gap_start;
+        result.gap_end = ctx->polar_map.gap_end;
+        result.gap_heading = ctx->polar_map.gap_heading;
+        result.gap_width = ctx->polar_map.gap_width;
+    }
+    result.analysis_us = lap_us(start);
+
+    // 4. Murs.
+    if (options.detect_walls != 0) result.plane_count = pipeline_detect_walls(ctx);
+    result.ransac_us = lap_us(start);
+
+    result.status = PIPELINE_STATUS_OK;
+    return result.status;
+}
+
+} // namespace
+
+extern "C" int pipeline_process_frame(PipelineContext* ctx,
+                                      const uint8_t* y_plane, const uint8_t* u_plane, const uint8_t* v_plane,
+                                      int width, int height, int y_stride, int uv_stride,
+                                      int uv_pixel_stride, int rotation) {
+    if (ctx == nullptr) return PIPELINE_STATUS_INVALID_ARGUMENT;
+    if (y_plane == nullptr || u_plane == nullptr) {
+        ctx->frame_result = FrameResult{};
+        ctx->frame_result.status = PIPELINE_STATUS_INVALID_ARGUMENT;
+        return PIPELINE_STATUS_INVALID_ARGUMENT;
+    }
+    // Plans de l'appelant : leur taille n'est pas connue ici, ils sont supposés complets.
+    const size_t unknown = std::numeric_limits<size_t>::max();
+    return process_planes(ctx, "pipeline_process_frame",
+                          y_plane, unknown, u_plane, unknown, v_plane, unknown,
+                          width, height, y_stride, uv_stride, uv_pixel_stride, rotation, 0);
+}
+
+extern "C" int pipeline_process_latest(PipelineContext* ctx) {
+    if (ctx == nullptr) return PIPELINE_STATUS_INVALID_ARGUMENT;
+    const FrameSlot& slot = ctx->mailbox.read_slot();
+    if (slot.info.sequence == 0) { // Aucune trame prise
+        ctx->frame_result = FrameResult{};
+        ctx->frame_result.status = PIPELINE_STATUS_NO_FRAME;
+        return PIPELINE_STATUS_NO_FRAME;
+    }
+    const bool interleaved = slot.info.layout == YUV_LAYOUT_NV12;
+    return process_planes(ctx, "pipeline_process_latest",
+                          slot.y_plane.data(), slot.y_plane.capacity(),
+                          slot.uv_plane.data(), slot.uv_plane.capacity(),
+                          interleaved ? nullptr : slot.v_plane.data(), slot.v_plane.capacity(),
+                          slot.info.width, slot.info.height,
+                          slot.info.y_stride, slot.info.uv_stride,
+                          slot.info.uv_pixel_stride, slot.info.rotation, slot.info.timestamp_us);
+}
+
+extern "C" FrameProcessOptions* pipeline_frame_options(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->frame_options : nullptr;
+}
+
+extern "C" FrameResult* pipeline_frame_result(PipelineContext* ctx) {
+    return ctx != nullptr ? &ctx->frame_result : nullptr;
+}
@@ -0,0 +1,104 @@
+// android/app/src/main/cpp/pipeline_context.h
+// En-tête interne (C++) : définition du contexte de pipeline.
+// Côté Dart, PipelineContext reste un type opaque (voir image_utils.h).
+
+#ifndef PIPELINE_CONTEXT_H
+#define PIPELINE_CONTEXT_H
+
+#include "depth_integral.h" // Pour DepthIntegral
+#include "frame_mailbox.h"  // Pour FrameMailbox
+#include "image_utils.h"    // Pour RansacPlaneResult et la déclaration opaque
+#include "native_memory.h"  // Pour AlignedBuffer
+#include "obstacle_blobs.h" // Pour BlobScratch
+#include "ransac.h"         // Pour RansacScratch
+#include "tflite_runner.h"  // Pour TfLiteRunner
+#include "worker_pool.h"    // Pour WorkerPool
+
+#include <stdint.h>
+
+// Contexte créé une fois (dimensions caméra et modèle), réutilisé à chaque trame.
+// Il possède tous les tampons de travail du pipeline ; Dart écrit et lit
+// directement dans ces tampons via les pointeurs exposés par FFI.
+struct PipelineContext {
+    // Dimensions de l'entrée du modèle (et de la carte de profondeur en sortie).
+    int model_width = 0;
+    int model_height = 0;
+    int max_planes = 0;
+
+    // Trames déposées par le rappel caméra, prises par la boucle de traitement : seule
+    // copie des plans caméra (capacités agrandies uniquement si le stride change).
+    FrameMailbox mailbox;
+    MailboxStats mailbox_stats{}; // Copie renvoyée par pipeline_mailbox_stats
+
+    // Entrée du modèle : RGB888 HWC, model_width * model_height * 3 octets.
+    AlignedBuffer<uint8_t> model_input;
+
+    // Format du tenseur d'entrée (uint8 NHWC par défaut : model_input lui-même) et,
+    // pour les autres formats, le tenseur écrit par le prétraitement.
+    InputTensorFormat input_format{INPUT_TENSOR_U8, INPUT_TENSOR_NHWC, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+    AlignedBuffer<uint8_t> input_tensor;
+
+    // Carte de profondeur inverse (sortie du modèle), model_width * model_height floats.
+    AlignedBuffer<float> depth_map;
+
+    // Sortie 8 bits quantifiée du modèle, écrite telle quelle (model_width * model_height
+    // octets). Lue à la place de depth_map quand depth_format vaut U8 ou S8.
+    AlignedBuffer<uint8_t> depth_q8;
+    int32_t depth_format = DEPTH_FORMAT_F32;
+    float depth_scale = 1.0f;
+    int32_t depth_zero_point = 0;
+
+    // Filtre temporel : estimation par pixel (model_width * model_height floats),
+    // lue à la place de la carte brute une fois initialisée (filter_primed).
+    AlignedBuffer<float> filtered_depth;
+    bool filter_enabled = false;
+    bool filter_primed = false;
+    float filter_alpha = 1.0f;
+    float filter_jump = 0.0f;
+
+    // Résultats RANSAC (max_planes entrées).
+    AlignedBuffer<RansacPlaneResult> planes;
+    // Copie des plans de l'appel précédent, pour la reprise temporelle.
+    AlignedBuffer<RansacPlaneResult> prior_planes;
+    int prior_count = 0;
+
+    // Options, statistiques et mémoire de travail (nuage de points) de RANSAC.
+    RansacOptions ransac_options{};
+    RansacStats ransac_stats{};
+    RansacScratch ransac_scratch;
+
+    // Threads de calcul, créés avec le contexte (pipeline_set_thread_count pour changer).
+    WorkerPool workers;
+
+    // Statistiques de la dernière carte de profondeur (pipeline_compute_depth_stats).
+    DepthStats depth_stats{};
+
+    // Options et résultat de la carte polaire d'obstacles (pipeline_compute_polar_obstacles).
+    PolarObstacleOptions polar_options{};
+    PolarObstacleMap polar_map{};
+
+    // Composantes d'obstacles (OBSTACLE_BLOBS_MAX) et mémoire de travail de la segmentation.
+    ObstacleBlob obstacle_blobs[OBSTACLE_BLOBS_MAX]{};
+    BlobScratch blob_scratch;
+
+    // Tables cumulées de la dernière carte (pipeline_build_depth_integral), rectangles
+    // demandés et leurs statistiques (DEPTH_REGIONS_MAX chacun).
+    DepthIntegral depth_integral;
+    DepthRegion depth_regions[DEPTH_REGIONS_MAX]{};
+    RegionStats region_stats[DEPTH_REGIONS_MAX]{};
+
+    // Pyramide de la carte analysée (pipeline_build_depth_pyramid, ou pipeline_detect_walls
+    // en mode grossier -> fin).
+    DepthPyramid depth_pyramid;
+
+    // Interpréteur TFLite (pipeline_load_model) : chargé, son tenseur d'entrée remplace
+    // model_input / input_tensor comme destination du prétraitement.
+    TfLiteRunner model;
+
+    // Seuils et résultat du traitement de trame complet (pipeline_process_frame) ;
+    // seuils par défaut = ceux de DepthAnalyzer.
+    FrameProcessOptions frame_options{0.25f, 1.0f, 0.75f, 32, 1};
+    FrameResult frame_result{};
+};
+
+#endif // PIPELINE_CONTEXT_H
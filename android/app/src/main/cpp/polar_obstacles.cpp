@@ -0,0 +1,270 @@
+// android/app/src/main/cpp/polar_obstacles.cpp
+
+#include "polar_obstacles.h"
+#include "image_utils.h" // Pour les déclarations exportées
+#include "depth_input.h" // Table de déquantification de la sortie 8 bits
+
+#include <cmath>         // Pour atan, tan, ceil
+#include <stdint.h>
+#include <string.h>      // Pour memset
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Outils internes ---
+
+namespace {
+
+// Colonnes traitées par blocs : les accumulateurs d'un bloc (max et compte par colonne)
+// tiennent sur la pile, et chaque ligne du bloc est lue en continu.
+constexpr size_t kBlockSize = 256;
+
+// Paramètres par défaut (unités de la carte, comme RansacOptions.distance_threshold).
+constexpr float kDefaultObstacleRange = 1.5f;
+constexpr float kDefaultMinHeight = -1.0f;  // Sous la caméra : le sol commence plus bas
+constexpr float kDefaultMaxHeight = 1.0f;   // Au-dessus : plafond, panneaux hors de portée
+constexpr int32_t kDefaultMinObstaclePixels = 8;
+constexpr float kDefaultMinGapWidth = 0.2f; // ~11° : un passage à l'épaule à 2-3 m
+
+// Paramètres de la passe sur les pixels, communs à toute la carte.
+struct PixelTest {
+    float min_closeness;  // 1 / obstacle_range : plus proche = profondeur inverse plus grande
+    float min_height, max_height;
+    bool height_filter;
+};
+
+// Accumule une ligne de `count` colonnes : pour chaque pixel obstacle, max de la
+// profondeur inverse (le plus proche) et compte, par colonne.
+// Un pixel x (profondeur inverse) de la ligne de rayon vertical ry est un obstacle si
+// x > min_closeness et min_height <= ry / x <= max_height ; comme x > 0, la bande de
+// hauteur s'écrit min_height * x <= ry <= max_height * x (pas de division).
+// Les NaN échouent à la première comparaison : jamais obstacles.
+void accumulate_row(const float* values, size_t count, float ry, const PixelTest& test,
+                    float* column_max, int32_t* column_count) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    {
+        const __m128 vmin = _mm_set1_ps(test.min_closeness);
+        const __m128 vlow = _mm_set1_ps(test.min_height);
+        const __m128 vhigh = _mm_set1_ps(test.max_height);
+        const __m128 vry = _mm_set1_ps(ry);
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_loadu_ps(values + i);
+            __m128 obstacle = _mm_cmpgt_ps(x, vmin);
+            if (test.height_filter) {
+                obstacle = _mm_and_ps(obstacle, _mm_cmpge_ps(vry, _mm_mul_ps(vlow, x)));
+                obstacle = _mm_and_ps(obstacle, _mm_cmple_ps(vry, _mm_mul_ps(vhigh, x)));
+            }
+            // Hors obstacle : 0, neutre pour le max (les valeurs retenues sont > 0).
+            const __m128 closeness = _mm_and_ps(obstacle, x);
+            _mm_storeu_ps(column_max + i, _mm_max_ps(_mm_loadu_ps(column_max + i), closeness));
+            __m128i* counts = reinterpret_cast<__m128i*>(column_count + i);
+            _mm_storeu_si128(counts, _mm_sub_epi32(_mm_loadu_si128(counts), _mm_castps_si128(obstacle)));
+        }
+    }
+#elif defined(__aarch64__)
+    {
+        const float32x4_t vmin = vdupq_n_f32(test.min_closeness);
+        const float32x4_t vlow = vdupq_n_f32(test.min_height);
+        const float32x4_t vhigh = vdupq_n_f32(test.max_height);
+        const float32x4_t vry = vdupq_n_f32(ry);
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t x = vld1q_f32(values + i);
+            uint32x4_t obstacle = vcgtq_f32(x, vmin);
+            if (test.height_filter) {
+                obstacle = vandq_u32(obstacle, vcgeq_f32(vry, vmulq_f32(vlow, x)));
+                obstacle = vandq_u32(obstacle, vcleq_f32(vry, vmulq_f32(vhigh, x)));
+            }
+            const float32x4_t closeness = vreinterpretq_f32_u32(vandq_u32(obstacle, vreinterpretq_u32_f32(x)));
+            vst1q_f32(column_max + i, vmaxq_f32(vld1q_f32(column_max + i), closeness));
+            vst1q_s32(column_count + i, vsubq_s32(vld1q_s32(column_count + i), vreinterpretq_s32_u32(obstacle)));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = values[i];
+        bool obstacle = x > test.min_closeness;
+        if (test.height_filter) {
+            obstacle = obstacle && ry >= test.min_height * x && ry <= test.max_height * x;
+        }
+        if (obstacle) {
+            column_max[i] = x > column_max[i] ? x : column_max[i];
+            column_count[i]++;
+        }
+    }
+}
+
+// Plus large suite de secteurs libres ; à largeur égale, celle dont le centre est le
+// plus proche de l'axe (cap 0). Remplit gap_* de `map` (-1 si aucune assez large).
+void find_widest_gap(float bin_width, float min_gap_width, PolarObstacleMap& map) {
+    map.gap_start = map.gap_end = -1;
+    map.gap_heading = map.gap_width = 0.0f;
+
+    int best_length = 0;
+    float best_offset = 0.0f;
+    int start = 0;
+    for (int b = 0; b <= POLAR_OBSTACLE_BINS; ++b) {
+        const bool blocked = b == POLAR_OBSTACLE_BINS || (map.blocked_mask >> b) & 1u;
+        if (!blocked) continue;
+        const int length = b - start;
+        if (length > 0) {
+            const float center = map.heading_min + 0.5f * static_cast<float>(start + b) * bin_width;
+            const float offset = std::fabs(center);
+            if (length > best_length || (length == best_length && offset < best_offset)) {
+                best_length = length;
+                best_offset = offset;
+                map.gap_start = start;
+                map.gap_end = b - 1;
+                map.gap_heading = center;
+            }
+        }
+        start = b + 1;
+    }
+
+    map.gap_width = static_cast<float>(best_length) * bin_width;
+    if (best_length == 0 || map.gap_width < min_gap_width) {
+        map.gap_start = map.gap_end = -1;
+        map.gap_heading = map.gap_width = 0.0f;
+    }
+}
+
+} // namespace
+
+
+// --- Implémentation ---
+
+extern "C" void polar_obstacle_default_options(PolarObstacleOptions* out_options) {
+    if (out_options == nullptr) return;
+    PolarObstacleOptions options{};
+    // Intrinsèques : à renseigner par l'appelant (calibration), aucune valeur par défaut sûre.
+    options.fx = 0.0f;
+    options.fy = 0.0f;
+    options.cx = 0.0f;
+    options.cy = 0.0f;
+    options.obstacle_range = kDefaultObstacleRange;
+    options.min_height = kDefaultMinHeight;
+    options.max_height = kDefaultMaxHeight;
+    options.min_obstacle_pixels = kDefaultMinObstaclePixels;
+    options.min_gap_width = kDefaultMinGapWidth;
+    *out_options = options;
+}
+
+int polar_obstacles(const DepthInput& depth, int width, int height,
+                    const PolarObstacleOptions& options, PolarObstacleMap& out_map) {
+    if (!depth.valid() || width < POLAR_OBSTACLE_BINS || height <= 0 ||
+        !(options.fx > 0.0f) || !(options.fy > 0.0f) || !(options.obstacle_range > 0.0f)) {
+        LOGE("compute_polar_obstacles : carte, intrinsèques ou portée invalides (%dx%d).", width, height);
+        return 0;
+    }
+
+    PolarObstacleMap map;
+    memset(&map, 0, sizeof(map));
+
+    // Secteurs de cap égaux sur le champ couvert par les colonnes [-0.5, width - 0.5].
+    // La colonne u (cap atan((u - cx) / fx)) appartient au secteur b si son cap est dans
+    // [bord b, bord b+1[, soit u >= cx + fx * tan(bord b) : bornes de colonnes par secteur.
+    map.heading_min = std::atan((-0.5f - options.cx) / options.fx);
+    map.heading_max = std::atan((static_cast<float>(width) - 0.5f - options.cx) / options.fx);
+    const float bin_width = (map.heading_max - map.heading_min) / static_cast<float>(POLAR_OBSTACLE_BINS);
+    int first_column[POLAR_OBSTACLE_BINS + 1];
+    first_column[0] = 0;
+    first_column[POLAR_OBSTACLE_BINS] = width;
+    for (int b = 1; b < POLAR_OBSTACLE_BINS; ++b) {
+        const float edge = map.heading_min + static_cast<float>(b) * bin_width;
+        const int u = static_cast<int>(std::ceil(options.cx + options.fx * std::tan(edge)));
+        first_column[b] = u < first_column[b - 1] ? first_column[b - 1] : (u > width ? width : u);
+    }
+
+    PixelTest test;
+    test.min_closeness = 1.0f / options.obstacle_range;
+    test.min_height = options.min_height;
+    test.max_height = options.max_height;
+    test.height_filter = options.min_height < options.max_height;
+
+    // Rayons verticaux (Y vers le haut, comme RANSAC) : un par ligne, calculé une fois.
+    // Une passe par bloc de colonnes : accumulateurs par colonne, puis réduction par secteur.
+    float column_max[kBlockSize];
+    int32_t column_count[kBlockSize];
+    float block[kBlockSize];
+    float bin_closeness[POLAR_OBSTACLE_BINS] = {};
+    for (size_t start = 0; start < static_cast<size_t>(width); start += kBlockSize) {
+        const size_t n = static_cast<size_t>(width) - start < kBlockSize ? static_cast<size_t>(width) - start : kBlockSize;
+        for (size_t i = 0; i < n; ++i) { column_max[i] = 0.0f; column_count[i] = 0; }
+
+        for (int v = 0; v < height; ++v) {
+            const float ry = -(static_cast<float>(v) - options.cy) / options.fy;
+            const size_t offset = static_cast<size_t>(v) * width + start;
+            const float* values = depth.f32 + offset;
+            if (depth.q8 != nullptr) { // Déquantification du segment de ligne via la table
+                for (size_t i = 0; i < n; ++i) block[i] = depth.lut[depth.q8[offset + i]];
+                values = block;
+            }
+            accumulate_row(values, n, ry, test, column_max, column_count);
+        }
+
+        // Colonnes du bloc -> secteurs (un secteur peut chevaucher deux blocs).
+        int b = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const int u = static_cast<int>(start + i);
+            while (b + 1 < POLAR_OBSTACLE_BINS && u >= first_column[b + 1]) ++b;
+            bin_closeness[b] = column_max[i] > bin_closeness[b] ? column_max[i] : bin_closeness[b];
+            map.obstacle_pixels[b] += column_count[i];
+        }
+    }
+
+    // Un secteur sans colonne (champ très large, peu de colonnes) reprend la colonne
+    // de son centre : aucun secteur n'est libre par défaut d'observation.
+    for (int b = 0; b < POLAR_OBSTACLE_BINS; ++b) {
+        if (first_column[b] < first_column[b + 1]) continue;
+        const float center = map.heading_min + (static_cast<float>(b) + 0.5f) * bin_width;
+        int u = static_cast<int>(options.cx + options.fx * std::tan(center) + 0.5f);
+        u = u < 0 ? 0 : (u >= width ? width - 1 : u);
+        for (int other = 0; other < POLAR_OBSTACLE_BINS; ++other) {
+            if (u >= first_column[other] && u < first_column[other + 1]) {
+                bin_closeness[b] = bin_closeness[other];
+                map.obstacle_pixels[b] = map.obstacle_pixels[other];
+                break;
+            }
+        }
+    }
+
+    for (int b = 0; b < POLAR_OBSTACLE_BINS; ++b) {
+        map.nearest[b] = bin_closeness[b] > 0.0f ? 1.0f / bin_closeness[b] : 0.0f;
+        if (map.obstacle_pixels[b] >= options.min_obstacle_pixels && map.obstacle_pixels[b] > 0) {
+            map.blocked_mask |= 1u << b;
+        }
+    }
+    find_widest_gap(bin_width, options.min_gap_width, map);
+
+    out_map = map;
+    return 1;
+}
+
+extern "C" int compute_polar_obstacles(const float* depth_map_data,
+                                       int width, int height,
+                                       const PolarObstacleOptions* options,
+                                       PolarObstacleMap* out_map) {
+    if (depth_map_data == nullptr || options == nullptr || out_map == nullptr) return 0;
+    return polar_obstacles(DepthInput::from_f32(depth_map_data), width, height, *options, *out_map);
+}
+
+extern "C" int compute_polar_obstacles_q8(const uint8_t* depth_q8,
+                                          int width, int height,
+                                          int format, float scale, int zero_point,
+                                          const PolarObstacleOptions* options,
+                                          PolarObstacleMap* out_map) {
+    DepthInput depth;
+    if (depth_q8 == nullptr || options == nullptr || out_map == nullptr ||
+        !DepthInput::from_q8(depth_q8, format, scale, zero_point, depth)) {
+        return 0;
+    }
+    return polar_obstacles(depth, width, height, *options, *out_map);
+}
@@ -0,0 +1,15 @@
+// android/app/src/main/cpp/polar_obstacles.h
+// En-tête interne (C++) : cœur de la carte polaire d'obstacles, partagé avec le contexte.
+
+#ifndef POLAR_OBSTACLES_H
+#define POLAR_OBSTACLES_H
+
+#include "image_utils.h" // Pour PolarObstacleOptions et PolarObstacleMap
+#include "depth_input.h" // Pour DepthInput
+
+// Cœur de compute_polar_obstacles[_q8] et de pipeline_compute_polar_obstacles.
+// Retourne 1 si succès, 0 si les paramètres sont invalides.
+int polar_obstacles(const DepthInput& depth, int width, int height,
+                    const PolarObstacleOptions& options, PolarObstacleMap& out_map);
+
+#endif // POLAR_OBSTACLES_H
@@ -0,0 +1,24 @@
+// android/app/src/main/cpp/process_memory.cpp
+// Mémoire résidente du processus (/proc/self/status), pour mesurer le démarrage.
+
+#include "image_utils.h" // API C exportée
+
+#include <stdio.h>
+#include <string.h>
+
+extern "C" int read_process_memory(ProcessMemory* out) {
+    if (out == nullptr) return 0;
+    FILE* status = fopen("/proc/self/status", "r");
+    if (status == nullptr) return 0;
+    out->rss_kb = -1;
+    out->peak_rss_kb = -1;
+    char line[128];
+    long long value = 0;
+    while (fgets(line, sizeof(line), status) != nullptr) {
+        // Lignes « VmHWM:    123456 kB » (pic) et « VmRSS:    123456 kB » (actuelle).
+        if (sscanf(line, "VmHWM: %lld", &value) == 1) out->peak_rss_kb = value;
+        else if (sscanf(line, "VmRSS: %lld", &value) == 1) out->rss_kb = value;
+    }
+    fclose(status);
+    return out->rss_kb >= 0 && out->peak_rss_kb >= 0 ? 1 : 0;
+}
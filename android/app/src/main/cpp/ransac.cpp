@@ -1,27 +1,742 @@
 /// android/app/src/main/cpp/ransac.cpp
 
 #include "image_utils.h" // Contient la déclaration de la fonction et RansacPlaneResult
-#include <vector>        // Pour std::vector (stocker les points 3D)
+#include "ransac.h"      // Point3D, PointCloudSoA, RansacScratch et le cœur ransac_detect_planes
+#include "ransac_kernels.h" // Noyau vectoriel de comptage d'inliers
+#include "depth_input.h"    // Carte de profondeur float ou 8 bits quantifiée
+#include "worker_pool.h"    // Score parallèle des hypothèses
 #include <cmath>         // Pour sqrt, fabs (valeur absolue float)
-#include <random>        // Pour la génération de nombres aléatoires (mt19937, uniform_int_distribution)
-#include <limits>        // Pour std::numeric_limits
-#include <stdexcept>     // Pour std::runtime_error (gestion d'erreurs potentielles)
+#include <atomic>        // Pour le compteur des graines automatiques
+#include <chrono>        // Pour la graine automatique (horloge)
+#include <stdint.h>      // Pour int64_t (budget d'évaluations), uint64_t (générateur)
 
-// Pour le logging Android
-#include <android/log.h>
-#define LOG_TAG "NativeLib"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__) // Warning
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
 
 
-// Structure simple pour représenter un point 3D
-struct Point3D {
-    float x, y, z;
+// --- Outils internes de RANSAC ---
+
+namespace {
+
+// Plan candidat Ax + By + Cz + D = 0, avec (A, B, C) normalisé.
+struct PlaneHypothesis {
+    float a = 0, b = 0, c = 0, d = 0;
+};
+
+// Calcule le plan passant par p1, p2, p3.
+// Retourne false si les points sont dégénérés (colinéaires ou confondus).
+bool plane_from_points(const Point3D& p1, const Point3D& p2, const Point3D& p3,
+                       PlaneHypothesis& out) {
+    // Vecteur v1 = p2 - p1
+    float v1x = p2.x - p1.x;
+    float v1y = p2.y - p1.y;
+    float v1z = p2.z - p1.z;
+    // Vecteur v2 = p3 - p1
+    float v2x = p3.x - p1.x;
+    float v2y = p3.y - p1.y;
+    float v2z = p3.z - p1.z;
+
+    // Calculer la normale N = v1 x v2 (produit vectoriel)
+    float A = v1y * v2z - v1z * v2y;
+    float B = v1z * v2x - v1x * v2z;
+    float C = v1x * v2y - v1y * v2x;
+
+    // Normaliser le vecteur normal (A, B, C) pour que les calculs de distance soient corrects
+    float magnitude = sqrt(A * A + B * B + C * C);
+    if (magnitude < 1e-6) { // Éviter division par zéro / points colinéaires
+        return false;
+    }
+    out.a = A / magnitude;
+    out.b = B / magnitude;
+    out.c = C / magnitude;
+
+    // Calculer D: D = -(A*p1.x + B*p1.y + C*p1.z)
+    out.d = -(out.a * p1.x + out.b * p1.y + out.c * p1.z);
+    return true;
+}
+
+// Espace profondeur inverse : les points sont (u, v, inv) et le plan candidat est la
+// fonction affine inv = alpha*u + beta*v + gamma, rangée en (alpha, beta, -1, gamma) :
+// a*u + b*v + c*inv + d est alors l'écart de profondeur inverse, et le même noyau de
+// comptage sert aux deux espaces. Retourne false si les pixels sont alignés.
+bool affine_from_points(const Point3D& p1, const Point3D& p2, const Point3D& p3,
+                        PlaneHypothesis& out) {
+    const float v1x = p2.x - p1.x, v1y = p2.y - p1.y, v1z = p2.z - p1.z;
+    const float v2x = p3.x - p1.x, v2y = p3.y - p1.y, v2z = p3.z - p1.z;
+    const float A = v1y * v2z - v1z * v2y;
+    const float B = v1z * v2x - v1x * v2z;
+    const float C = v1x * v2y - v1y * v2x; // Double de l'aire du triangle (u, v) : entier
+    if (std::fabs(C) < 0.5f) return false;
+    out.a = -A / C;
+    out.b = -B / C;
+    out.c = -1.0f;
+    out.d = p1.z - out.a * p1.x - out.b * p1.y;
+    return true;
+}
+
+// Distance perpendiculaire |Ax + By + Cz + D| : le vecteur normal (A,B,C)
+// est déjà normalisé (magnitude=1), inutile de diviser par sa norme.
+// Même ordre d'opérations que les noyaux de ransac_kernels.cpp : la compaction
+// retire exactement les points comptés comme inliers.
+inline bool is_inlier(float x, float y, float z, const PlaneHypothesis& plane, float threshold) {
+    return std::fabs(plane.a * x + plane.b * y + plane.c * z + plane.d) < threshold;
+}
+
+// Moments d'ordre 1 et 2 d'un ensemble de points, accumulés en double en une passe.
+struct PlaneMoments {
+    double n = 0.0;
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    double sxx = 0.0, sxy = 0.0, sxz = 0.0, syy = 0.0, syz = 0.0, szz = 0.0;
+
+    void add(double x, double y, double z) {
+        n += 1.0;
+        sx += x; sy += y; sz += z;
+        sxx += x * x; sxy += x * y; sxz += x * z;
+        syy += y * y; syz += y * z; szz += z * z;
+    }
+};
+
+// Compaction en place : déplace les outliers au début des tableaux (ordre conservé)
+// et retourne leur nombre. Les recherches suivantes ne parcourent plus que ces points.
+// Si `moments` n'est pas nul, les inliers y sont accumulés dans la même passe.
+size_t remove_inliers(PointCloudSoA& cloud, size_t count, const PlaneHypothesis& plane, float threshold,
+                      PlaneMoments* moments = nullptr) {
+    float* xs = cloud.x.data();
+    float* ys = cloud.y.data();
+    float* zs = cloud.z.data();
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!is_inlier(xs[i], ys[i], zs[i], plane, threshold)) {
+            xs[kept] = xs[i];
+            ys[kept] = ys[i];
+            zs[kept] = zs[i];
+            ++kept;
+        } else if (moments != nullptr) {
+            moments->add(xs[i], ys[i], zs[i]);
+        }
+    }
+    return kept;
+}
+
+// Balayages max de Jacobi : la convergence est quadratique, 3 à 5 suffisent en 3x3.
+constexpr int kJacobiMaxSweeps = 16;
+
+// Plus petite valeur propre de la matrice symétrique 3x3 `m` et vecteur propre unitaire
+// associé, par la méthode de Jacobi cyclique (rotations annulant les termes hors
+// diagonale). Uniquement +, *, / et sqrt : résultat déterministe d'une plateforme à l'autre.
+void smallest_eigenvector(double m[3][3], double& eigenvalue, double vec[3]) {
+    double v[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    static const int kPairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+
+    for (int sweep = 0; sweep < kJacobiMaxSweeps; ++sweep) {
+        const double off = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+        const double diag = m[0][0] * m[0][0] + m[1][1] * m[1][1] + m[2][2] * m[2][2];
+        if (off <= 1e-30 * diag || off == 0.0) break;
+
+        for (const auto& pair : kPairs) {
+            const int p = pair[0], q = pair[1];
+            if (m[p][q] == 0.0) continue;
+            // Rotation J (c, s) telle que (J^T m J)[p][q] = 0
+            const double theta = (m[q][q] - m[p][p]) / (2.0 * m[p][q]);
+            const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+            const double c = 1.0 / std::sqrt(t * t + 1.0);
+            const double s = t * c;
+            for (int k = 0; k < 3; ++k) { // m <- m J (colonnes p, q)
+                const double mkp = m[k][p], mkq = m[k][q];
+                m[k][p] = c * mkp - s * mkq;
+                m[k][q] = s * mkp + c * mkq;
+            }
+            for (int k = 0; k < 3; ++k) { // m <- J^T m (lignes p, q)
+                const double mpk = m[p][k], mqk = m[q][k];
+                m[p][k] = c * mpk - s * mqk;
+                m[q][k] = s * mpk + c * mqk;
+            }
+            for (int k = 0; k < 3; ++k) { // v <- v J : colonnes = vecteurs propres
+                const double vkp = v[k][p], vkq = v[k][q];
+                v[k][p] = c * vkp - s * vkq;
+                v[k][q] = s * vkp + c * vkq;
+            }
+        }
+    }
+
+    int smallest = 0;
+    if (m[1][1] < m[smallest][smallest]) smallest = 1;
+    if (m[2][2] < m[smallest][smallest]) smallest = 2;
+    eigenvalue = m[smallest][smallest];
+    for (int k = 0; k < 3; ++k) vec[k] = v[k][smallest];
+}
+
+// Écrit un plan dans le tampon de résultats. Si `moments` est fourni (au moins 3
+// points), le plan est réajusté par moindres carrés sur ces points : la normale est
+// le vecteur propre de la plus petite valeur propre de leur covariance, le plan
+// passe par leur centroïde, et cette valeur propre est le carré de l'écart RMS.
+// La normale garde l'orientation de `plane` (même convention de signe pour Dart).
+void write_plane_result(const PlaneHypothesis& plane, int inlier_count, size_t cloud_size,
+                        const PlaneMoments* moments, RansacPlaneResult& out) {
+    out.a = plane.a;
+    out.b = plane.b;
+    out.c = plane.c;
+    out.d = plane.d;
+    out.inlier_count = static_cast<int32_t>(inlier_count); // Cast en int32_t
+    out.inlier_ratio = cloud_size > 0 ? static_cast<float>(inlier_count) / static_cast<float>(cloud_size) : 0.0f;
+    out.centroid_x = out.centroid_y = out.centroid_z = 0.0f;
+    out.rms = 0.0f;
+    if (moments == nullptr || moments->n < 3.0) return;
+
+    const double inv_n = 1.0 / moments->n;
+    const double mx = moments->sx * inv_n;
+    const double my = moments->sy * inv_n;
+    const double mz = moments->sz * inv_n;
+    double cov[3][3];
+    cov[0][0] = moments->sxx * inv_n - mx * mx;
+    cov[0][1] = cov[1][0] = moments->sxy * inv_n - mx * my;
+    cov[0][2] = cov[2][0] = moments->sxz * inv_n - mx * mz;
+    cov[1][1] = moments->syy * inv_n - my * my;
+    cov[1][2] = cov[2][1] = moments->syz * inv_n - my * mz;
+    cov[2][2] = moments->szz * inv_n - mz * mz;
+
+    double eigenvalue = 0.0;
+    double normal[3];
+    smallest_eigenvector(cov, eigenvalue, normal);
+    if (normal[0] * plane.a + normal[1] * plane.b + normal[2] * plane.c < 0.0) {
+        normal[0] = -normal[0];
+        normal[1] = -normal[1];
+        normal[2] = -normal[2];
+    }
+
+    out.a = static_cast<float>(normal[0]);
+    out.b = static_cast<float>(normal[1]);
+    out.c = static_cast<float>(normal[2]);
+    out.d = static_cast<float>(-(normal[0] * mx + normal[1] * my + normal[2] * mz));
+    out.centroid_x = static_cast<float>(mx);
+    out.centroid_y = static_cast<float>(my);
+    out.centroid_z = static_cast<float>(mz);
+    out.rms = static_cast<float>(std::sqrt(eigenvalue > 0.0 ? eigenvalue : 0.0));
+}
+
+// Profondeur inverse minimale d'un pixel retenu : en dessous, pixel invalide ou trop
+// lointain selon le modèle MiDaS (seuil arbitraire, à ajuster si nécessaire).
+constexpr float kMinInverseDepth = 0.01f;
+
+// Pixels de la carte à déprojeter : rectangle [x0, x1) x [y0, y1) borné à l'image,
+// parcouru avec un pas `stride` dans les deux directions.
+struct SamplingGrid {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    int stride = 1;
+
+    size_t columns() const { return x1 > x0 ? static_cast<size_t>((x1 - x0 + stride - 1) / stride) : 0; }
+    size_t rows() const { return y1 > y0 ? static_cast<size_t>((y1 - y0 + stride - 1) / stride) : 0; }
+    size_t samples() const { return columns() * rows(); }
+};
+
+inline int clamp_int(int value, int lo, int hi) {
+    return value < lo ? lo : (value > hi ? hi : value);
+}
+
+// Construit la grille d'échantillonnage à partir de la ROI, du pas et de max_points.
+SamplingGrid make_sampling_grid(int width, int height, const RansacOptions& options) {
+    SamplingGrid grid;
+    grid.x0 = clamp_int(options.roi_x, 0, width);
+    grid.y0 = clamp_int(options.roi_y, 0, height);
+    grid.x1 = options.roi_w > 0 ? clamp_int(grid.x0 + options.roi_w, grid.x0, width) : width;
+    grid.y1 = options.roi_h > 0 ? clamp_int(grid.y0 + options.roi_h, grid.y0, height) : height;
+    grid.stride = options.pixel_stride > 1 ? options.pixel_stride : 1;
+    if (options.max_points > 0) {
+        while (grid.samples() > static_cast<size_t>(options.max_points)) ++grid.stride;
+    }
+    return grid;
+}
+
+// Déprojette les pixels de la grille en points 3D (voir conventions dans ransac_detect_planes).
+// Passe sans division pour la carte 8 bits (profondeur Z lue dans une table de 256
+// valeurs), une seule division par point pour la carte float ; X et Y sont des
+// produits avec les tables de rayons. La capacité du nuage doit couvrir grid.samples().
+void back_project(const DepthInput& depth, int width, const SamplingGrid& grid,
+                  const RayTable& rays, PointCloudSoA& point_cloud) {
+    point_cloud.clear();
+    const float* ray_x = rays.ray_x.data();
+    const float* ray_y = rays.ray_y.data();
+
+    if (depth.q8 != nullptr) {
+        // Z = 1 / inv_d pour chaque octet possible ; 0 marque un pixel ignoré.
+        float depth_lut[256];
+        for (int byte = 0; byte < 256; ++byte) {
+            const float inv_d = depth.lut[byte];
+            depth_lut[byte] = inv_d > kMinInverseDepth ? 1.0f / inv_d : 0.0f;
+        }
+        for (int v = grid.y0; v < grid.y1; v += grid.stride) {
+            const uint8_t* row = depth.q8 + static_cast<size_t>(v) * width;
+            const float ry = ray_y[v];
+            for (int u = grid.x0; u < grid.x1; u += grid.stride) {
+                const float Z = depth_lut[row[u]];
+                if (Z > 0.0f) point_cloud.push_back(ray_x[u] * Z, ry * Z, Z);
+            }
+        }
+        return;
+    }
+
+    for (int v = grid.y0; v < grid.y1; v += grid.stride) { // v = coordonnée y de l'image (row)
+        const float* row = depth.f32 + static_cast<size_t>(v) * width;
+        const float ry = ray_y[v];
+        for (int u = grid.x0; u < grid.x1; u += grid.stride) { // u = coordonnée x de l'image (col)
+            // depth est la profondeur INVERSE relative (plus haut = plus proche)
+            const float inv_d = row[u];
+            if (inv_d > kMinInverseDepth) {
+                const float Z = 1.0f / inv_d;
+                point_cloud.push_back(ray_x[u] * Z, ry * Z, Z);
+            }
+        }
+    }
+}
+
+// Espace profondeur inverse : relève les pixels de la grille tels quels, en points
+// (u, v, inv), dans l'ordre de balayage. Ni division ni multiplication.
+void gather_inverse_depth(const DepthInput& depth, int width, const SamplingGrid& grid,
+                          PointCloudSoA& point_cloud) {
+    point_cloud.clear();
+    for (int v = grid.y0; v < grid.y1; v += grid.stride) {
+        const size_t row = static_cast<size_t>(v) * width;
+        for (int u = grid.x0; u < grid.x1; u += grid.stride) {
+            const float inv_d = depth.at(row + u);
+            if (inv_d > kMinInverseDepth) {
+                point_cloud.push_back(static_cast<float>(u), static_cast<float>(v), inv_d);
+            }
+        }
+    }
+}
+
+// Plan métrique a*X + b*Y + c*Z + d = 0 -> fonction affine de l'image (espace
+// profondeur inverse). En substituant X = (u - cx) / fx * Z et Y = -(v - cy) / fy * Z :
+// 1/Z = -(a/fx) / d * u + (b/fy) / d * v + (a*cx/fx - b*cy/fy - c) / d.
+// Retourne false si le plan passe par le centre optique (d = 0 : pas de fonction affine).
+bool metric_to_affine(const RansacPlaneResult& plane, const RansacOptions& options,
+                      PlaneHypothesis& out) {
+    if (std::fabs(plane.d) < 1e-6f) return false;
+    const double inv_d = 1.0 / plane.d;
+    out.a = static_cast<float>(-plane.a / options.fx * inv_d);
+    out.b = static_cast<float>(plane.b / options.fy * inv_d);
+    out.c = -1.0f;
+    out.d = static_cast<float>((plane.a * options.cx / options.fx - plane.b * options.cy / options.fy - plane.c) * inv_d);
+    return true;
+}
+
+// Fonction affine inv = alpha*u + beta*v + gamma -> plan métrique unitaire. Avec
+// u = fx * X/Z + cx et v = cy - fy * Y/Z, multiplier par Z donne
+// (alpha*fx) X - (beta*fy) Y + (alpha*cx + beta*cy + gamma) Z - 1 = 0.
+// Normale orientée du centre optique vers le plan (d < 0).
+void affine_to_metric(double alpha, double beta, double gamma, const RansacOptions& options,
+                      RansacPlaneResult& out) {
+    const double A = alpha * options.fx;
+    const double B = -beta * options.fy;
+    const double C = alpha * options.cx + beta * options.cy + gamma;
+    const double norm = std::sqrt(A * A + B * B + C * C);
+    const double scale = norm > 0.0 ? 1.0 / norm : 0.0;
+    out.a = static_cast<float>(A * scale);
+    out.b = static_cast<float>(B * scale);
+    out.c = static_cast<float>(C * scale);
+    out.d = static_cast<float>(-scale);
+}
+
+// Écrit un plan ajusté en profondeur inverse (voir write_plane_result). Le réajustement
+// par moindres carrés est une régression de inv sur (u, v) ; le centroïde est le point
+// du plan au pixel moyen des inliers, rms l'écart résiduel en profondeur inverse.
+void write_affine_plane_result(const PlaneHypothesis& affine, int inlier_count, size_t cloud_size,
+                               const PlaneMoments* moments, const RansacOptions& options,
+                               RansacPlaneResult& out) {
+    double alpha = affine.a, beta = affine.b, gamma = affine.d;
+    out.inlier_count = static_cast<int32_t>(inlier_count);
+    out.inlier_ratio = cloud_size > 0 ? static_cast<float>(inlier_count) / static_cast<float>(cloud_size) : 0.0f;
+    out.centroid_x = out.centroid_y = out.centroid_z = 0.0f;
+    out.rms = 0.0f;
+
+    if (moments != nullptr && moments->n >= 3.0) {
+        const double inv_n = 1.0 / moments->n;
+        const double mu = moments->sx * inv_n;
+        const double mv = moments->sy * inv_n;
+        const double mi = moments->sz * inv_n;
+        const double cuu = moments->sxx * inv_n - mu * mu;
+        const double cuv = moments->sxy * inv_n - mu * mv;
+        const double cvv = moments->syy * inv_n - mv * mv;
+        const double cui = moments->sxz * inv_n - mu * mi;
+        const double cvi = moments->syz * inv_n - mv * mi;
+        const double cii = moments->szz * inv_n - mi * mi;
+        const double det = cuu * cvv - cuv * cuv;
+        if (det > 1e-12 * (cuu * cvv + 1e-30)) { // Sinon (inliers alignés) : hypothèse conservée
+            alpha = (cui * cvv - cvi * cuv) / det;
+            beta = (cvi * cuu - cui * cuv) / det;
+            gamma = mi - alpha * mu - beta * mv;
+            const double residual = cii - alpha * cui - beta * cvi;
+            out.rms = static_cast<float>(std::sqrt(residual > 0.0 ? residual : 0.0));
+        }
+        const double inv_z = alpha * mu + beta * mv + gamma;
+        if (inv_z > 0.0) {
+            const double z = 1.0 / inv_z;
+            out.centroid_x = static_cast<float>((mu - options.cx) / options.fx * z);
+            out.centroid_y = static_cast<float>(-(mv - options.cy) / options.fy * z);
+            out.centroid_z = static_cast<float>(z);
+        }
+    }
+    affine_to_metric(alpha, beta, gamma, options, out);
+}
+
+// Seuil d'inlier dans l'espace d'ajustement choisi.
+inline float inlier_threshold(const RansacOptions& options) {
+    return options.engine == RANSAC_ENGINE_INVERSE_DEPTH ? options.inverse_depth_threshold
+                                                         : options.distance_threshold;
+}
+
+// Demi-largeur de la fenêtre de tirage des 2e et 3e points, en fraction du nuage.
+constexpr size_t kSampleWindowDivisor = 16;
+
+// Taille de bloc par défaut pour le score avec terminaison anticipée.
+constexpr int32_t kDefaultChunkSize = 1024;
+
+// Plafond du nombre d'itérations adaptatif (atteint seulement si le taux d'inliers
+// est infime ; le budget d'évaluations arrête la recherche bien avant).
+constexpr int kMaxAdaptiveIterations = 100000;
+
+// Rétention par défaut de la reprise temporelle : un plan précédent est repris s'il
+// garde au moins 80 % de son taux d'inliers (les bords de l'image changent en marchant).
+constexpr float kDefaultWarmStartRetention = 0.8f;
+
+// Seuil d'inlier par défaut en profondeur inverse : quelques pas de quantification
+// d'une carte 8 bits normalisée sur [0, 1].
+constexpr float kDefaultInverseDepthThreshold = 0.01f;
+
+// Nombre max de plans précédents essayés.
+constexpr int kMaxWarmStartPlanes = 16;
+
+// Bits de kMaxAdaptiveIterations (2^17 > 100000) : puissances au carré précalculées.
+constexpr int kAdaptiveIterationBits = 17;
+
+// Nombre d'itérations nécessaires pour tirer au moins un triplet pur avec la
+// probabilité `confidence`, quand une fraction `inlier_ratio` des points est inlier :
+// plus petit k tel que (1 - w^3)^k <= 1 - confidence.
+// Calcul par multiplications (pas de log) : résultat identique sur toutes les
+// plateformes IEEE. (1 - w^3)^k décroît avec k : le plus grand k encore au-dessus de
+// la cible se construit bit par bit à partir des puissances (1 - w^3)^(2^j), en
+// O(log k) multiplications (la boucle une multiplication par itération coûtait
+// jusqu'à 100000 multiplications dépendantes par appel quand w est infime).
+// Estimation prudente, car le tirage localisé rend un triplet pur plus probable que w^3.
+int required_iterations(double inlier_ratio, double confidence) {
+    const double p_good = inlier_ratio * inlier_ratio * inlier_ratio;
+    if (p_good <= 0.0) return kMaxAdaptiveIterations;
+    if (p_good >= 1.0) return 1;
+    const double failure_target = 1.0 - confidence;
+
+    double powers[kAdaptiveIterationBits]; // powers[j] = (1 - p_good)^(2^j)
+    powers[0] = 1.0 - p_good;
+    for (int j = 1; j < kAdaptiveIterationBits; ++j) powers[j] = powers[j - 1] * powers[j - 1];
+
+    int k = 0;              // Plus grand k < kMaxAdaptiveIterations tel que failure > cible
+    double failure = 1.0;   // Probabilité d'échec après k itérations
+    for (int j = kAdaptiveIterationBits - 1; j >= 0; --j) {
+        const int step = 1 << j;
+        if (k + step >= kMaxAdaptiveIterations) continue;
+        const double next = failure * powers[j];
+        if (next > failure_target) {
+            failure = next;
+            k += step;
+        }
+    }
+    return k + 1;
+}
+
+// --- Générateur de tirages ---
+// Générateur à compteur (mélangeur SplitMix64) : la suite de l'hypothèse n ne dépend
+// que de (graine, plan, n), pas des tirages précédents. Quelques multiplications
+// entières par nombre, aucun état partagé, résultat identique sur toutes les
+// plateformes (remplace random_device + mt19937, coûteux à créer à chaque appel).
+inline uint64_t mix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct SampleRng {
+    uint64_t state;
+
+    SampleRng(uint64_t stream_key, uint64_t counter) : state(mix64(stream_key ^ mix64(counter))) {}
+
+    uint32_t next() {
+        state += 0x9E3779B97F4A7C15ull;
+        return static_cast<uint32_t>(mix64(state) >> 32);
+    }
+
+    // Entier uniforme dans [0, n), n > 0 (méthode de Lemire : une multiplication,
+    // la division n'est faite que dans le cas rare d'un rejet possible).
+    uint32_t below(uint32_t n) {
+        uint64_t m = static_cast<uint64_t>(next()) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n) {
+            const uint32_t reject = (0u - n) % n;
+            while (low < reject) {
+                m = static_cast<uint64_t>(next()) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
 };
 
+// Clé de la suite des tirages d'un plan (séquentiel : plan 0, 1, ...).
+inline uint64_t plane_stream_key(uint32_t seed, int plane_index) {
+    return mix64((static_cast<uint64_t>(seed) << 32) | static_cast<uint32_t>(plane_index));
+}
+
+// Graine automatique (options.seed == 0) : horloge et compteur d'appels, jamais 0
+// pour pouvoir être rejouée telle quelle.
+uint32_t automatic_seed() {
+    static std::atomic<uint64_t> calls{0};
+    const uint64_t now = static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    const uint32_t seed = static_cast<uint32_t>(mix64(now ^ mix64(calls.fetch_add(1, std::memory_order_relaxed))));
+    return seed != 0 ? seed : 1u;
+}
+
+// Recherche d'un plan : budget en entrée, meilleur plan et coût effectif en sortie.
+struct PlaneSearch {
+    int64_t evaluation_budget = 0; // Évaluations point-plan autorisées pour ce plan
+    uint64_t stream_key = 0;       // Suite de tirages du plan (plane_stream_key)
+
+    PlaneHypothesis best;
+    int best_inlier_count = -1;    // -1 si aucun tirage non dégénéré (ou score à battre fourni)
+    int iterations = 0;
+    int64_t evaluations = 0;
+    int early_exits = 0;
+};
+
+// Nombre max d'hypothèses tirées et scorées par lot. Les lots d'un plan doublent
+// (1, 1, 2, 4, 8, 16, 16...) : les premières hypothèses fixent vite un score à battre
+// (terminaison anticipée) et le nombre adaptatif d'itérations, les suivantes occupent
+// tous les threads. La suite des lots ne dépend pas du nombre de threads : le résultat
+// et le coût d'un appel sont les mêmes en série et en parallèle.
+constexpr int kHypothesisBatch = 16;
+
+// Paramètres du score d'une hypothèse, communs à tout un lot.
+struct ScoreSetup {
+    const PointCloudSoA* cloud;
+    size_t count;
+    size_t window;            // Demi-largeur de la fenêtre de tirage
+    size_t chunk;             // Taille de bloc du score
+    bool early_termination;
+    float threshold;
+    CountInliersFn kernel;
+    bool inverse_depth;       // Hypothèses affines (espace profondeur inverse)
+    uint64_t stream_key;
+    int best_to_beat;         // Meilleur score au début du lot
+};
+
+// Résultat du score d'une hypothèse.
+struct HypothesisScore {
+    PlaneHypothesis plane;
+    int inliers = -1;         // -1 : tirage dégénéré ou hypothèse abandonnée
+    int64_t evaluations = 0;
+    bool abandoned = false;
+};
+
+// Tire et score l'hypothèse n (indépendante des autres : exécutable sur n'importe quel thread).
+//
+// Tirage localisé : le 1er point est uniforme, les 2 autres sont pris dans une
+// fenêtre d'indices autour de lui. Le nuage est rangé dans l'ordre de balayage de
+// l'image (et la compaction conserve cet ordre), donc des indices proches sont des
+// pixels proches, très probablement sur la même surface. Un triplet « pur » devient
+// bien plus probable qu'avec 3 points uniformes : indispensable quand le budget est
+// partagé entre plusieurs plans.
+// Le tirage de l'hypothèse n vient de SampleRng(stream_key, n) : il est reproductible
+// à graine égale.
+//
+// Terminaison anticipée : le score se fait par blocs ; après chaque bloc, si
+// (inliers comptés + points restants) ne dépasse pas le meilleur score du début du
+// lot, l'hypothèse ne peut plus gagner et on l'abandonne.
+HypothesisScore score_hypothesis(const ScoreSetup& setup, int n) {
+    HypothesisScore score;
+    const PointCloudSoA& cloud = *setup.cloud;
+    const size_t count = setup.count;
+    SampleRng rng(setup.stream_key, static_cast<uint64_t>(n));
+
+    // Sélectionner 3 points aléatoires distincts (le nuage tient sur 32 bits d'indices)
+    const size_t idx1 = rng.below(static_cast<uint32_t>(count));
+    const size_t lo = idx1 > setup.window ? idx1 - setup.window : 0;
+    const size_t hi = idx1 + setup.window < count ? idx1 + setup.window : count - 1;
+    const uint32_t span = static_cast<uint32_t>(hi - lo + 1);
+    size_t idx2 = lo + rng.below(span);
+    size_t idx3 = lo + rng.below(span);
+    // S'assurer qu'ils sont distincts (rejet : la fenêtre contient au moins 3 indices)
+    while (idx2 == idx1) { idx2 = lo + rng.below(span); }
+    while (idx3 == idx1 || idx3 == idx2) { idx3 = lo + rng.below(span); }
+
+    const bool built = setup.inverse_depth
+        ? affine_from_points(cloud.at(idx1), cloud.at(idx2), cloud.at(idx3), score.plane)
+        : plane_from_points(cloud.at(idx1), cloud.at(idx2), cloud.at(idx3), score.plane);
+    if (!built) {
+        score.evaluations = 3; // Le tirage a tout de même lu 3 points
+        return score;          // Points dégénérés
+    }
+
+    // Compter les inliers pour ce plan candidat, bloc par bloc
+    const PlaneHypothesis& plane = score.plane;
+    int inliers = 0;
+    size_t scanned = 0;
+    while (scanned < count) {
+        const size_t n_points = count - scanned < setup.chunk ? count - scanned : setup.chunk;
+        inliers += setup.kernel(cloud.x.data() + scanned, cloud.y.data() + scanned,
+                                cloud.z.data() + scanned, n_points,
+                                plane.a, plane.b, plane.c, plane.d, setup.threshold);
+        scanned += n_points;
+        if (setup.early_termination && scanned < count &&
+            static_cast<int64_t>(inliers) + static_cast<int64_t>(count - scanned) <= setup.best_to_beat) {
+            score.abandoned = true; // Même avec tous les points restants, pas mieux que le meilleur
+            break;
+        }
+    }
+    score.evaluations = static_cast<int64_t>(scanned);
+    if (!score.abandoned) score.inliers = inliers;
+    return score;
+}
+
+// Boucle RANSAC sur les `count` premiers points : on garde le plan qui a le plus
+// d'inliers. S'arrête après max_iterations tirages (ou le nombre adaptatif), ou quand
+// le budget d'évaluations est consommé.
+//
+// Les hypothèses sont scorées par lots de kHypothesisBatch, réparties sur le groupe
+// de threads s'il y en a un (sinon en série, même résultat). Réduction dans l'ordre
+// des indices : à score égal, la première hypothèse l'emporte, comme en série. Une
+// hypothèse abandonnée ne pouvait pas dépasser le meilleur score du début du lot,
+// donc le plan retenu est exactement celui d'un score complet de chaque hypothèse.
+void find_best_plane(const PointCloudSoA& cloud, size_t count, const RansacOptions& options,
+                     WorkerPool* pool, PlaneSearch& search) {
+    ScoreSetup setup;
+    setup.cloud = &cloud;
+    setup.count = count;
+    setup.window = count / kSampleWindowDivisor;
+    if (setup.window < 2) setup.window = 2; // Au moins 3 indices distincts dans la fenêtre (count >= 3)
+    setup.early_termination = options.early_termination != 0;
+    setup.chunk = setup.early_termination
+        ? static_cast<size_t>(options.chunk_size > 0 ? options.chunk_size : kDefaultChunkSize)
+        : count;
+    setup.threshold = inlier_threshold(options);
+    setup.kernel = count_inliers_kernel();
+    setup.inverse_depth = options.engine == RANSAC_ENGINE_INVERSE_DEPTH;
+    setup.stream_key = search.stream_key;
+
+    int iteration_cap = options.adaptive_iterations != 0 ? kMaxAdaptiveIterations
+                                                         : options.max_iterations;
+    if (options.adaptive_iterations != 0 && search.best_inlier_count > 0) {
+        // Score à battre fourni (plan précédent) : il fixe déjà le nombre d'itérations.
+        iteration_cap = required_iterations(static_cast<double>(search.best_inlier_count) / static_cast<double>(count),
+                                            options.confidence);
+    }
+    const bool parallel = pool != nullptr && pool->thread_count() > 1;
+
+    HypothesisScore scores[kHypothesisBatch];
+    while (search.iterations < iteration_cap && search.evaluations < search.evaluation_budget) {
+        const int first = search.iterations;
+        int batch = first < 1 ? 1 : (first < kHypothesisBatch ? first : kHypothesisBatch);
+        if (batch > iteration_cap - first) batch = iteration_cap - first;
+        setup.best_to_beat = search.best_inlier_count;
+
+        auto score_one = [&setup, &scores, first](int j) { scores[j] = score_hypothesis(setup, first + j); };
+        if (parallel) {
+            pool->parallel_for(batch, score_one);
+        } else {
+            for (int j = 0; j < batch; ++j) score_one(j);
+        }
+        search.iterations += batch;
+
+        // Réduction : garder le meilleur ; en mode adaptatif, réviser le nombre d'itérations nécessaire
+        bool improved = false;
+        for (int j = 0; j < batch; ++j) {
+            const HypothesisScore& score = scores[j];
+            search.evaluations += score.evaluations;
+            if (score.abandoned) ++search.early_exits;
+            if (score.inliers > search.best_inlier_count) {
+                search.best_inlier_count = score.inliers;
+                search.best = score.plane;
+                improved = true;
+            }
+        }
+        if (improved && options.adaptive_iterations != 0) {
+            iteration_cap = required_iterations(static_cast<double>(search.best_inlier_count) / static_cast<double>(count),
+                                                options.confidence);
+        }
+    }
+}
+
+} // namespace
+
+
+// --- Tables de rayons ---
+
+bool RayTable::prepare(int new_width, int new_height, float new_fx, float new_fy, float new_cx, float new_cy) {
+    if (new_width == width && new_height == height &&
+        new_fx == fx && new_fy == fy && new_cx == cx && new_cy == cy) {
+        return true; // Clé inchangée : tables réutilisées
+    }
+    if (!ray_x.reserve(static_cast<size_t>(new_width)) || !ray_y.reserve(static_cast<size_t>(new_height))) {
+        width = height = 0; // Tables incomplètes : reconstruites au prochain appel
+        return false;
+    }
+
+    // IMPORTANT: fx, fy, cx, cy sont des PLACEHOLDERS ! La précision de X et Y dépend
+    // CRUCIALEMENT de la calibration.
+    // Convention : X vers la droite, Z vers l'avant, et Y vers le HAUT (l'image a v
+    // vers le bas, d'où le signe) pour correspondre à l'analyse Dart (Y normal faible = mur vertical).
+    for (int u = 0; u < new_width; ++u) ray_x.data()[u] = (static_cast<float>(u) - new_cx) / new_fx;
+    for (int v = 0; v < new_height; ++v) ray_y.data()[v] = -(static_cast<float>(v) - new_cy) / new_fy;
+
+    width = new_width;
+    height = new_height;
+    fx = new_fx;
+    fy = new_fy;
+    cx = new_cx;
+    cy = new_cy;
+    LOGD("Tables de rayons reconstruites (%dx%d, fx=%.1f, fy=%.1f, cx=%.1f, cy=%.1f)",
+         width, height, fx, fy, cx, cy);
+    return true;
+}
+
+
 // --- Implémentation de la fonction de détection de murs RANSAC ---
 
+extern "C" void ransac_default_options(RansacOptions* out_options) {
+    if (out_options == nullptr) return;
+    RansacOptions options{};
+    // Intrinsèques : à renseigner par l'appelant (calibration), aucune valeur par défaut sûre.
+    options.fx = 0.0f;
+    options.fy = 0.0f;
+    options.cx = 0.0f;
+    options.cy = 0.0f;
+    options.distance_threshold = 0.08f;
+    options.min_inliers = 500;
+    options.max_iterations = 50;
+    options.early_termination = 1;
+    options.chunk_size = kDefaultChunkSize;
+    options.adaptive_iterations = 1;
+    options.confidence = 0.99f;
+    // Par défaut : toute la carte, chaque pixel.
+    options.pixel_stride = 1;
+    options.roi_x = 0;
+    options.roi_y = 0;
+    options.roi_w = 0;
+    options.roi_h = 0;
+    options.max_points = 0;
+    options.refine_full_resolution = 0;
+    options.refine_least_squares = 1;
+    options.seed = 0; // Graine automatique
+    options.warm_start = 1;
+    options.warm_start_retention = kDefaultWarmStartRetention;
+    options.engine = RANSAC_ENGINE_METRIC;
+    options.inverse_depth_threshold = kDefaultInverseDepthThreshold;
+    options.coarse_level = 0;
+    *out_options = options;
+}
+
+// Point d'entrée historique : sans contexte, la mémoire de travail est allouée
+// à chaque appel. Préférer pipeline_detect_walls dans la boucle de trames.
+// Garde max_iterations fixe et le score complet de chaque hypothèse ; le tirage est
+// celui du cœur (localisé, voir score_hypothesis et la doc dans image_utils.h).
 extern "C" int detect_walls_ransac(const float* depth_map_data,
                                    int width, int height,
                                    float fx, float fy, float cx, float cy, // Placeholders !
@@ -30,154 +745,439 @@ extern "C" int detect_walls_ransac(const float* depth_map_data,
                                    int max_iterations,
                                    RansacPlaneResult* out_planes_buffer,
                                    int max_planes) {
+    RansacOptions options;
+    ransac_default_options(&options);
+    options.fx = fx;
+    options.fy = fy;
+    options.cx = cx;
+    options.cy = cy;
+    options.distance_threshold = distance_threshold;
+    options.min_inliers = min_inliers;
+    options.max_iterations = max_iterations;
+    options.early_termination = 0;
+    options.adaptive_iterations = 0;
+    options.refine_least_squares = 0;
+
+    RansacScratch scratch;
+    return ransac_detect_planes(DepthInput::from_f32(depth_map_data), width, height, options,
+                                out_planes_buffer, max_planes, scratch, nullptr);
+}
+
+extern "C" int detect_walls_ransac_ex(const float* depth_map_data,
+                                      int width, int height,
+                                      const RansacOptions* options,
+                                      RansacPlaneResult* out_planes_buffer,
+                                      int max_planes,
+                                      RansacStats* out_stats) {
+    if (options == nullptr) {
+        LOGE("detect_walls_ransac_ex : options manquantes.");
+        return 0;
+    }
+    RansacScratch scratch;
+    return ransac_detect_planes(DepthInput::from_f32(depth_map_data), width, height, *options,
+                                out_planes_buffer, max_planes, scratch, out_stats);
+}
+
+extern "C" int detect_walls_ransac_warm(const float* depth_map_data,
+                                        int width, int height,
+                                        const RansacOptions* options,
+                                        const RansacPlaneResult* prior_planes,
+                                        int prior_count,
+                                        RansacPlaneResult* out_planes_buffer,
+                                        int max_planes,
+                                        RansacStats* out_stats) {
+    if (options == nullptr) {
+        LOGE("detect_walls_ransac_warm : options manquantes.");
+        return 0;
+    }
+    RansacScratch scratch;
+    return ransac_detect_planes(DepthInput::from_f32(depth_map_data), width, height, *options,
+                                out_planes_buffer, max_planes, scratch, out_stats, nullptr,
+                                prior_planes, prior_count);
+}
+
+extern "C" int detect_walls_ransac_q8(const uint8_t* depth_q8,
+                                      int width, int height,
+                                      int format, float scale, int zero_point,
+                                      const RansacOptions* options,
+                                      RansacPlaneResult* out_planes_buffer,
+                                      int max_planes,
+                                      RansacStats* out_stats) {
+    DepthInput depth;
+    if (options == nullptr || !DepthInput::from_q8(depth_q8, format, scale, zero_point, depth)) {
+        LOGE("detect_walls_ransac_q8 : options ou format invalides (%d).", format);
+        return 0;
+    }
+    RansacScratch scratch;
+    return ransac_detect_planes(depth, width, height, *options,
+                                out_planes_buffer, max_planes, scratch, out_stats);
+}
+
+// Taille minimale (pixels) du niveau grossier : en dessous, trop peu de points par plan.
+constexpr int kMinCoarseSize = 8;
+
+// Mode grossier -> fin (options.coarse_level > 0). La recherche complète (tirages, score,
+// reprise temporelle) se fait sur le niveau grossier, moyenné donc moins bruité et
+// 4^niveau fois plus petit ; ses plans, métriques donc indépendants de la résolution,
+// sont ensuite vérifiés dans leur ordre de découverte sur le nuage pleine résolution :
+// comptage (noyau vectoriel), rejet sous min_inliers, puis retrait des inliers et
+// réajustement par moindres carrés sur ceux-ci (si refine_least_squares ; le plan
+// grossier l'a déjà été sur les inliers de son niveau). Chaque plan ne coûte ainsi
+// que deux passes pleine résolution.
+static int detect_planes_coarse_to_fine(const DepthInput& depth, int width, int height,
+                                        const RansacOptions& options,
+                                        RansacPlaneResult* out_planes_buffer, int max_planes,
+                                        RansacScratch& scratch, RansacStats& stats, WorkerPool* pool,
+                                        const RansacPlaneResult* prior_planes, int prior_count,
+                                        const DepthPyramid* pyramid) {
+    const int level = options.coarse_level;
+    if (level < 1 || level >= DEPTH_PYRAMID_LEVELS ||
+        (width >> level) < kMinCoarseSize || (height >> level) < kMinCoarseSize) {
+        LOGE("detect_walls_ransac : niveau grossier invalide (%d pour %dx%d).", level, width, height);
+        return 0;
+    }
+    // Niveau grossier : celui de la pyramide fournie s'il correspond, sinon construit ici.
+    if (pyramid == nullptr || pyramid->built_levels <= level ||
+        pyramid->widths[0] != width || pyramid->heights[0] != height) {
+        if (!scratch.pyramid.build(depth, width, height, level + 1)) return 0;
+        pyramid = &scratch.pyramid;
+    }
+
+    // Options du niveau grossier. Le pixel grossier u' couvre les pixels s*u' .. s*u'+s-1,
+    // de centre s*u' + (s-1)/2 : fx' = fx / s, cx' = (cx - (s-1)/2) / s (idem en y).
+    const int scale = 1 << level;
+    const float half_span = 0.5f * static_cast<float>(scale - 1);
+    RansacOptions coarse = options;
+    coarse.coarse_level = 0;
+    coarse.fx = options.fx / static_cast<float>(scale);
+    coarse.fy = options.fy / static_cast<float>(scale);
+    coarse.cx = (options.cx - half_span) / static_cast<float>(scale);
+    coarse.cy = (options.cy - half_span) / static_cast<float>(scale);
+    coarse.min_inliers = (options.min_inliers + scale * scale - 1) / (scale * scale);
+    coarse.pixel_stride = 1;
+    coarse.roi_x = options.roi_x / scale;
+    coarse.roi_y = options.roi_y / scale;
+    coarse.roi_w = options.roi_w > 0 ? (options.roi_w + scale - 1) / scale : 0;
+    coarse.roi_h = options.roi_h > 0 ? (options.roi_h + scale - 1) / scale : 0;
+    coarse.refine_full_resolution = 0;
+
+    // Plans candidats écrits directement dans le tampon de sortie : la vérification les
+    // réécrit en place (le plan vérifié j vient d'un candidat i >= j, lu avant).
+    const int candidates = ransac_detect_planes(pyramid->level_input(level), pyramid->widths[level],
+                                                pyramid->heights[level], coarse, out_planes_buffer,
+                                                max_planes, scratch, &stats, pool,
+                                                prior_planes, prior_count, nullptr, &scratch.coarse_rays);
+    if (candidates == 0) return 0;
+
+    // Nuage pleine résolution (même grille que le mode direct).
+    const bool inverse_depth = options.engine == RANSAC_ENGINE_INVERSE_DEPTH;
+    const bool refine_least_squares = options.refine_least_squares != 0;
+    const float threshold = inlier_threshold(options);
+    SamplingGrid grid = make_sampling_grid(width, height, options);
+    if (options.refine_full_resolution != 0) grid.stride = 1;
+    PointCloudSoA& point_cloud = scratch.point_cloud;
+    if (!point_cloud.reserve(grid.samples())) {
+        LOGE("Allocation du nuage de points échouée (%dx%d).", width, height);
+        return 0;
+    }
+    if (inverse_depth) {
+        gather_inverse_depth(depth, width, grid, point_cloud);
+    } else {
+        if (!scratch.rays.prepare(width, height, options.fx, options.fy, options.cx, options.cy)) {
+            LOGE("Allocation des tables de rayons échouée (%dx%d).", width, height);
+            return 0;
+        }
+        back_project(depth, width, grid, scratch.rays, point_cloud);
+    }
+    const int stride_area = grid.stride * grid.stride;
+    int sampled_min_inliers = (options.min_inliers + stride_area - 1) / stride_area;
+    if (sampled_min_inliers < 3) sampled_min_inliers = 3;
+
+    const float* xs = point_cloud.x.data();
+    const float* ys = point_cloud.y.data();
+    const float* zs = point_cloud.z.data();
+    size_t remaining = point_cloud.size;
+    int verified = 0;
+    for (int i = 0; i < candidates; ++i) {
+        const RansacPlaneResult candidate = out_planes_buffer[i];
+        PlaneHypothesis plane{candidate.a, candidate.b, candidate.c, candidate.d};
+        if (inverse_depth && !metric_to_affine(candidate, options, plane)) continue;
+
+        const int inliers = count_inliers_kernel()(xs, ys, zs, remaining,
+                                                   plane.a, plane.b, plane.c, plane.d, threshold);
+        stats.point_evaluations += static_cast<int64_t>(remaining);
+        if (inliers < sampled_min_inliers) {
+            LOGD("Plan grossier %d non confirmé en pleine résolution (%d < %d inliers).",
+                 i, inliers, sampled_min_inliers);
+            continue;
+        }
+
+        PlaneMoments moments;
+        const size_t kept = remove_inliers(point_cloud, remaining, plane, threshold,
+                                           refine_least_squares ? &moments : nullptr);
+        stats.point_evaluations += static_cast<int64_t>(remaining);
+        if (inverse_depth) {
+            write_affine_plane_result(plane, static_cast<int>(remaining - kept), point_cloud.size,
+                                      refine_least_squares ? &moments : nullptr, options,
+                                      out_planes_buffer[verified]);
+        } else {
+            write_plane_result(plane, static_cast<int>(remaining - kept), point_cloud.size,
+                               refine_least_squares ? &moments : nullptr, out_planes_buffer[verified]);
+        }
+        ++verified;
+        remaining = kept;
+    }
+    LOGD("Grossier -> fin : %d plan(s) candidat(s) au niveau %d, %d vérifié(s) sur %zu points.",
+         candidates, level, verified, point_cloud.size);
+    return verified;
+}
+
+int ransac_detect_planes(const DepthInput& depth,
+                         int width, int height,
+                         const RansacOptions& options,
+                         RansacPlaneResult* out_planes_buffer,
+                         int max_planes,
+                         RansacScratch& scratch,
+                         RansacStats* out_stats,
+                         WorkerPool* pool,
+                         const RansacPlaneResult* prior_planes,
+                         int prior_count,
+                         const DepthPyramid* pyramid,
+                         RayTable* rays) {
+
+    // Statistiques accumulées localement, recopiées à la fin (sortie anticipée comprise).
+    RansacStats stats{};
+    if (out_stats != nullptr) *out_stats = stats;
+
+    const float fx = options.fx, fy = options.fy, cx = options.cx, cy = options.cy; // Placeholders !
+    const int min_inliers = options.min_inliers;
+    const int max_iterations = options.max_iterations;
+    const bool refine_least_squares = options.refine_least_squares != 0;
 
     LOGD("Entree detect_walls_ransac. Dim: %dx%d, Thresh: %.3f, MinInl: %d, MaxIter: %d",
-         width, height, distance_threshold, min_inliers, max_iterations);
+         width, height, inlier_threshold(options), min_inliers, max_iterations);
     LOGD("Intrinsics (PLACEHOLDERS!): fx=%.1f, fy=%.1f, cx=%.1f, cy=%.1f", fx, fy, cx, cy);
 
+    if (!depth.valid() || width <= 0 || height <= 0 || fx <= 0.0f || fy <= 0.0f) {
+        LOGE("detect_walls_ransac : carte ou intrinsèques invalides.");
+        return 0;
+    }
+    if (options.engine != RANSAC_ENGINE_METRIC && options.engine != RANSAC_ENGINE_INVERSE_DEPTH) {
+        LOGE("detect_walls_ransac : espace d'ajustement inconnu (%d).", options.engine);
+        return 0;
+    }
+    // Espace profondeur inverse : points (u, v, inv) relevés sans déprojection, plans
+    // affines convertis en plans métriques seulement à l'écriture des résultats.
+    const bool inverse_depth = options.engine == RANSAC_ENGINE_INVERSE_DEPTH;
+    const float threshold = inlier_threshold(options);
+
+    if (options.coarse_level != 0) {
+        const int verified = detect_planes_coarse_to_fine(depth, width, height, options, out_planes_buffer,
+                                                          max_planes, scratch, stats, pool,
+                                                          prior_planes, prior_count, pyramid);
+        if (out_stats != nullptr) *out_stats = stats;
+        return verified;
+    }
 
     // --- Étape 1: Génération du Nuage de Points 3D ---
-    // Convertit la carte de profondeur 2D en une liste de points 3D (X, Y, Z).
-    std::vector<Point3D> point_cloud;
-    point_cloud.reserve(width * height / 4); // Pré-allouer un peu de mémoire (estimation)
-
-    for (int v = 0; v < height; ++v) { // v = coordonnée y de l'image (row)
-        for (int u = 0; u < width; ++u) { // u = coordonnée x de l'image (col)
-            // depth_map_data est la profondeur INVERSE relative (plus haut = plus proche)
-            float inv_d = depth_map_data[v * width + u];
-
-            // Ignorer les pixels invalides ou trop lointains/proches selon le modèle MiDaS
-            // (le seuil 0.01f est arbitraire, à ajuster si nécessaire)
-            if (inv_d > 0.01f) {
-                // Convertir la profondeur inverse en profondeur Z (distance)
-                float Z = 1.0f / inv_d;
-
-                // Déprojection 2D -> 3D en utilisant les paramètres intrinsèques
-                // IMPORTANT: Utilise fx, fy, cx, cy qui sont des PLACEHOLDERS !
-                // La précision de X et Y dépend CRUCIALEMENT de la calibration !
-                // Convention de coordonnées caméra fréquente : X vers la droite, Y vers le BAS, Z vers l'avant.
-                // Si votre analyse Dart suppose Y vers le HAUT, il faudra ajuster le signe de Y ici ou dans l'analyse.
-                // Pour correspondre à l'analyse Dart (Y normal faible = mur vertical), on suppose Y vers le haut.
-                float X = (static_cast<float>(u) - cx) * Z / fx;
-                float Y = (static_cast<float>(v) - cy) * Z / fy; // Y positif = vers le BAS dans l'image
-                // Pour obtenir Y vers le HAUT dans le repère 3D, on peut inverser :
-                 Y = -Y;
-
-
-                // Ajouter le point 3D au nuage
-                point_cloud.push_back({X, Y, Z});
-            }
-        }
+    // Convertit la carte de profondeur 2D en une liste de points 3D (X, Y, Z), ou
+    // (u, v, inv) en profondeur inverse, sur la ROI et avec le pas demandés : le coût de la déprojection et celui de RANSAC
+    // (budget proportionnel au nombre de points) diminuent avec le sous-échantillonnage.
+    // Le nuage (structure-de-tableaux) vient de la mémoire de travail : sa capacité
+    // couvre toute la carte, push_back ne réalloue jamais.
+    const SamplingGrid grid = make_sampling_grid(width, height, options);
+    PointCloudSoA& point_cloud = scratch.point_cloud;
+    point_cloud.clear();
+    const bool recount_full = options.refine_full_resolution != 0 && grid.stride > 1;
+    SamplingGrid full_grid = grid;
+    full_grid.stride = 1;
+    if (!point_cloud.reserve(recount_full ? full_grid.samples() : grid.samples())) {
+        LOGE("Allocation du nuage de points échouée (%dx%d).", width, height);
+        return 0;
     }
 
-    LOGD("Nuage de points généré avec %zu points.", point_cloud.size());
+    RayTable& ray_table = rays != nullptr ? *rays : scratch.rays;
+    if (!inverse_depth && !ray_table.prepare(width, height, fx, fy, cx, cy)) {
+        LOGE("Allocation des tables de rayons échouée (%dx%d).", width, height);
+        return 0;
+    }
+    auto build_points = [&](const SamplingGrid& sampling) {
+        if (inverse_depth) {
+            gather_inverse_depth(depth, width, sampling, point_cloud);
+        } else {
+            back_project(depth, width, sampling, ray_table, point_cloud);
+        }
+    };
+    build_points(grid);
+
+    // min_inliers est exprimé en pixels pleine résolution : un point échantillonné
+    // représente stride^2 pixels.
+    const int stride_area = grid.stride * grid.stride;
+    int sampled_min_inliers = (min_inliers + stride_area - 1) / stride_area;
+    if (sampled_min_inliers < 3) sampled_min_inliers = 3;
+
+    LOGD("Nuage de points généré avec %zu points (ROI [%d,%d)x[%d,%d), pas %d).",
+         point_cloud.size, grid.x0, grid.x1, grid.y0, grid.y1, grid.stride);
 
     // Vérification : A-t-on assez de points pour RANSAC ?
-    if (point_cloud.size() < 3 || point_cloud.size() < static_cast<size_t>(min_inliers)) {
-        LOGW("Pas assez de points valides (%zu) pour RANSAC.", point_cloud.size());
+    if (point_cloud.size < 3 || point_cloud.size < static_cast<size_t>(sampled_min_inliers)) {
+        LOGW("Pas assez de points valides (%zu) pour RANSAC.", point_cloud.size);
         return 0; // Retourne 0 plans trouvés
     }
 
 
-    // --- Étape 2: Algorithme RANSAC pour trouver le meilleur plan ---
-
-    int best_inlier_count = -1;
-    float best_plane_A = 0, best_plane_B = 0, best_plane_C = 0, best_plane_D = 0;
-
-    // Initialiser le générateur de nombres aléatoires
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<size_t> distrib(0, point_cloud.size() - 1);
-
-    for (int iter = 0; iter < max_iterations; ++iter) {
-        // 2a. Sélectionner 3 points aléatoires distincts
-        size_t idx1 = distrib(gen);
-        size_t idx2 = distrib(gen);
-        size_t idx3 = distrib(gen);
-        // S'assurer qu'ils sont distincts (méthode simple, peut être optimisée)
-        while (idx2 == idx1) { idx2 = distrib(gen); }
-        while (idx3 == idx1 || idx3 == idx2) { idx3 = distrib(gen); }
-
-        const Point3D& p1 = point_cloud[idx1];
-        const Point3D& p2 = point_cloud[idx2];
-        const Point3D& p3 = point_cloud[idx3];
-
-        // 2b. Calculer l'équation du plan Ax + By + Cz + D = 0 passant par p1, p2, p3
-        // Vecteur v1 = p2 - p1
-        float v1x = p2.x - p1.x;
-        float v1y = p2.y - p1.y;
-        float v1z = p2.z - p1.z;
-        // Vecteur v2 = p3 - p1
-        float v2x = p3.x - p1.x;
-        float v2y = p3.y - p1.y;
-        float v2z = p3.z - p1.z;
-
-        // Calculer la normale N = v1 x v2 (produit vectoriel)
-        float A = v1y * v2z - v1z * v2y;
-        float B = v1z * v2x - v1x * v2z;
-        float C = v1x * v2y - v1y * v2x;
-
-        // Normaliser le vecteur normal (A, B, C) pour que les calculs de distance soient corrects
-        float magnitude = sqrt(A * A + B * B + C * C);
-        if (magnitude < 1e-6) { // Éviter division par zéro / points colinéaires
-            continue; // Passe à l'itération suivante si les points sont dégénérés
-        }
-        A /= magnitude;
-        B /= magnitude;
-        C /= magnitude;
-
-        // Calculer D: D = -(A*p1.x + B*p1.y + C*p1.z)
-        float D = -(A * p1.x + B * p1.y + C * p1.z);
-
-        // 2c. Compter les inliers pour ce plan candidat
-        int current_inlier_count = 0;
-        for (const auto& pt : point_cloud) {
-            // Calculer la distance perpendiculaire du point au plan
-            // distance = |Ax + By + Cz + D| / sqrt(A^2+B^2+C^2)
-            // Comme le vecteur normal (A,B,C) est déjà normalisé (magnitude=1),
-            // la distance est juste |Ax + By + Cz + D|
-            float distance = std::fabs(A * pt.x + B * pt.y + C * pt.z + D);
-
-            if (distance < distance_threshold) {
-                current_inlier_count++;
+    // --- Étape 2: RANSAC séquentiel multi-plans ---
+    // On cherche le meilleur plan, on retire ses inliers du nuage (compaction en place),
+    // puis on recommence sur les points restants, jusqu'à max_planes plans.
+    //
+    // Budget de latence : une recherche mono-plan coûtait max_iterations * N évaluations
+    // de points. Ce budget total est conservé et partagé entre les plans (la compaction
+    // compte pour une passe). Comme le nuage rétrécit après chaque plan, les recherches
+    // suivantes obtiennent plus d'itérations pour le même coût.
+    // Avec max_planes == 1 (et sans terminaison anticipée ni itérations adaptatives,
+    // cas de detect_walls_ransac), le nombre d'itérations est celui de l'ancienne version.
+    // Les tirages, eux, diffèrent : les 2e et 3e points viennent d'une fenêtre autour du
+    // premier (kSampleWindowDivisor), et non plus de tout le nuage.
+
+    if (max_planes < 1) {
+        LOGW("Le tampon de sortie fourni ne peut contenir aucun plan (max_planes=%d).", max_planes);
+        return 0;
+    }
+
+    // Graine des tirages : celle des options (rejeu), sinon une nouvelle, rapportée
+    // dans les statistiques pour pouvoir rejouer l'appel.
+    const uint32_t seed = options.seed != 0 ? options.seed : automatic_seed();
+    stats.seed = seed;
+
+    const int64_t total_budget = static_cast<int64_t>(max_iterations) * static_cast<int64_t>(point_cloud.size);
+    int64_t budget_left = total_budget;
+    size_t active_count = point_cloud.size; // Points non encore attribués à un plan : [0, active_count)
+    int planes_found = 0;
+
+    // Reprise temporelle : plans de l'appel précédent, essayés dans leur ordre de
+    // découverte (chacun au plus une fois).
+    const bool warm_start = options.warm_start != 0 && prior_planes != nullptr && prior_count > 0;
+    const int priors = warm_start ? (prior_count < kMaxWarmStartPlanes ? prior_count : kMaxWarmStartPlanes) : 0;
+    bool prior_tried[kMaxWarmStartPlanes] = {};
+    const size_t cloud_size = point_cloud.size;
+
+    while (planes_found < max_planes) {
+        // Assez de points restants pour un nouveau plan ?
+        if (active_count < 3 || active_count < static_cast<size_t>(sampled_min_inliers)) {
+            LOGD("Plus assez de points restants (%zu) pour un plan supplémentaire.", active_count);
+            break;
+        }
+
+        // Part équitable du budget restant pour ce plan ; il faut pouvoir payer au
+        // moins un score complet.
+        const int planes_left = max_planes - planes_found;
+        PlaneSearch search;
+        search.evaluation_budget = budget_left / planes_left;
+        search.stream_key = plane_stream_key(seed, planes_found);
+        if (search.evaluation_budget < static_cast<int64_t>(active_count)) {
+            LOGD("Budget d'évaluations épuisé après %d plan(s).", planes_found);
+            break;
+        }
+
+        // Plans précédents : le premier qui tient encore est repris sans tirage ; sinon le
+        // meilleur d'entre eux devient le score à battre (terminaison anticipée, itérations).
+        bool held = false;
+        for (int i = 0; i < priors && !held; ++i) {
+            if (prior_tried[i]) continue;
+            prior_tried[i] = true; // Ses inliers ne peuvent que diminuer aux plans suivants
+            const RansacPlaneResult& prior = prior_planes[i];
+            PlaneHypothesis candidate{prior.a, prior.b, prior.c, prior.d};
+            if (inverse_depth && !metric_to_affine(prior, options, candidate)) continue;
+            const int inliers = count_inliers_kernel()(point_cloud.x.data(), point_cloud.y.data(),
+                                                       point_cloud.z.data(), active_count,
+                                                       candidate.a, candidate.b, candidate.c, candidate.d,
+                                                       threshold);
+            search.evaluations += static_cast<int64_t>(active_count);
+            const double ratio = static_cast<double>(inliers) / static_cast<double>(cloud_size);
+            held = inliers >= sampled_min_inliers &&
+                   ratio >= static_cast<double>(options.warm_start_retention) * prior.inlier_ratio;
+            if (held || inliers > search.best_inlier_count) {
+                search.best = candidate;
+                search.best_inlier_count = inliers;
             }
         }
 
-        // 2d. Mettre à jour le meilleur plan si celui-ci est meilleur
-        if (current_inlier_count > best_inlier_count) {
-            best_inlier_count = current_inlier_count;
-            best_plane_A = A;
-            best_plane_B = B;
-            best_plane_C = C;
-            best_plane_D = D;
+        if (held) {
+            ++stats.warm_starts;
+        } else {
+            find_best_plane(point_cloud, active_count, options, pool, search);
         }
-    } // Fin de la boucle RANSAC
+        budget_left -= search.evaluations;
+        stats.iterations += search.iterations;
+        stats.point_evaluations += search.evaluations;
+        stats.early_exits += search.early_exits;
 
-    LOGD("RANSAC terminé. Meilleur plan trouvé avec %d inliers.", best_inlier_count);
+        const PlaneHypothesis& best = search.best;
+        const int best_inlier_count = search.best_inlier_count;
+        LOGD("RANSAC plan %d%s : %d itérations (%d abandonnées), %lld évaluations sur %zu points, meilleur plan avec %d inliers.",
+             planes_found, held ? " (repris)" : "", search.iterations, search.early_exits,
+             static_cast<long long>(search.evaluations), active_count, best_inlier_count);
 
-    // --- Étape 3: Retourner le résultat ---
+        // --- Étape 3: Retenir le plan s'il est suffisamment bon ---
+        if (best_inlier_count < sampled_min_inliers) {
+            LOGD("Meilleur plan n'a pas assez d'inliers (%d < %d).", best_inlier_count, sampled_min_inliers);
+            break;
+        }
 
-    // Vérifier si le meilleur plan trouvé est suffisamment bon (assez d'inliers)
-    // et si l'appelant a fourni un tampon de sortie capable de recevoir au moins 1 plan.
-    if (best_inlier_count >= min_inliers && max_planes >= 1) {
         LOGD("Plan valide trouvé ! A=%.2f, B=%.2f, C=%.2f, D=%.2f",
-             best_plane_A, best_plane_B, best_plane_C, best_plane_D);
+             best.a, best.b, best.c, best.d);
 
-        // Remplir la première structure dans le tampon de sortie fourni par Dart
-        out_planes_buffer[0].a = best_plane_A;
-        out_planes_buffer[0].b = best_plane_B;
-        out_planes_buffer[0].c = best_plane_C;
-        out_planes_buffer[0].d = best_plane_D;
-        out_planes_buffer[0].inlier_count = static_cast<int32_t>(best_inlier_count); // Cast en int32_t
+        // Retirer les inliers de ce plan avant la recherche suivante (inutile après le dernier,
+        // sauf pour le raffinement). La compaction relit chaque point actif : elle compte comme
+        // une passe, et accumule au passage les moments des inliers pour le raffinement.
+        const bool last_plane = planes_found + 1 == max_planes;
+        PlaneMoments moments;
+        if (!last_plane || refine_least_squares) {
+            budget_left -= static_cast<int64_t>(active_count);
+            stats.point_evaluations += static_cast<int64_t>(active_count);
+            const size_t kept = remove_inliers(point_cloud, active_count, best, threshold,
+                                               refine_least_squares ? &moments : nullptr);
+            if (!last_plane) active_count = kept;
+        }
 
-        return 1; // Retourne 1 (nombre de plans trouvés et écrits)
-    } else {
-        if (best_inlier_count < min_inliers) {
-           LOGD("Meilleur plan n'a pas assez d'inliers (%d < %d).", best_inlier_count, min_inliers);
+        // Remplir la structure suivante dans le tampon de sortie fourni par Dart
+        if (inverse_depth) {
+            write_affine_plane_result(best, best_inlier_count, cloud_size, refine_least_squares ? &moments : nullptr,
+                                      options, out_planes_buffer[planes_found]);
+        } else {
+            write_plane_result(best, best_inlier_count, cloud_size, refine_least_squares ? &moments : nullptr,
+                               out_planes_buffer[planes_found]);
         }
-         if (max_planes < 1) {
-             LOGW("Le tampon de sortie fourni ne peut contenir aucun plan (max_planes=%d).", max_planes);
-         }
-        return 0; // Retourne 0 (aucun plan valide écrit dans le tampon)
+        ++planes_found;
     }
-}
\ No newline at end of file
+
+    // --- Étape 4 (optionnelle): Recompte pleine résolution ---
+    // Les plans ajustés sur le sous-ensemble sont recomptés, dans l'ordre de découverte,
+    // sur tous les pixels de la ROI ; chaque passe compte et retire les inliers à la fois.
+    if (recount_full && planes_found > 0) {
+        build_points(full_grid);
+        size_t remaining = point_cloud.size;
+        for (int i = 0; i < planes_found; ++i) {
+            RansacPlaneResult& out = out_planes_buffer[i];
+            PlaneHypothesis plane{out.a, out.b, out.c, out.d};
+            if (inverse_depth) metric_to_affine(out, options, plane); // d != 0 : plan issu de affine_to_metric
+            stats.point_evaluations += static_cast<int64_t>(remaining);
+            PlaneMoments moments;
+            const size_t kept = remove_inliers(point_cloud, remaining, plane, threshold,
+                                               refine_least_squares ? &moments : nullptr);
+            // Réajustement sur les inliers pleine résolution (sinon le plan est conservé).
+            if (inverse_depth) {
+                write_affine_plane_result(plane, static_cast<int>(remaining - kept), point_cloud.size,
+                                          refine_least_squares ? &moments : nullptr, options, out);
+            } else {
+                write_plane_result(plane, static_cast<int>(remaining - kept), point_cloud.size,
+                                   refine_least_squares ? &moments : nullptr, out);
+            }
+            remaining = kept;
+        }
+        LOGD("Inliers recomptés en pleine résolution sur %zu points.", point_cloud.size);
+    }
+
+    if (out_stats != nullptr) *out_stats = stats;
+    return planes_found; // Nombre de plans trouvés et écrits dans le tampon
+}
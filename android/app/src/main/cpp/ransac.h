@@ -0,0 +1,94 @@
+// android/app/src/main/cpp/ransac.h
+// En-tête interne (C++) : partagé entre ransac.cpp et le contexte de pipeline.
+// Les fonctions exportées vers Dart restent déclarées dans image_utils.h.
+
+#ifndef RANSAC_H
+#define RANSAC_H
+
+#include "image_utils.h"   // Pour RansacPlaneResult, RansacOptions, RansacStats
+#include "native_memory.h" // Pour AlignedBuffer
+#include "depth_input.h"   // Pour DepthInput
+#include "depth_pyramid.h" // Pour DepthPyramid (mode grossier -> fin)
+
+class WorkerPool;
+
+// Structure simple pour représenter un point 3D
+struct Point3D {
+    float x, y, z;
+};
+
+// Nuage de points en structure-de-tableaux (x, y, z dans trois tableaux alignés) :
+// le noyau de comptage d'inliers charge 4 (NEON/SSE) ou 8 (AVX2) coordonnées
+// contiguës à la fois, sans désentrelacement.
+struct PointCloudSoA {
+    AlignedBuffer<float> x, y, z;
+    size_t size = 0;
+
+    bool reserve(size_t count) { return x.reserve(count) && y.reserve(count) && z.reserve(count); }
+    size_t capacity() const { return x.capacity(); }
+    void clear() { size = 0; }
+
+    // La capacité doit avoir été réservée au préalable (pas de réallocation ici).
+    void push_back(float px, float py, float pz) {
+        x.data()[size] = px;
+        y.data()[size] = py;
+        z.data()[size] = pz;
+        ++size;
+    }
+
+    Point3D at(size_t i) const { return {x.data()[i], y.data()[i], z.data()[i]}; }
+};
+
+// Directions des rayons de la grille de pixels, séparables : le pixel (u, v) de
+// profondeur Z se déprojette en X = ray_x[u] * Z, Y = ray_y[v] * Z (Y vers le haut).
+// Construites pour une clé (largeur, hauteur, fx, fy, cx, cy) et reconstruites
+// seulement quand elle change (changement de caméra ou de calibration).
+struct RayTable {
+    AlignedBuffer<float> ray_x; // width valeurs : (u - cx) / fx
+    AlignedBuffer<float> ray_y; // height valeurs : -(v - cy) / fy
+    int width = 0, height = 0;
+    float fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
+
+    // Garantit des tables à jour pour la clé donnée. false si l'allocation échoue.
+    bool prepare(int width, int height, float fx, float fy, float cx, float cy);
+};
+
+// Mémoire de travail de RANSAC, réutilisable d'un appel à l'autre.
+// Le contexte de pipeline en possède une instance : le nuage de points garde
+// sa capacité entre les trames (clear() ne libère pas la mémoire), et les tables
+// de rayons ne sont reconstruites qu'au changement d'intrinsèques ou de résolution
+// (une table par niveau en mode grossier -> fin : chacune garde sa clé d'une trame à l'autre).
+// En mode multi-plans, le nuage est compacté en place après chaque plan.
+// En mode grossier -> fin sans pyramide fournie, le niveau grossier est construit dans `pyramid`.
+struct RansacScratch {
+    PointCloudSoA point_cloud;
+    RayTable rays;
+    RayTable coarse_rays; // Niveau grossier (intrinsèques divisées par 2^niveau)
+    DepthPyramid pyramid;
+};
+
+// Cœur de la détection de plans, utilisé par detect_walls_ransac[_ex|_q8] (mémoire de
+// travail locale) et par pipeline_detect_walls (mémoire de travail du contexte).
+// Retourne le nombre de plans écrits dans out_planes_buffer ; out_stats peut être nul.
+// pool : groupe de threads du contexte pour scorer les hypothèses en parallèle
+// (nul : série ; le résultat est le même).
+// prior_planes : plans de l'appel précédent, essayés avant les tirages si
+// options.warm_start vaut 1 (ne doit pas recouvrir out_planes_buffer).
+// pyramid : pyramide déjà construite pour `depth` (contexte), utilisée par le mode
+// grossier -> fin si elle contient options.coarse_level (sinon construite dans scratch).
+// rays : tables de rayons à utiliser (nul : scratch.rays ; scratch.coarse_rays pour le
+// niveau grossier).
+int ransac_detect_planes(const DepthInput& depth,
+                         int width, int height,
+                         const RansacOptions& options,
+                         RansacPlaneResult* out_planes_buffer,
+                         int max_planes,
+                         RansacScratch& scratch,
+                         RansacStats* out_stats,
+                         WorkerPool* pool = nullptr,
+                         const RansacPlaneResult* prior_planes = nullptr,
+                         int prior_count = 0,
+                         const DepthPyramid* pyramid = nullptr,
+                         RayTable* rays = nullptr);
+
+#endif // RANSAC_H
@@ -0,0 +1,202 @@
+// android/app/src/main/cpp/ransac_kernels.cpp
+
+#include "ransac_kernels.h"
+
+#include <atomic>  // Pour le noyau actif (lu par plusieurs threads)
+#include <cmath>   // Pour std::fabs
+#include <stdint.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+// --- Référence scalaire ---
+
+// Même ordre d'évaluation que les variantes vectorielles : ((a*x + b*y) + c*z) + d.
+int count_inliers_scalar(const float* x, const float* y, const float* z, size_t count,
+                         float a, float b, float c, float d, float threshold) {
+    int inliers = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const float distance = std::fabs(a * x[i] + b * y[i] + c * z[i] + d);
+        if (distance < threshold) {
+            inliers++;
+        }
+    }
+    return inliers;
+}
+
+
+// --- NEON (arm64) ---
+// Uniquement sur aarch64 : sur armv7, NEON met les dénormaux à zéro et ne serait
+// pas identique bit à bit à la référence scalaire.
+
+#if defined(__aarch64__)
+static int count_inliers_neon(const float* x, const float* y, const float* z, size_t count,
+                              float a, float b, float c, float d, float threshold) {
+    const float32x4_t va = vdupq_n_f32(a);
+    const float32x4_t vb = vdupq_n_f32(b);
+    const float32x4_t vc = vdupq_n_f32(c);
+    const float32x4_t vd = vdupq_n_f32(d);
+    const float32x4_t vthr = vdupq_n_f32(threshold);
+    uint32x4_t acc = vdupq_n_u32(0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // vmulq + vaddq séparés (pas de vfmaq) pour garder l'arrondi de la référence.
+        float32x4_t t = vmulq_f32(va, vld1q_f32(x + i));
+        t = vaddq_f32(t, vmulq_f32(vb, vld1q_f32(y + i)));
+        t = vaddq_f32(t, vmulq_f32(vc, vld1q_f32(z + i)));
+        t = vaddq_f32(t, vd);
+        const uint32x4_t inside = vcltq_f32(vabsq_f32(t), vthr); // 0xFFFFFFFF si inlier
+        acc = vsubq_u32(acc, inside);                              // -(-1) = +1
+    }
+    int inliers = static_cast<int>(vaddvq_u32(acc));
+    return inliers + count_inliers_scalar(x + i, y + i, z + i, count - i, a, b, c, d, threshold);
+}
+#endif
+
+
+// --- SSE2 / AVX2 (x86) ---
+
+#if defined(__SSE2__)
+static int count_inliers_sse2(const float* x, const float* y, const float* z, size_t count,
+                              float a, float b, float c, float d, float threshold) {
+    const __m128 va = _mm_set1_ps(a);
+    const __m128 vb = _mm_set1_ps(b);
+    const __m128 vc = _mm_set1_ps(c);
+    const __m128 vd = _mm_set1_ps(d);
+    const __m128 vthr = _mm_set1_ps(threshold);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128i acc = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 t = _mm_mul_ps(va, _mm_loadu_ps(x + i));
+        t = _mm_add_ps(t, _mm_mul_ps(vb, _mm_loadu_ps(y + i)));
+        t = _mm_add_ps(t, _mm_mul_ps(vc, _mm_loadu_ps(z + i)));
+        t = _mm_add_ps(t, vd);
+        const __m128 inside = _mm_cmplt_ps(_mm_and_ps(t, abs_mask), vthr); // fabs = bit de signe à 0
+        acc = _mm_sub_epi32(acc, _mm_castps_si128(inside));
+    }
+    int32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    const int inliers = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return inliers + count_inliers_scalar(x + i, y + i, z + i, count - i, a, b, c, d, threshold);
+}
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NATIVE_HAS_AVX2_KERNEL 1
+// Compilé pour AVX2 via l'attribut target : le reste de la bibliothèque reste
+// compatible avec tous les processeurs x86_64, la variante n'est choisie que
+// si __builtin_cpu_supports("avx2") le permet. Pas de FMA (identité bit à bit).
+__attribute__((target("avx2")))
+static int count_inliers_avx2(const float* x, const float* y, const float* z, size_t count,
+                              float a, float b, float c, float d, float threshold) {
+    const __m256 va = _mm256_set1_ps(a);
+    const __m256 vb = _mm256_set1_ps(b);
+    const __m256 vc = _mm256_set1_ps(c);
+    const __m256 vd = _mm256_set1_ps(d);
+    const __m256 vthr = _mm256_set1_ps(threshold);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256i acc = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 t = _mm256_mul_ps(va, _mm256_loadu_ps(x + i));
+        t = _mm256_add_ps(t, _mm256_mul_ps(vb, _mm256_loadu_ps(y + i)));
+        t = _mm256_add_ps(t, _mm256_mul_ps(vc, _mm256_loadu_ps(z + i)));
+        t = _mm256_add_ps(t, vd);
+        const __m256 inside = _mm256_cmp_ps(_mm256_and_ps(t, abs_mask), vthr, _CMP_LT_OQ);
+        acc = _mm256_sub_epi32(acc, _mm256_castps_si256(inside));
+    }
+    int32_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    int inliers = 0;
+    for (int lane = 0; lane < 8; ++lane) inliers += lanes[lane];
+    return inliers + count_inliers_scalar(x + i, y + i, z + i, count - i, a, b, c, d, threshold);
+}
+#endif
+
+
+// --- Sélection à l'exécution ---
+
+namespace {
+
+struct KernelEntry {
+    CountInliersFn fn;
+    const char* name;
+};
+
+// Retourne la variante demandée, ou {nullptr, nullptr} si elle n'existe pas ici.
+KernelEntry lookup_kernel(RansacKernel kernel) {
+    switch (kernel) {
+        case RansacKernel::Scalar:
+            return {count_inliers_scalar, "scalar"};
+        case RansacKernel::Neon:
+#if defined(__aarch64__)
+            return {count_inliers_neon, "neon"};
+#else
+            break;
+#endif
+        case RansacKernel::Sse2:
+#if defined(__SSE2__)
+            return {count_inliers_sse2, "sse2"};
+#else
+            break;
+#endif
+        case RansacKernel::Avx2:
+#if defined(NATIVE_HAS_AVX2_KERNEL)
+            if (__builtin_cpu_supports("avx2")) return {count_inliers_avx2, "avx2"};
+#endif
+            break;
+        case RansacKernel::Auto: {
+            // Par ordre de préférence : la première variante disponible gagne.
+            const RansacKernel order[] = {RansacKernel::Avx2, RansacKernel::Neon,
+                                          RansacKernel::Sse2, RansacKernel::Scalar};
+            for (RansacKernel candidate : order) {
+                KernelEntry entry = lookup_kernel(candidate);
+                if (entry.fn != nullptr) return entry;
+            }
+            break;
+        }
+    }
+    return {nullptr, nullptr};
+}
+
+std::atomic<CountInliersFn> g_active_kernel{nullptr};
+std::atomic<const char*> g_active_kernel_name{nullptr};
+
+} // namespace
+
+CountInliersFn count_inliers_kernel() {
+    CountInliersFn fn = g_active_kernel.load(std::memory_order_acquire);
+    if (fn == nullptr) {
+        // Premier appel : choix automatique. Deux threads peuvent faire ce choix en
+        // même temps ; ils obtiennent le même résultat, la course est sans effet.
+        set_count_inliers_kernel(RansacKernel::Auto);
+        fn = g_active_kernel.load(std::memory_order_acquire);
+    }
+    return fn;
+}
+
+bool set_count_inliers_kernel(RansacKernel kernel) {
+    const KernelEntry entry = lookup_kernel(kernel);
+    if (entry.fn == nullptr) return false;
+    g_active_kernel_name.store(entry.name, std::memory_order_release);
+    g_active_kernel.store(entry.fn, std::memory_order_release);
+    LOGD("Noyau de comptage d'inliers RANSAC : %s", entry.name);
+    return true;
+}
+
+const char* count_inliers_kernel_name() {
+    count_inliers_kernel(); // Garantit qu'un noyau a été choisi
+    return g_active_kernel_name.load(std::memory_order_acquire);
+}
@@ -0,0 +1,41 @@
+// android/app/src/main/cpp/ransac_kernels.h
+// En-tête interne (C++) : noyaux de comptage d'inliers de RANSAC.
+
+#ifndef RANSAC_KERNELS_H
+#define RANSAC_KERNELS_H
+
+#include <stddef.h> // Pour size_t
+
+// Compte les points (x[i], y[i], z[i]) tels que |a*x + b*y + c*z + d| < threshold.
+// Disposition structure-de-tableaux : x, y, z sont trois tableaux de `count` floats.
+//
+// Toutes les variantes calculent exactement la même suite d'opérations IEEE
+// (((a*x + b*y) + c*z) + d, sans FMA ; la cible est compilée avec -ffp-contract=off),
+// donc leurs résultats sont identiques bit à bit à ceux de la référence scalaire.
+typedef int (*CountInliersFn)(const float* x, const float* y, const float* z, size_t count,
+                              float a, float b, float c, float d, float threshold);
+
+// Variantes disponibles (toutes ne sont pas compilées sur toutes les architectures).
+enum class RansacKernel {
+    Auto,   // Meilleure variante supportée par le processeur (choix à l'exécution)
+    Scalar, // Référence scalaire
+    Neon,   // arm64
+    Sse2,   // x86 / x86_64
+    Avx2,   // x86_64, si le processeur le supporte
+};
+
+// Référence scalaire (toujours disponible).
+int count_inliers_scalar(const float* x, const float* y, const float* z, size_t count,
+                         float a, float b, float c, float d, float threshold);
+
+// Noyau actif (choisi à l'exécution au premier appel, puis mis en cache).
+CountInliersFn count_inliers_kernel();
+
+// Force une variante (benchmarks, comparaison avec la référence). Retourne false si
+// elle n'est pas disponible sur ce processeur ; le noyau actif est alors inchangé.
+bool set_count_inliers_kernel(RansacKernel kernel);
+
+// Nom de la variante active, pour les logs et les benchmarks.
+const char* count_inliers_kernel_name();
+
+#endif // RANSAC_KERNELS_H
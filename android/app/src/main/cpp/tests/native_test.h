@@ -0,0 +1,76 @@
+// android/app/src/main/cpp/tests/native_test.h
+// Mini-cadre des tests natifs (Linux) : enregistrement des cas, vérifications et
+// comptage des échecs, sans dépendance externe.
+//
+//   NATIVE_TEST(suite, nom) { CHECK(condition); CHECKF(condition, "format", ...); }
+//
+// native_tests [suite] exécute tous les cas (ou ceux de la suite donnée) et renvoie 1
+// au moindre échec. Chaque suite est enregistrée à part dans ctest (voir CMakeLists.txt).
+
+#ifndef NATIVE_TEST_H
+#define NATIVE_TEST_H
+
+#include <cstdio>
+#include <vector>
+
+namespace native_test {
+
+using TestFn = void (*)();
+
+struct TestCase {
+    const char* suite;
+    const char* name;
+    TestFn fn;
+};
+
+// Cas enregistrés (ordre des fichiers, puis ordre de déclaration).
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+// Échecs du cas en cours (remis à zéro avant chaque cas).
+inline int& current_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* suite, const char* name, TestFn fn) { registry().push_back({suite, name, fn}); }
+};
+
+// Les premiers échecs d'un cas sont détaillés ; les suivants sont seulement comptés
+// (une boucle sur 65536 pixels ne doit pas noyer la sortie).
+constexpr int kMaxReportedFailures = 10;
+
+inline bool report_failure(const char* file, int line, const char* expression) {
+    if (++current_failures() <= kMaxReportedFailures) {
+        std::fprintf(stderr, "%s:%d : échec : %s\n", file, line, expression);
+        return true;
+    }
+    return false;
+}
+
+} // namespace native_test
+
+#define NATIVE_TEST(suite, name)                                                             \
+    static void suite##_##name();                                                            \
+    static const native_test::Registrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition)                                                             \
+    do {                                                                             \
+        if (!(condition)) native_test::report_failure(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+// CHECK, avec le contexte de l'échec (valeurs, indices) sur une seconde ligne.
+#define CHECKF(condition, ...)                                                             \
+    do {                                                                                   \
+        if (!(condition) && native_test::report_failure(__FILE__, __LINE__, #condition)) { \
+            std::fprintf(stderr, "    ");                                                  \
+            std::fprintf(stderr, __VA_ARGS__);                                             \
+            std::fprintf(stderr, "\n");                                                    \
+        }                                                                                  \
+    } while (0)
+
+#endif // NATIVE_TEST_H
@@ -0,0 +1,28 @@
+// android/app/src/main/cpp/tests/native_test_main.cpp
+// Exécution des tests natifs : native_tests [suite]
+
+#include "native_test.h"
+
+#include <cstring>
+
+int main(int argc, char** argv) {
+    const char* suite = argc > 1 ? argv[1] : nullptr;
+    int run = 0, failed = 0;
+    for (const native_test::TestCase& test : native_test::registry()) {
+        if (suite != nullptr && std::strcmp(suite, test.suite) != 0) continue;
+        native_test::current_failures() = 0;
+        test.fn();
+        const int failures = native_test::current_failures();
+        std::printf("%-8s %s.%s", failures == 0 ? "ok" : "ÉCHEC", test.suite, test.name);
+        if (failures > 0) std::printf(" (%d vérification(s))", failures);
+        std::printf("\n");
+        run++;
+        if (failures > 0) failed++;
+    }
+    if (run == 0) {
+        std::fprintf(stderr, "native_tests : aucun cas pour la suite « %s »\n", suite != nullptr ? suite : "");
+        return 1;
+    }
+    std::printf("native_tests : %d cas, %d en échec\n", run, failed);
+    return failed == 0 ? 0 : 1;
+}
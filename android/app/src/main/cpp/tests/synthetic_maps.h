@@ -0,0 +1,51 @@
+// android/app/src/main/cpp/tests/synthetic_maps.h
+// Cartes de profondeur synthétiques et tirages déterministes des tests natifs.
+
+#ifndef SYNTHETIC_MAPS_H
+#define SYNTHETIC_MAPS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace native_test {
+
+constexpr int kMapSize = 256; // Sortie du modèle MiDaS
+
+// Générateur congruentiel linéaire : même suite sur toutes les plateformes.
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state;
+    }
+    // Uniforme dans [0, 1].
+    float uniform() { return ((next() >> 8) & 0xFFFF) / 65535.0f; }
+};
+
+// Profondeur inverse d'un couloir vu de face (même scène que native_bench) : deux murs,
+// sol et plafond plans, fond lointain, bruit déterministe de ±noise / 2.
+inline std::vector<float> make_corridor_depth(int size = kMapSize, float noise = 0.004f) {
+    std::vector<float> depth(static_cast<size_t>(size) * size);
+    const float f = size * 0.8f;
+    const float c = size * 0.5f;
+    const float half_width = 1.2f, half_height = 1.3f, far = 12.0f;
+    Lcg rng(12345u);
+    for (int v = 0; v < size; ++v) {
+        for (int u = 0; u < size; ++u) {
+            const float rx = (u - c) / f;
+            const float ry = (v - c) / f;
+            float z = far;
+            if (rx != 0.0f) z = std::min(z, half_width / std::fabs(rx));
+            if (ry != 0.0f) z = std::min(z, half_height / std::fabs(ry));
+            depth[static_cast<size_t>(v) * size + u] = 1.0f / z + (rng.uniform() - 0.5f) * noise;
+        }
+    }
+    return depth;
+}
+
+} // namespace native_test
+
+#endif // SYNTHETIC_MAPS_H
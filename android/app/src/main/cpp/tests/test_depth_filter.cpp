@@ -0,0 +1,153 @@
+// android/app/src/main/cpp/tests/test_depth_filter.cpp
+// Filtre temporel de la carte de profondeur : mesures NaN, sauts, et identité bit à
+// bit des passes vectorielles avec la formule scalaire.
+
+#include "native_test.h"
+#include "synthetic_maps.h"
+
+#include "image_utils.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using native_test::kMapSize;
+
+// Référence : un pixel à la fois, dans l'ordre d'opérations documenté (sans FMA).
+float reference_pixel(float state, float x, float alpha, float jump) {
+    if (std::isnan(x)) return state;
+    const float diff = x - state;
+    if (!(std::fabs(diff) <= (jump > 0.0f ? jump : INFINITY))) return x;
+    return state + alpha * diff;
+}
+
+bool same_bits(const float* a, const float* b, size_t count) {
+    return std::memcmp(a, b, count * sizeof(float)) == 0;
+}
+
+// Valeurs particulières mêlées aux mesures et aux estimations.
+const float kSpecials[] = {std::nanf(""), INFINITY, -INFINITY, 0.0f, -0.0f, 1e-30f, 0.5f, 0.6f};
+constexpr size_t kSpecialCount = sizeof(kSpecials) / sizeof(kSpecials[0]);
+
+} // namespace
+
+NATIVE_TEST(depth_filter, matches_scalar_reference) {
+    // Toutes les longueurs de 1 à 67 (queues plus courtes qu'un registre), débuts non
+    // alignés, NaN et infinis en mesure comme en estimation, écarts au voisinage du seuil.
+    constexpr size_t kMaxCount = 67, kMaxOffset = 3, kSize = kMaxCount + kMaxOffset;
+    native_test::Lcg rng(5u);
+    std::vector<float> state0(kSize), values(kSize);
+    for (size_t i = 0; i < kSize; ++i) {
+        state0[i] = rng.uniform();
+        values[i] = state0[i] + (rng.uniform() - 0.5f) * 0.4f;
+        if (i % 3 == 0) values[i] = kSpecials[(i / 3) % kSpecialCount];
+        if (i % 11 == 4) state0[i] = kSpecials[(i / 11) % kSpecialCount];
+        if (i % 13 == 7) values[i] = state0[i] + 0.125f; // Écart arrondi de part et d'autre du seuil
+    }
+    const float alphas[] = {0.3f, 1.0f};
+    const float jumps[] = {0.125f, 0.0f, -1.0f}; // <= 0 : jamais de saut
+    for (float alpha : alphas) {
+        for (float jump : jumps) {
+            for (size_t offset = 0; offset <= kMaxOffset; ++offset) {
+                for (size_t count = 1; count <= kMaxCount; ++count) {
+                    std::vector<float> got(state0), expected(state0);
+                    CHECK(temporal_filter_depth(got.data() + offset, values.data() + offset,
+                                                static_cast<int>(count), alpha, jump) == 1);
+                    for (size_t i = offset; i < offset + count; ++i) {
+                        expected[i] = reference_pixel(expected[i], values[i], alpha, jump);
+                    }
+                    CHECKF(same_bits(got.data(), expected.data(), kSize), "alpha %g, saut %g, n = %zu, décalage %zu",
+                           alpha, jump, count, offset);
+                }
+            }
+        }
+    }
+}
+
+NATIVE_TEST(depth_filter, nan_measurements_keep_the_estimate) {
+    std::vector<float> state = native_test::make_corridor_depth();
+    const std::vector<float> before = state;
+    const std::vector<float> missing(state.size(), std::nanf(""));
+    CHECK(temporal_filter_depth(state.data(), missing.data(), static_cast<int>(state.size()), 0.3f, 0.1f) == 1);
+    CHECK(same_bits(state.data(), before.data(), state.size()));
+}
+
+NATIVE_TEST(depth_filter, jumps_reset_and_small_changes_smooth) {
+    // Un obstacle apparaît (+0.5) sur la moitié gauche : repris tel quel dès la première
+    // trame ; la moitié droite scintille (±0.01) et reste lissée.
+    const int count = kMapSize;
+    std::vector<float> state(count, 0.2f), next(count);
+    for (int i = 0; i < count; ++i) next[i] = i < count / 2 ? 0.7f : 0.2f + ((i & 1) ? 0.01f : -0.01f);
+    CHECK(temporal_filter_depth(state.data(), next.data(), count, 0.25f, 0.1f) == 1);
+    for (int i = 0; i < count; ++i) {
+        const float expected = i < count / 2 ? 0.7f : 0.2f + 0.25f * (next[i] - 0.2f);
+        CHECKF(state[i] == expected, "pixel %d : %.9g au lieu de %.9g", i, state[i], expected);
+    }
+    // Sans seuil de saut, le même obstacle n'entre que d'un quart.
+    std::vector<float> no_jump(count, 0.2f);
+    CHECK(temporal_filter_depth(no_jump.data(), next.data(), count, 0.25f, 0.0f) == 1);
+    CHECK(no_jump[0] == 0.2f + 0.25f * (0.7f - 0.2f));
+    // Estimation NaN (pixel jamais mesuré) : la première mesure valide la remplace.
+    std::vector<float> unknown(count, std::nanf(""));
+    CHECK(temporal_filter_depth(unknown.data(), next.data(), count, 0.25f, 0.0f) == 1);
+    CHECK(same_bits(unknown.data(), next.data(), count));
+}
+
+NATIVE_TEST(depth_filter, rejects_invalid_parameters) {
+    std::vector<float> state(16, 0.5f), values(16, 0.7f);
+    const std::vector<float> before = state;
+    CHECK(temporal_filter_depth(state.data(), values.data(), 16, 0.0f, 0.1f) == 0);
+    CHECK(temporal_filter_depth(state.data(), values.data(), 16, 1.5f, 0.1f) == 0);
+    CHECK(temporal_filter_depth(state.data(), values.data(), 16, std::nanf(""), 0.1f) == 0);
+    CHECK(temporal_filter_depth(state.data(), values.data(), 0, 0.3f, 0.1f) == 0);
+    CHECK(temporal_filter_depth(nullptr, values.data(), 16, 0.3f, 0.1f) == 0);
+    CHECK(same_bits(state.data(), before.data(), state.size()));
+}
+
+NATIVE_TEST(depth_filter, pipeline_primes_filters_and_resets) {
+    PipelineContext* ctx = pipeline_create(0, 0, kMapSize, kMapSize, 4);
+    CHECK(ctx != nullptr);
+    if (ctx == nullptr) return;
+    const size_t count = static_cast<size_t>(kMapSize) * kMapSize;
+    const float alpha = 0.4f, jump = 0.1f;
+    float* depth = pipeline_depth_buffer(ctx);
+    const float* filtered = pipeline_filtered_depth_buffer(ctx);
+
+    // Trame 1 (avec des NaN) : l'estimation part de la mesure, 0 là où elle manque.
+    std::vector<float> frame = native_test::make_corridor_depth();
+    for (size_t i = 0; i < count; i += 97) frame[i] = std::nanf("");
+    std::vector<float> expected(count);
+    for (size_t i = 0; i < count; ++i) expected[i] = std::isnan(frame[i]) ? 0.0f : frame[i];
+    CHECK(pipeline_set_temporal_filter(ctx, 1, alpha, jump) == 1);
+    std::memcpy(depth, frame.data(), count * sizeof(float));
+    CHECK(pipeline_filter_depth(ctx) == 1);
+    CHECK(same_bits(filtered, expected.data(), count));
+
+    // Trame 2 : bruit, sauts et NaN, comparés à la référence pixel par pixel.
+    native_test::Lcg rng(8u);
+    for (size_t i = 0; i < count; ++i) {
+        const float r = rng.uniform();
+        frame[i] = r < 0.05f ? std::nanf("") : r < 0.15f ? frame[i] + 0.3f : frame[i] + (r - 0.5f) * 0.02f;
+        expected[i] = reference_pixel(expected[i], frame[i], alpha, jump);
+    }
+    std::memcpy(depth, frame.data(), count * sizeof(float));
+    CHECK(pipeline_filter_depth(ctx) == 1);
+    CHECK(same_bits(filtered, expected.data(), count));
+
+    // Après pipeline_reset_depth_filter, la trame suivante réinitialise l'estimation.
+    pipeline_reset_depth_filter(ctx);
+    const std::vector<float> fresh = native_test::make_corridor_depth(kMapSize, 0.02f);
+    std::memcpy(depth, fresh.data(), count * sizeof(float));
+    CHECK(pipeline_filter_depth(ctx) == 1);
+    CHECK(same_bits(filtered, fresh.data(), count));
+
+    // Désactivé : sans effet sur l'estimation.
+    CHECK(pipeline_set_temporal_filter(ctx, 0, alpha, jump) == 1);
+    std::memcpy(depth, frame.data(), count * sizeof(float));
+    CHECK(pipeline_filter_depth(ctx) == 1);
+    CHECK(same_bits(filtered, fresh.data(), count));
+    CHECK(pipeline_set_temporal_filter(ctx, 1, 0.0f, jump) == 0);
+    pipeline_destroy(ctx);
+}
@@ -0,0 +1,133 @@
+// android/app/src/main/cpp/tests/test_depth_integral.cpp
+// Requêtes de rectangles (tables cumulées) face à une somme directe sur les pixels.
+
+#include "native_test.h"
+#include "synthetic_maps.h"
+
+#include "image_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using native_test::kMapSize;
+
+constexpr float kThreshold = 0.3f;
+// Moyenne : différences de sommes cumulées (double) au lieu d'une somme directe, puis
+// arrondi en float ; un écart d'une unité du dernier chiffre est admis.
+constexpr float kMeanTolerance = 1e-6f;
+
+// Référence : parcours de tous les pixels du rectangle ramené à la carte.
+RegionStats reference_region(const std::vector<float>& depth, int width, int height, float threshold,
+                             const DepthRegion& region) {
+    const int x0 = std::max(0, std::min(region.x0, width)), x1 = std::max(0, std::min(region.x1, width));
+    const int y0 = std::max(0, std::min(region.y0, height)), y1 = std::max(0, std::min(region.y1, height));
+    double total = 0.0;
+    int count = 0, above = 0;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const float value = depth[static_cast<size_t>(y) * width + x];
+            if (!std::isfinite(value)) continue;
+            total += value;
+            count++;
+            if (value > threshold) above++;
+        }
+    }
+    RegionStats stats = {};
+    if (count > 0) {
+        stats.valid_count = count;
+        stats.mean = static_cast<float>(total / count);
+        stats.fraction_above = static_cast<float>(above) / static_cast<float>(count);
+    }
+    return stats;
+}
+
+// Couloir parsemé de NaN et d'infinis (pixels ignorés par les tables).
+std::vector<float> make_region_map(uint32_t seed) {
+    std::vector<float> depth = native_test::make_corridor_depth();
+    native_test::Lcg rng(seed);
+    for (float& value : depth) {
+        const float r = rng.uniform();
+        if (r < 0.02f) value = std::nanf("");
+        else if (r < 0.03f) value = INFINITY;
+        else if (r < 0.04f) value = -INFINITY;
+    }
+    return depth;
+}
+
+// Rectangles : carte entière, pixel seul, ligne, colonne, débordants (ramenés à la
+// carte), vides ou inversés (statistiques nulles), puis aléatoires de part et d'autre des bords.
+std::vector<DepthRegion> make_regions(int width, int height, uint32_t seed) {
+    std::vector<DepthRegion> regions = {
+        {0, 0, width, height}, {5, 7, 6, 8}, {0, 10, width, 11}, {20, 0, 21, height},
+        {-30, -5, 40, 25}, {width - 10, height - 10, width + 50, height + 50},
+        {12, 12, 12, 40}, {30, 20, 10, 40}, {width, 0, width + 5, height}, {-8, -8, 0, 0},
+    };
+    native_test::Lcg rng(seed);
+    for (int i = 0; i < 200; ++i) {
+        DepthRegion r;
+        r.x0 = static_cast<int32_t>(rng.uniform() * (width + 20)) - 10;
+        r.y0 = static_cast<int32_t>(rng.uniform() * (height + 20)) - 10;
+        r.x1 = r.x0 + static_cast<int32_t>(rng.uniform() * width * 0.6f);
+        r.y1 = r.y0 + static_cast<int32_t>(rng.uniform() * height * 0.6f);
+        regions.push_back(r);
+    }
+    return regions;
+}
+
+void check_regions(const char* what, const std::vector<float>& depth, const std::vector<DepthRegion>& regions,
+                   const RegionStats* got) {
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const DepthRegion& r = regions[i];
+        const RegionStats expected = reference_region(depth, kMapSize, kMapSize, kThreshold, r);
+        CHECKF(got[i].valid_count == expected.valid_count && got[i].fraction_above == expected.fraction_above &&
+                   std::fabs(got[i].mean - expected.mean) <= kMeanTolerance,
+               "%s, rectangle %zu [%d,%d[x[%d,%d[ : moyenne %.9g (%.9g), part %.9g (%.9g), valides %d (%d)",
+               what, i, r.x0, r.x1, r.y0, r.y1, got[i].mean, expected.mean, got[i].fraction_above,
+               expected.fraction_above, got[i].valid_count, expected.valid_count);
+    }
+}
+
+} // namespace
+
+NATIVE_TEST(depth_integral, regions_match_direct_sums) {
+    const std::vector<float> depth = make_region_map(3u);
+    const std::vector<DepthRegion> regions = make_regions(kMapSize, kMapSize, 4u);
+    std::vector<RegionStats> got(regions.size());
+    const int count = query_depth_regions(depth.data(), kMapSize, kMapSize, kThreshold,
+                                          regions.data(), static_cast<int>(regions.size()), got.data());
+    CHECK(count == static_cast<int>(regions.size()));
+    check_regions("carte float", depth, regions, got.data());
+}
+
+NATIVE_TEST(depth_integral, map_without_valid_pixels) {
+    std::vector<float> depth(static_cast<size_t>(kMapSize) * kMapSize, std::nanf(""));
+    for (size_t i = 0; i < depth.size(); i += 3) depth[i] = INFINITY;
+    const std::vector<DepthRegion> regions = make_regions(kMapSize, kMapSize, 5u);
+    std::vector<RegionStats> got(regions.size());
+    query_depth_regions(depth.data(), kMapSize, kMapSize, kThreshold,
+                        regions.data(), static_cast<int>(regions.size()), got.data());
+    check_regions("aucun pixel valide", depth, regions, got.data());
+}
+
+NATIVE_TEST(depth_integral, pipeline_matches_reference) {
+    const std::vector<float> depth = make_region_map(6u);
+    const std::vector<DepthRegion> regions = make_regions(kMapSize, kMapSize, 7u);
+    PipelineContext* ctx = pipeline_create(0, 0, kMapSize, kMapSize, 4);
+    CHECK(ctx != nullptr);
+    if (ctx == nullptr) return;
+    std::memcpy(pipeline_depth_buffer(ctx), depth.data(), depth.size() * sizeof(float));
+    CHECK(pipeline_build_depth_integral(ctx, kThreshold) == 1);
+    // Par lots de DEPTH_REGIONS_MAX : les tables construites une fois servent à tous.
+    for (size_t first = 0; first < regions.size(); first += DEPTH_REGIONS_MAX) {
+        const int batch = static_cast<int>(std::min<size_t>(DEPTH_REGIONS_MAX, regions.size() - first));
+        std::memcpy(pipeline_depth_regions(ctx), &regions[first], sizeof(DepthRegion) * batch);
+        CHECK(pipeline_query_depth_regions(ctx, batch) == batch);
+        const std::vector<DepthRegion> slice(regions.begin() + first, regions.begin() + first + batch);
+        check_regions("contexte", depth, slice, pipeline_depth_region_stats(ctx));
+    }
+    pipeline_destroy(ctx);
+}
@@ -0,0 +1,188 @@
+// android/app/src/main/cpp/tests/test_depth_q8.cpp
+// Chemins 8 bits (sortie quantifiée du modèle) face aux chemins float sur la carte
+// déquantifiée : les résultats doivent être identiques, pas seulement proches.
+
+#include "native_test.h"
+#include "synthetic_maps.h"
+
+#include "image_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using native_test::kMapSize;
+
+constexpr int kMaxPlanes = 6;
+constexpr uint32_t kSeed = 77u;
+
+// Carte quantifiée et sa version float, déquantifiée par la même formule que les
+// chemins 8 bits : scale * (q - zero_point).
+struct QuantizedMap {
+    const char* name;
+    int format;
+    float scale;
+    int zero_point;
+    std::vector<uint8_t> q8;
+    std::vector<float> f32;
+};
+
+// Le couloir quantifié sur [0, max] (zero_point décale la plage : en U8 avec
+// zero_point > 0, les plus petits octets donnent des valeurs négatives).
+QuantizedMap quantize(const char* name, int format, int zero_point) {
+    const std::vector<float> depth = native_test::make_corridor_depth();
+    QuantizedMap map{name, format, 0.0f, zero_point, {}, {}};
+    const float max_value = *std::max_element(depth.begin(), depth.end());
+    const int q_min = format == DEPTH_FORMAT_S8 ? -128 : 0;
+    const int q_max = format == DEPTH_FORMAT_S8 ? 127 : 255;
+    map.scale = max_value / static_cast<float>(q_max - zero_point);
+    map.q8.resize(depth.size());
+    map.f32.resize(depth.size());
+    for (size_t i = 0; i < depth.size(); ++i) {
+        const int q = std::min(q_max, std::max(q_min, static_cast<int>(std::lround(depth[i] / map.scale)) + zero_point));
+        map.q8[i] = static_cast<uint8_t>(q); // En S8, complément à deux
+        map.f32[i] = map.scale * static_cast<float>(q - zero_point);
+    }
+    return map;
+}
+
+std::vector<QuantizedMap> quantized_maps() {
+    std::vector<QuantizedMap> maps;
+    maps.push_back(quantize("U8", DEPTH_FORMAT_U8, 0));
+    maps.push_back(quantize("U8 zero_point 20", DEPTH_FORMAT_U8, 20));
+    maps.push_back(quantize("S8", DEPTH_FORMAT_S8, -128));
+    maps.push_back(quantize("S8 zero_point 0", DEPTH_FORMAT_S8, 0));
+    return maps;
+}
+
+RansacOptions q8_ransac_options(int engine, int coarse_level) {
+    RansacOptions options;
+    ransac_default_options(&options);
+    options.fx = options.fy = kMapSize * 0.8f;
+    options.cx = options.cy = kMapSize * 0.5f;
+    options.seed = kSeed;
+    options.warm_start = 0;
+    options.engine = engine;
+    options.coarse_level = coarse_level;
+    return options;
+}
+
+bool same_planes(const RansacPlaneResult* a, int a_count, const RansacStats& a_stats,
+                 const RansacPlaneResult* b, int b_count, const RansacStats& b_stats) {
+    return a_count == b_count && std::memcmp(a, b, sizeof(RansacPlaneResult) * a_count) == 0 &&
+           a_stats.iterations == b_stats.iterations && a_stats.point_evaluations == b_stats.point_evaluations;
+}
+
+} // namespace
+
+NATIVE_TEST(depth_q8, stats_match_float) {
+    for (const QuantizedMap& map : quantized_maps()) {
+        DepthStats f = {}, q = {};
+        CHECK(compute_depth_stats(map.f32.data(), kMapSize, kMapSize, 0.3f, 1.0f, &f) == 1);
+        CHECK(compute_depth_stats_q8(map.q8.data(), kMapSize, kMapSize, map.format, map.scale, map.zero_point,
+                                     0.3f, 1.0f, &q) == 1);
+        CHECKF(std::memcmp(&f, &q, sizeof(DepthStats)) == 0, "%s : max %.9g (%.9g), libres %d/%d/%d (%d/%d/%d)",
+               map.name, q.max_closeness, f.max_closeness, q.free_left, q.free_center, q.free_right,
+               f.free_left, f.free_center, f.free_right);
+    }
+}
+
+NATIVE_TEST(depth_q8, ransac_matches_float) {
+    const int variants[][2] = {{RANSAC_ENGINE_METRIC, 0}, {RANSAC_ENGINE_METRIC, 2},
+                               {RANSAC_ENGINE_INVERSE_DEPTH, 0}, {RANSAC_ENGINE_INVERSE_DEPTH, 2}};
+    for (const QuantizedMap& map : quantized_maps()) {
+        for (const auto& v : variants) {
+            const RansacOptions options = q8_ransac_options(v[0], v[1]);
+            RansacPlaneResult f[kMaxPlanes] = {}, q[kMaxPlanes] = {};
+            RansacStats f_stats = {}, q_stats = {};
+            const int f_count = detect_walls_ransac_ex(map.f32.data(), kMapSize, kMapSize, &options, f, kMaxPlanes, &f_stats);
+            const int q_count = detect_walls_ransac_q8(map.q8.data(), kMapSize, kMapSize, map.format, map.scale,
+                                                       map.zero_point, &options, q, kMaxPlanes, &q_stats);
+            CHECKF(f_count >= 2, "%s, moteur %d, niveau %d : %d plan(s)", map.name, v[0], v[1], f_count);
+            CHECKF(same_planes(f, f_count, f_stats, q, q_count, q_stats), "%s, moteur %d, niveau %d : %d plan(s) (%d)",
+                   map.name, v[0], v[1], q_count, f_count);
+        }
+    }
+}
+
+NATIVE_TEST(depth_q8, polar_blobs_and_regions_match_float) {
+    PolarObstacleOptions polar_options;
+    polar_obstacle_default_options(&polar_options);
+    polar_options.fx = polar_options.fy = kMapSize * 0.8f;
+    polar_options.cx = polar_options.cy = kMapSize * 0.5f;
+    const DepthRegion regions[] = {{0, 0, kMapSize, kMapSize}, {0, 128, 85, 256}, {85, 128, 171, 256},
+                                   {171, 128, 256, 256}, {100, 100, 156, 156}, {-5, 250, 300, 300}};
+    constexpr int kRegions = sizeof(regions) / sizeof(regions[0]);
+
+    for (const QuantizedMap& map : quantized_maps()) {
+        PolarObstacleMap f_polar = {}, q_polar = {};
+        CHECK(compute_polar_obstacles(map.f32.data(), kMapSize, kMapSize, &polar_options, &f_polar) == 1);
+        CHECK(compute_polar_obstacles_q8(map.q8.data(), kMapSize, kMapSize, map.format, map.scale, map.zero_point,
+                                         &polar_options, &q_polar) == 1);
+        CHECKF(std::memcmp(&f_polar, &q_polar, sizeof(PolarObstacleMap)) == 0, "%s : carte polaire", map.name);
+
+        ObstacleBlob f_blobs[OBSTACLE_BLOBS_MAX] = {}, q_blobs[OBSTACLE_BLOBS_MAX] = {};
+        const int f_count = detect_obstacle_blobs(map.f32.data(), kMapSize, kMapSize, 0.4f, 8, f_blobs, OBSTACLE_BLOBS_MAX);
+        const int q_count = detect_obstacle_blobs_q8(map.q8.data(), kMapSize, kMapSize, map.format, map.scale,
+                                                     map.zero_point, 0.4f, 8, q_blobs, OBSTACLE_BLOBS_MAX);
+        CHECKF(f_count > 0 && f_count == q_count && std::memcmp(f_blobs, q_blobs, sizeof(ObstacleBlob) * f_count) == 0,
+               "%s : %d composante(s) (%d)", map.name, q_count, f_count);
+
+        RegionStats f_regions[kRegions] = {}, q_regions[kRegions] = {};
+        CHECK(query_depth_regions(map.f32.data(), kMapSize, kMapSize, 0.3f, regions, kRegions, f_regions) == kRegions);
+        CHECK(query_depth_regions_q8(map.q8.data(), kMapSize, kMapSize, map.format, map.scale, map.zero_point,
+                                     0.3f, regions, kRegions, q_regions) == kRegions);
+        CHECKF(std::memcmp(f_regions, q_regions, sizeof(f_regions)) == 0, "%s : rectangles", map.name);
+    }
+}
+
+NATIVE_TEST(depth_q8, temporal_filter_matches_float) {
+    // Deux trames : la seconde décalée (petits écarts lissés, grands écarts repris).
+    for (const QuantizedMap& map : quantized_maps()) {
+        std::vector<uint8_t> next(map.q8.size());
+        std::vector<float> next_f32(map.q8.size());
+        for (size_t i = 0; i < next.size(); ++i) {
+            next[i] = static_cast<uint8_t>(map.q8[i] + (i % 7 == 0 ? 60 : 1));
+            const int q = map.format == DEPTH_FORMAT_S8 ? static_cast<int8_t>(next[i]) : next[i];
+            next_f32[i] = map.scale * static_cast<float>(q - map.zero_point);
+        }
+        std::vector<float> f_state = map.f32, q_state = map.f32;
+        const int count = static_cast<int>(next.size()) - 3; // Queue hors bloc vectoriel
+        CHECK(temporal_filter_depth(f_state.data(), next_f32.data(), count, 0.3f, 0.1f) == 1);
+        CHECK(temporal_filter_depth_q8(q_state.data(), next.data(), count, map.format, map.scale, map.zero_point,
+                                       0.3f, 0.1f) == 1);
+        CHECKF(std::memcmp(f_state.data(), q_state.data(), f_state.size() * sizeof(float)) == 0, "%s", map.name);
+    }
+}
+
+NATIVE_TEST(depth_q8, pipeline_depth_format_matches_float) {
+    // Le même contexte, carte float puis carte 8 bits (pipeline_set_depth_format).
+    PipelineContext* ctx = pipeline_create(0, 0, kMapSize, kMapSize, kMaxPlanes);
+    CHECK(ctx != nullptr);
+    if (ctx == nullptr) return;
+    *pipeline_ransac_options(ctx) = q8_ransac_options(RANSAC_ENGINE_METRIC, 0);
+    for (const QuantizedMap& map : quantized_maps()) {
+        std::memcpy(pipeline_depth_buffer(ctx), map.f32.data(), map.f32.size() * sizeof(float));
+        std::memcpy(pipeline_depth_q8_buffer(ctx), map.q8.data(), map.q8.size());
+
+        CHECK(pipeline_set_depth_format(ctx, DEPTH_FORMAT_F32, 1.0f, 0) == 1);
+        const int f_count = pipeline_detect_walls(ctx);
+        RansacPlaneResult f[kMaxPlanes];
+        std::memcpy(f, pipeline_planes_buffer(ctx), sizeof(RansacPlaneResult) * f_count);
+        const RansacStats f_stats = *pipeline_ransac_stats(ctx);
+        CHECK(pipeline_compute_depth_stats(ctx, 0.3f, 1.0f) == 1);
+        const DepthStats f_depth_stats = *pipeline_depth_stats(ctx);
+
+        CHECK(pipeline_set_depth_format(ctx, map.format, map.scale, map.zero_point) == 1);
+        const int q_count = pipeline_detect_walls(ctx);
+        CHECKF(same_planes(f, f_count, f_stats, pipeline_planes_buffer(ctx), q_count, *pipeline_ransac_stats(ctx)),
+               "%s : %d plan(s) (%d)", map.name, q_count, f_count);
+        CHECK(pipeline_compute_depth_stats(ctx, 0.3f, 1.0f) == 1);
+        CHECKF(std::memcmp(&f_depth_stats, pipeline_depth_stats(ctx), sizeof(DepthStats)) == 0, "%s", map.name);
+    }
+    CHECK(pipeline_set_depth_format(ctx, 7, 1.0f, 0) == 0);
+    pipeline_destroy(ctx);
+}
@@ -0,0 +1,163 @@
+// android/app/src/main/cpp/tests/test_obstacle_blobs.cpp
+// Composantes d'obstacles (suites + union-find) face à un remplissage par diffusion
+// en connexité 8, pixel par pixel.
+
+#include "native_test.h"
+#include "synthetic_maps.h"
+
+#include "image_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using native_test::kMapSize;
+
+// Référence : parcours en largeur depuis chaque pixel non visité, en ordre de balayage.
+// Les composantes sont donc numérotées par leur premier pixel, comme les racines de
+// l'union-find ; tri stable par aire décroissante, puis max_blobs premières.
+std::vector<ObstacleBlob> reference_blobs(const std::vector<float>& depth, int width, int height,
+                                          float threshold, int min_area, int max_blobs) {
+    std::vector<uint8_t> visited(depth.size(), 0);
+    std::vector<int> queue;
+    std::vector<ObstacleBlob> blobs;
+    for (int start = 0; start < width * height; ++start) {
+        if (visited[start] || !(depth[start] > threshold)) continue;
+        ObstacleBlob blob = {};
+        blob.x_min = blob.x_max = start % width;
+        blob.y_min = blob.y_max = start / width;
+        blob.peak_closeness = depth[start];
+        int64_t sum_x = 0, sum_y = 0;
+        queue.assign(1, start);
+        visited[start] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int i = queue[head];
+            const int x = i % width, y = i / width;
+            blob.area++;
+            sum_x += x;
+            sum_y += y;
+            blob.x_min = std::min(blob.x_min, x);
+            blob.x_max = std::max(blob.x_max, x);
+            blob.y_min = std::min(blob.y_min, y);
+            blob.y_max = std::max(blob.y_max, y);
+            blob.peak_closeness = std::max(blob.peak_closeness, depth[i]);
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int nx = x + dx, ny = y + dy;
+                    if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                    const int n = ny * width + nx;
+                    if (visited[n] || !(depth[n] > threshold)) continue;
+                    visited[n] = 1;
+                    queue.push_back(n);
+                }
+            }
+        }
+        if (blob.area < min_area) continue;
+        blob.centroid_x = static_cast<float>(static_cast<double>(sum_x) / blob.area);
+        blob.centroid_y = static_cast<float>(static_cast<double>(sum_y) / blob.area);
+        blobs.push_back(blob);
+    }
+    std::stable_sort(blobs.begin(), blobs.end(),
+                     [](const ObstacleBlob& a, const ObstacleBlob& b) { return a.area > b.area; });
+    if (static_cast<int>(blobs.size()) > max_blobs) blobs.resize(max_blobs);
+    return blobs;
+}
+
+// Carte aléatoire : une part `density` de pixels au-dessus de 0.5 (composantes de toutes
+// formes, fusions par les diagonales et par le bas), quelques NaN et infinis.
+std::vector<float> make_blob_map(int width, int height, float density, uint32_t seed) {
+    native_test::Lcg rng(seed);
+    std::vector<float> depth(static_cast<size_t>(width) * height);
+    for (float& value : depth) {
+        const float r = rng.uniform();
+        if (r < 0.03f) {
+            value = std::nanf("");
+        } else if (r < 0.035f) {
+            value = INFINITY;
+        } else {
+            value = rng.uniform() < density ? 0.5f + rng.uniform() * 0.5f : rng.uniform() * 0.5f;
+        }
+    }
+    return depth;
+}
+
+void check_blobs(const char* what, const std::vector<float>& depth, int width, int height,
+                 float threshold, int min_area, int max_blobs) {
+    const std::vector<ObstacleBlob> expected = reference_blobs(depth, width, height, threshold, min_area, max_blobs);
+    std::vector<ObstacleBlob> got(static_cast<size_t>(max_blobs));
+    const int count = detect_obstacle_blobs(depth.data(), width, height, threshold, min_area, got.data(), max_blobs);
+    CHECKF(count == static_cast<int>(expected.size()), "%s %dx%d : %d composantes au lieu de %zu",
+           what, width, height, count, expected.size());
+    if (count != static_cast<int>(expected.size())) return;
+    for (int i = 0; i < count; ++i) {
+        const ObstacleBlob& a = got[i];
+        const ObstacleBlob& b = expected[i];
+        CHECKF(a.x_min == b.x_min && a.y_min == b.y_min && a.x_max == b.x_max && a.y_max == b.y_max &&
+                   a.area == b.area && a.centroid_x == b.centroid_x && a.centroid_y == b.centroid_y &&
+                   a.peak_closeness == b.peak_closeness,
+               "%s %dx%d, composante %d : aire %d (%d), boîte [%d,%d]-[%d,%d] ([%d,%d]-[%d,%d])",
+               what, width, height, i, a.area, b.area, a.x_min, a.y_min, a.x_max, a.y_max,
+               b.x_min, b.y_min, b.x_max, b.y_max);
+    }
+}
+
+} // namespace
+
+NATIVE_TEST(obstacle_blobs, random_maps_match_flood_fill) {
+    // Largeurs de part et d'autre des 16 pixels du seuillage vectoriel, cartes d'une ligne
+    // ou d'une colonne, densités sous et au-dessus du seuil de percolation.
+    const int sizes[][2] = {{1, 1}, {1, 40}, {40, 1}, {15, 9}, {17, 31}, {37, 23}, {64, 64}, {kMapSize, kMapSize}};
+    const float densities[] = {0.2f, 0.45f, 0.6f};
+    uint32_t seed = 1;
+    for (const auto& size : sizes) {
+        for (float density : densities) {
+            const std::vector<float> depth = make_blob_map(size[0], size[1], density, seed++);
+            check_blobs("toutes", depth, size[0], size[1], 0.5f, 1, size[0] * size[1]);
+            check_blobs("min_area 6", depth, size[0], size[1], 0.5f, 6, size[0] * size[1]);
+            check_blobs("max_blobs 3", depth, size[0], size[1], 0.5f, 1, 3);
+        }
+    }
+}
+
+NATIVE_TEST(obstacle_blobs, diagonal_and_merging_shapes) {
+    // Formes dessinées : chaîne diagonale (connexité 8 seulement), U ouvert vers le haut
+    // (deux suites fusionnées par la ligne du bas), spirale, pixels isolés en bord.
+    const int w = 24, h = 20;
+    std::vector<float> depth(static_cast<size_t>(w) * h, 0.0f);
+    auto set = [&](int x, int y, float v) { depth[static_cast<size_t>(y) * w + x] = v; };
+    for (int i = 0; i < 8; ++i) set(i, i, 0.9f);                                   // Diagonale
+    for (int y = 2; y < 10; ++y) { set(12, y, 0.7f); set(18, y, 0.8f); }            // Branches du U
+    for (int x = 12; x <= 18; ++x) set(x, 10, 0.75f);                              // Base du U
+    for (int x = 2; x < 12; ++x) { set(x, 12, 0.6f); set(x, 19, 0.6f); }           // Spirale
+    for (int y = 12; y < 20; ++y) { set(2, y, 0.6f); set(11, y, 0.6f); }
+    for (int x = 4; x < 10; ++x) set(x, 14, 0.65f);
+    for (int y = 14; y < 18; ++y) set(4, y, 0.65f);
+    set(3, 13, 0.62f);                                                             // Relie les deux spirales
+    set(w - 1, 0, 0.95f);
+    set(w - 1, h - 1, 0.95f);
+    set(0, h - 1, std::nanf(""));
+    check_blobs("formes", depth, w, h, 0.5f, 1, OBSTACLE_BLOBS_MAX);
+}
+
+NATIVE_TEST(obstacle_blobs, pipeline_matches_reference) {
+    const std::vector<float> depth = make_blob_map(kMapSize, kMapSize, 0.45f, 99u);
+    PipelineContext* ctx = pipeline_create(0, 0, kMapSize, kMapSize, 4);
+    CHECK(ctx != nullptr);
+    if (ctx == nullptr) return;
+    std::memcpy(pipeline_depth_buffer(ctx), depth.data(), depth.size() * sizeof(float));
+    // Deux fois : la mémoire de travail persistante ne doit rien garder de l'appel précédent.
+    for (int run = 0; run < 2; ++run) {
+        const int count = pipeline_detect_obstacle_blobs(ctx, 0.5f, 4);
+        const std::vector<ObstacleBlob> expected =
+            reference_blobs(depth, kMapSize, kMapSize, 0.5f, 4, OBSTACLE_BLOBS_MAX);
+        CHECK(count == static_cast<int>(expected.size()));
+        for (int i = 0; i < count && i < static_cast<int>(expected.size()); ++i) {
+            CHECKF(std::memcmp(&pipeline_obstacle_blobs(ctx)[i], &expected[i], sizeof(ObstacleBlob)) == 0,
+                   "appel %d, composante %d", run + 1, i);
+        }
+    }
+    pipeline_destroy(ctx);
+}
@@ -0,0 +1,135 @@
+// android/app/src/main/cpp/tests/test_ransac_replay.cpp
+// Mode rejeu de RANSAC : même carte + même graine + mêmes options donnent les mêmes
+// plans, bit à bit, d'un appel à l'autre, quel que soit le noyau d'inliers et quel que
+// soit le nombre de threads du contexte.
+
+#include "native_test.h"
+#include "synthetic_maps.h"
+
+#include "image_utils.h"
+#include "ransac_kernels.h"
+
+#include <cstring>
+
+namespace {
+
+using native_test::kMapSize;
+
+constexpr int kMaxPlanes = 6;
+constexpr uint32_t kSeed = 1234u;
+
+struct Detection {
+    int count = 0;
+    RansacPlaneResult planes[kMaxPlanes] = {};
+    RansacStats stats = {};
+};
+
+RansacOptions replay_options(uint32_t seed, int engine, int coarse_level) {
+    RansacOptions options;
+    ransac_default_options(&options);
+    options.fx = options.fy = kMapSize * 0.8f;
+    options.cx = options.cy = kMapSize * 0.5f;
+    options.seed = seed;
+    options.warm_start = 0; // Chaque appel repart des tirages
+    options.engine = engine;
+    options.coarse_level = coarse_level;
+    return options;
+}
+
+Detection detect(const std::vector<float>& depth, const RansacOptions& options) {
+    Detection d;
+    d.count = detect_walls_ransac_ex(depth.data(), kMapSize, kMapSize, &options, d.planes, kMaxPlanes, &d.stats);
+    return d;
+}
+
+// Plans identiques bit à bit (RansacPlaneResult n'a que des champs de 4 octets : pas
+// de remplissage) et même coût.
+bool same_detection(const Detection& a, const Detection& b) {
+    return a.count == b.count &&
+           std::memcmp(a.planes, b.planes, sizeof(RansacPlaneResult) * a.count) == 0 &&
+           a.stats.iterations == b.stats.iterations &&
+           a.stats.point_evaluations == b.stats.point_evaluations &&
+           a.stats.early_exits == b.stats.early_exits &&
+           a.stats.seed == b.stats.seed;
+}
+
+// Espaces d'ajustement et modes grossier -> fin couverts par chaque cas.
+struct Variant {
+    int engine;
+    int coarse_level;
+};
+constexpr Variant kVariants[] = {{RANSAC_ENGINE_METRIC, 0}, {RANSAC_ENGINE_METRIC, 2},
+                                 {RANSAC_ENGINE_INVERSE_DEPTH, 0}, {RANSAC_ENGINE_INVERSE_DEPTH, 2}};
+
+} // namespace
+
+NATIVE_TEST(ransac_replay, same_seed_same_planes) {
+    const std::vector<float> depth = native_test::make_corridor_depth();
+    for (const Variant& v : kVariants) {
+        const RansacOptions options = replay_options(kSeed, v.engine, v.coarse_level);
+        const Detection first = detect(depth, options);
+        CHECKF(first.count >= 2, "moteur %d, niveau %d : %d plan(s)", v.engine, v.coarse_level, first.count);
+        CHECK(first.stats.seed == kSeed);
+        for (int run = 0; run < 3; ++run) {
+            CHECKF(same_detection(first, detect(depth, options)), "moteur %d, niveau %d, appel %d",
+                   v.engine, v.coarse_level, run + 2);
+        }
+    }
+}
+
+NATIVE_TEST(ransac_replay, automatic_seed_replays) {
+    // Graine 0 : tirée par l'appel et renvoyée dans les statistiques ; la recopier
+    // dans les options rejoue exactement l'appel.
+    const std::vector<float> depth = native_test::make_corridor_depth();
+    for (const Variant& v : kVariants) {
+        const Detection automatic = detect(depth, replay_options(0, v.engine, v.coarse_level));
+        CHECK(automatic.stats.seed != 0);
+        const Detection replayed = detect(depth, replay_options(automatic.stats.seed, v.engine, v.coarse_level));
+        CHECKF(same_detection(automatic, replayed), "moteur %d, niveau %d, graine %u",
+               v.engine, v.coarse_level, automatic.stats.seed);
+    }
+}
+
+NATIVE_TEST(ransac_replay, same_planes_across_kernels) {
+    const std::vector<float> depth = native_test::make_corridor_depth();
+    const RansacKernel kernels[] = {RansacKernel::Neon, RansacKernel::Sse2, RansacKernel::Avx2};
+    for (const Variant& v : kVariants) {
+        const RansacOptions options = replay_options(kSeed, v.engine, v.coarse_level);
+        CHECK(set_count_inliers_kernel(RansacKernel::Scalar));
+        const Detection reference = detect(depth, options);
+        for (RansacKernel kernel : kernels) {
+            if (!set_count_inliers_kernel(kernel)) continue; // Non compilé ou non supporté ici
+            CHECKF(same_detection(reference, detect(depth, options)), "noyau %s, moteur %d, niveau %d",
+                   count_inliers_kernel_name(), v.engine, v.coarse_level);
+        }
+    }
+    set_count_inliers_kernel(RansacKernel::Auto);
+}
+
+NATIVE_TEST(ransac_replay, same_planes_across_thread_counts) {
+    // Le contexte répartit le score des hypothèses sur ses threads : le résultat doit
+    // rester celui de l'appel sans contexte. Sur une machine à un seul cœur, le groupe
+    // est toujours série (WorkerPool::start) et seul le chemin du contexte est comparé.
+    const std::vector<float> depth = native_test::make_corridor_depth();
+    PipelineContext* ctx = pipeline_create(0, 0, kMapSize, kMapSize, kMaxPlanes);
+    CHECK(ctx != nullptr);
+    if (ctx == nullptr) return;
+    std::memcpy(pipeline_depth_buffer(ctx), depth.data(), depth.size() * sizeof(float));
+
+    for (const Variant& v : kVariants) {
+        const RansacOptions options = replay_options(kSeed, v.engine, v.coarse_level);
+        const Detection reference = detect(depth, options);
+        for (int threads : {1, 2, 4, 8}) {
+            const int started = pipeline_set_thread_count(ctx, threads);
+            *pipeline_ransac_options(ctx) = options;
+            pipeline_reset_warm_start(ctx);
+            Detection d;
+            d.count = pipeline_detect_walls(ctx);
+            std::memcpy(d.planes, pipeline_planes_buffer(ctx), sizeof(RansacPlaneResult) * d.count);
+            d.stats = *pipeline_ransac_stats(ctx);
+            CHECKF(same_detection(reference, d), "%d thread(s) demandé(s), %d démarré(s), moteur %d, niveau %d",
+                   threads, started, v.engine, v.coarse_level);
+        }
+    }
+    pipeline_destroy(ctx);
+}
@@ -0,0 +1,250 @@
+// android/app/src/main/cpp/tests/test_yuv_rotation.cpp
+// Prétraitement YUV 4:2:0 -> entrée du modèle (recadrage, rotation, redimensionnement,
+// conversion) face à une référence pixel par pixel, pour 0, 90, 180 et 270 degrés.
+
+#include "native_test.h"
+#include "synthetic_maps.h"
+
+#include "image_utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Trame YUV 4:2:0 de référence : plans pleins, sans marge (chroma (w+1)/2 x (h+1)/2).
+struct Yuv420Frame {
+    int width, height;
+    std::vector<uint8_t> y, u, v;
+    int chroma_width() const { return (width + 1) / 2; }
+    int chroma_height() const { return (height + 1) / 2; }
+};
+
+// Texture aléatoire (pas de dégradé : un mauvais pixel voisin change le résultat).
+Yuv420Frame make_frame(int width, int height, uint32_t seed) {
+    native_test::Lcg rng(seed);
+    Yuv420Frame frame{width, height, {}, {}, {}};
+    frame.y.resize(static_cast<size_t>(width) * height);
+    frame.u.resize(static_cast<size_t>(frame.chroma_width()) * frame.chroma_height());
+    frame.v.resize(frame.u.size());
+    for (uint8_t& value : frame.y) value = static_cast<uint8_t>(rng.next() >> 24);
+    for (uint8_t& value : frame.u) value = static_cast<uint8_t>(rng.next() >> 24);
+    for (uint8_t& value : frame.v) value = static_cast<uint8_t>(rng.next() >> 24);
+    return frame;
+}
+
+// La même trame dans une disposition caméra : plan Y à marge, plans chroma selon le
+// layout ; les octets de marge et d'entrelacement inutilisés valent 0xEE.
+struct PackedFrame {
+    int layout;
+    int y_stride, uv_stride, uv_pixel_stride;
+    std::vector<uint8_t> y, uv, v_only;
+    const uint8_t* u_plane = nullptr;
+    const uint8_t* v_plane = nullptr;
+};
+
+constexpr uint8_t kPadding = 0xEE;
+constexpr int kLayouts[] = {YUV_LAYOUT_I420, YUV_LAYOUT_NV12, YUV_LAYOUT_NV21, YUV_LAYOUT_STRIDED};
+
+PackedFrame pack(const Yuv420Frame& frame, int layout) {
+    PackedFrame p;
+    p.layout = layout;
+    p.y_stride = frame.width + 13;
+    p.uv_pixel_stride = layout == YUV_LAYOUT_I420 ? 1 : 2;
+    p.uv_stride = frame.chroma_width() * p.uv_pixel_stride + 7;
+    p.y.assign(static_cast<size_t>(p.y_stride) * frame.height, kPadding);
+    for (int row = 0; row < frame.height; ++row) {
+        std::memcpy(&p.y[static_cast<size_t>(row) * p.y_stride], &frame.y[static_cast<size_t>(row) * frame.width],
+                    frame.width);
+    }
+    const size_t uv_bytes = static_cast<size_t>(p.uv_stride) * frame.chroma_height() + 1;
+    p.uv.assign(uv_bytes, kPadding);
+    p.v_only.assign(uv_bytes, kPadding);
+    // NV12 : U à +0, V à +1 du même plan ; NV21 : l'inverse ; I420 et plans à part : deux tampons.
+    uint8_t* u_base = p.uv.data() + (layout == YUV_LAYOUT_NV21 ? 1 : 0);
+    uint8_t* v_base = layout == YUV_LAYOUT_NV12 ? p.uv.data() + 1
+                    : layout == YUV_LAYOUT_NV21 ? p.uv.data() : p.v_only.data();
+    for (int row = 0; row < frame.chroma_height(); ++row) {
+        for (int col = 0; col < frame.chroma_width(); ++col) {
+            const size_t src = static_cast<size_t>(row) * frame.chroma_width() + col;
+            const size_t dst = static_cast<size_t>(row) * p.uv_stride + static_cast<size_t>(col) * p.uv_pixel_stride;
+            u_base[dst] = frame.u[src];
+            v_base[dst] = frame.v[src];
+        }
+    }
+    p.u_plane = u_base;
+    p.v_plane = v_base;
+    return p;
+}
+
+struct Crop {
+    int x, y, width, height;
+};
+
+// Échantillon d'un axe de sortie (index i sur n) dans [offset, offset + size[ :
+// centres alignés, virgule fixe 16.16, poids bilinéaire sur 8 bits, chroma au plus proche.
+struct AxisReference {
+    int i0, i1, weight, chroma;
+};
+
+AxisReference axis_reference(int i, int n, int offset, int size) {
+    const int64_t step = (static_cast<int64_t>(size) << 16) / n;
+    int64_t pos = (static_cast<int64_t>(offset) << 16) + step / 2 - (1 << 15) + step * i;
+    if (pos < (static_cast<int64_t>(offset) << 16)) pos = static_cast<int64_t>(offset) << 16;
+    const int last = offset + size - 1;
+    AxisReference a;
+    a.i0 = std::min(static_cast<int>(pos >> 16), last);
+    a.i1 = std::min(a.i0 + 1, last);
+    a.weight = static_cast<int>((pos >> 8) & 0xFF);
+    a.chroma = (a.weight >= 128 ? a.i1 : a.i0) >> 1;
+    return a;
+}
+
+uint8_t clamp_u8(int value) { return static_cast<uint8_t>(std::min(255, std::max(0, value))); }
+
+// Pixel (ox, oy) de la sortie tournée : le pixel (dx, dy) de l'image redimensionnée
+// sans rotation (rw x rh), d'après la rotation horaire, puis BT.601 plage limitée.
+void reference_pixel(const Yuv420Frame& f, const Crop& crop, int rotation, int out_w, int out_h,
+                     int ox, int oy, uint8_t* rgb) {
+    const bool transposed = rotation == 90 || rotation == 270;
+    const int rw = transposed ? out_h : out_w;
+    const int rh = transposed ? out_w : out_h;
+    int dx = ox, dy = oy;
+    if (rotation == 90) { dx = oy; dy = rh - 1 - ox; }
+    if (rotation == 180) { dx = rw - 1 - ox; dy = rh - 1 - oy; }
+    if (rotation == 270) { dx = rw - 1 - oy; dy = ox; }
+
+    const AxisReference col = axis_reference(dx, rw, crop.x, crop.width);
+    const AxisReference row = axis_reference(dy, rh, crop.y, crop.height);
+    auto luma_at = [&](int x, int y) { return static_cast<int>(f.y[static_cast<size_t>(y) * f.width + x]); };
+    const int top = luma_at(col.i0, row.i0) * (256 - col.weight) + luma_at(col.i1, row.i0) * col.weight;
+    const int bottom = luma_at(col.i0, row.i1) * (256 - col.weight) + luma_at(col.i1, row.i1) * col.weight;
+    const int luma = (top * (256 - row.weight) + bottom * row.weight + (1 << 15)) >> 16;
+    const size_t chroma = static_cast<size_t>(row.chroma) * f.chroma_width() + col.chroma;
+
+    const int c = (luma - 16) * 298, d = f.u[chroma] - 128, e = f.v[chroma] - 128;
+    rgb[0] = clamp_u8((c + 409 * e + 128) >> 8);
+    rgb[1] = clamp_u8((c - 100 * d - 208 * e + 128) >> 8);
+    rgb[2] = clamp_u8((c + 516 * d + 128) >> 8);
+}
+
+std::vector<uint8_t> preprocess(const PackedFrame& p, const Yuv420Frame& f, int rotation, const Crop& crop,
+                                int out_w, int out_h) {
+    std::vector<uint8_t> out(static_cast<size_t>(out_w) * out_h * 3, 0);
+    const int ok = preprocess_yuv420_to_model_input(p.y.data(), p.u_plane, p.v_plane, f.width, f.height,
+                                                    p.y_stride, p.uv_stride, p.uv_pixel_stride, rotation,
+                                                    crop.x, crop.y, crop.width, crop.height,
+                                                    out.data(), out_w, out_h);
+    CHECKF(ok == 1, "rotation %d, %dx%d", rotation, out_w, out_h);
+    return out;
+}
+
+// Cas : réduction d'une trame caméra, recadrage impair d'une petite trame à dimensions
+// impaires, agrandissement.
+struct Case {
+    int width, height;
+    Crop crop;
+    int out_w, out_h; // Sortie sans rotation (échangées à 90 et 270)
+};
+constexpr Case kCases[] = {
+    {640, 480, {0, 0, 0, 0}, 256, 256},
+    {101, 67, {3, 5, 90, 59}, 48, 36},
+    {32, 24, {0, 0, 0, 0}, 70, 50},
+};
+
+} // namespace
+
+NATIVE_TEST(yuv_rotation, matches_reference_in_every_layout) {
+    uint32_t seed = 10;
+    for (const Case& c : kCases) {
+        const Yuv420Frame frame = make_frame(c.width, c.height, seed++);
+        const Crop crop = c.crop.width > 0 ? c.crop : Crop{0, 0, c.width, c.height};
+        for (int layout : kLayouts) {
+            const PackedFrame packed = pack(frame, layout);
+            CHECK(yuv420_layout(packed.u_plane, packed.v_plane, packed.uv_pixel_stride) == layout);
+            for (int rotation : {0, 90, 180, 270}) {
+                const bool transposed = rotation == 90 || rotation == 270;
+                const int out_w = transposed ? c.out_h : c.out_w;
+                const int out_h = transposed ? c.out_w : c.out_h;
+                const std::vector<uint8_t> got = preprocess(packed, frame, rotation, c.crop, out_w, out_h);
+                int mismatches = 0;
+                for (int oy = 0; oy < out_h; ++oy) {
+                    for (int ox = 0; ox < out_w; ++ox) {
+                        uint8_t expected[3];
+                        reference_pixel(frame, crop, rotation, out_w, out_h, ox, oy, expected);
+                        const uint8_t* pixel = &got[(static_cast<size_t>(oy) * out_w + ox) * 3];
+                        if (std::memcmp(pixel, expected, 3) != 0 && mismatches++ == 0) {
+                            CHECKF(false, "%dx%d, layout %d, rotation %d, pixel (%d, %d) : %d %d %d au lieu de %d %d %d",
+                                   c.width, c.height, layout, rotation, ox, oy, pixel[0], pixel[1], pixel[2],
+                                   expected[0], expected[1], expected[2]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+NATIVE_TEST(yuv_rotation, rotated_output_is_rotated_image) {
+    // La sortie tournée est exactement la sortie à 0 degré, tournée.
+    uint32_t seed = 20;
+    for (const Case& c : kCases) {
+        const Yuv420Frame frame = make_frame(c.width, c.height, seed++);
+        const PackedFrame packed = pack(frame, YUV_LAYOUT_NV21);
+        const std::vector<uint8_t> upright = preprocess(packed, frame, 0, c.crop, c.out_w, c.out_h);
+        for (int rotation : {90, 180, 270, -90, 450}) {
+            const int r = ((rotation % 360) + 360) % 360;
+            const bool transposed = r == 90 || r == 270;
+            const int out_w = transposed ? c.out_h : c.out_w;
+            const int out_h = transposed ? c.out_w : c.out_h;
+            const std::vector<uint8_t> got = preprocess(packed, frame, rotation, c.crop, out_w, out_h);
+            int mismatches = 0;
+            for (int oy = 0; oy < out_h; ++oy) {
+                for (int ox = 0; ox < out_w; ++ox) {
+                    int dx = ox, dy = oy;
+                    if (r == 90) { dx = oy; dy = c.out_h - 1 - ox; }
+                    if (r == 180) { dx = c.out_w - 1 - ox; dy = c.out_h - 1 - oy; }
+                    if (r == 270) { dx = c.out_w - 1 - oy; dy = ox; }
+                    const uint8_t* pixel = &got[(static_cast<size_t>(oy) * out_w + ox) * 3];
+                    const uint8_t* source = &upright[(static_cast<size_t>(dy) * c.out_w + dx) * 3];
+                    if (std::memcmp(pixel, source, 3) != 0) mismatches++;
+                }
+            }
+            CHECKF(mismatches == 0, "%dx%d, rotation %d : %d pixel(s) différent(s)", c.width, c.height, rotation,
+                   mismatches);
+        }
+    }
+}
+
+NATIVE_TEST(yuv_rotation, tensor_matches_rgb_conversion) {
+    // Tenseur float32 NCHW par bandes (transposées à 90 et 270) : identique à l'image
+    // RGB complète convertie ensuite.
+    const InputTensorFormat format = {INPUT_TENSOR_F32, INPUT_TENSOR_NCHW, {123.7f, 116.3f, 103.5f}, {58.4f, 57.1f, 57.4f}};
+    const Case& c = kCases[1];
+    const Yuv420Frame frame = make_frame(c.width, c.height, 30u);
+    const PackedFrame packed = pack(frame, YUV_LAYOUT_NV12);
+    for (int rotation : {0, 90, 180, 270}) {
+        const bool transposed = rotation == 90 || rotation == 270;
+        const int out_w = transposed ? c.out_h : c.out_w;
+        const int out_h = transposed ? c.out_w : c.out_h;
+        const std::vector<uint8_t> rgb = preprocess(packed, frame, rotation, c.crop, out_w, out_h);
+        const size_t bytes = static_cast<size_t>(input_tensor_bytes(&format, out_w, out_h));
+        std::vector<uint8_t> expected(bytes), got(bytes);
+        CHECK(convert_rgb_to_input_tensor(rgb.data(), out_w, out_h, &format, expected.data()) == 1);
+        CHECK(preprocess_yuv420_to_tensor(packed.y.data(), packed.u_plane, packed.v_plane, frame.width, frame.height,
+                                          packed.y_stride, packed.uv_stride, packed.uv_pixel_stride, rotation,
+                                          c.crop.x, c.crop.y, c.crop.width, c.crop.height,
+                                          &format, got.data(), out_w, out_h) == 1);
+        CHECKF(expected == got, "rotation %d", rotation);
+    }
+}
+
+NATIVE_TEST(yuv_rotation, rejects_invalid_rotation) {
+    const Yuv420Frame frame = make_frame(32, 24, 40u);
+    const PackedFrame packed = pack(frame, YUV_LAYOUT_NV12);
+    std::vector<uint8_t> out(16 * 16 * 3);
+    CHECK(preprocess_yuv420_to_model_input(packed.y.data(), packed.u_plane, packed.v_plane, 32, 24,
+                                           packed.y_stride, packed.uv_stride, 2, 45,
+                                           0, 0, 0, 0, out.data(), 16, 16) == 0);
+}
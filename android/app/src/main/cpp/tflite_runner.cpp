@@ -0,0 +1,146 @@
+// android/app/src/main/cpp/tflite_runner.cpp
+
+#include "tflite_runner.h"
+#include "image_utils.h" // Pour INPUT_TENSOR_* et DEPTH_FORMAT_*
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+#if NATIVE_HAS_TFLITE
+
+#include "tensorflow/lite/c/c_api.h"
+
+namespace {
+
+// Type d'élément TFLite -> INPUT_TENSOR_* (-1 : non supporté).
+int32_t input_type_of(TfLiteType type) {
+    switch (type) {
+        case kTfLiteUInt8:   return INPUT_TENSOR_U8;
+        case kTfLiteFloat32: return INPUT_TENSOR_F32;
+        case kTfLiteFloat16: return INPUT_TENSOR_F16;
+        default:             return -1;
+    }
+}
+
+// Type d'élément TFLite -> DEPTH_FORMAT_* (-1 : non supporté).
+int32_t depth_format_of(TfLiteType type) {
+    switch (type) {
+        case kTfLiteFloat32: return DEPTH_FORMAT_F32;
+        case kTfLiteUInt8:   return DEPTH_FORMAT_U8;
+        case kTfLiteInt8:    return DEPTH_FORMAT_S8;
+        default:             return -1;
+    }
+}
+
+// Entrée [1, H, W, 3] (NHWC) ou [1, 3, H, W] (NCHW), comme TFLiteService.bindInput.
+RunnerInput describe_input(const TfLiteTensor* tensor) {
+    RunnerInput input;
+    if (TfLiteTensorNumDims(tensor) != 4 || TfLiteTensorDim(tensor, 0) != 1) return input;
+    const bool nchw = TfLiteTensorDim(tensor, 1) == 3 && TfLiteTensorDim(tensor, 3) != 3;
+    if (!nchw && TfLiteTensorDim(tensor, 3) != 3) return input;
+    input.type = input_type_of(TfLiteTensorType(tensor));
+    input.layout = nchw ? INPUT_TENSOR_NCHW : INPUT_TENSOR_NHWC;
+    input.height = TfLiteTensorDim(tensor, nchw ? 2 : 1);
+    input.width = TfLiteTensorDim(tensor, nchw ? 3 : 2);
+    input.bytes = TfLiteTensorByteSize(tensor);
+    return input;
+}
+
+// Sortie [1, H, W] ou [1, H, W, 1].
+RunnerOutput describe_output(const TfLiteTensor* tensor) {
+    RunnerOutput output;
+    const int32_t dims = TfLiteTensorNumDims(tensor);
+    if ((dims != 3 && dims != 4) || TfLiteTensorDim(tensor, 0) != 1 ||
+        (dims == 4 && TfLiteTensorDim(tensor, 3) != 1)) {
+        return output;
+    }
+    output.format = depth_format_of(TfLiteTensorType(tensor));
+    const TfLiteQuantizationParams quantization = TfLiteTensorQuantizationParams(tensor);
+    if (output.format != DEPTH_FORMAT_F32) {
+        output.scale = quantization.scale;
+        output.zero_point = quantization.zero_point;
+    }
+    output.height = TfLiteTensorDim(tensor, 1);
+    output.width = TfLiteTensorDim(tensor, 2);
+    output.bytes = TfLiteTensorByteSize(tensor);
+    return output;
+}
+
+} // namespace
+
+bool TfLiteRunner::available() { return true; }
+
+bool TfLiteRunner::load(const char* model_path, int thread_count) {
+    reset();
+    if (!model_file_.open(model_path)) return false;
+    // TfLiteModelCreate ne copie pas les octets : la projection vit autant que le modèle.
+    model_ = TfLiteModelCreate(model_file_.data(), model_file_.size());
+    if (model_ == nullptr) {
+        LOGE("TfLiteRunner : modèle illisible (%s)", model_path);
+        reset();
+        return false;
+    }
+    options_ = TfLiteInterpreterOptionsCreate();
+    if (thread_count > 0) TfLiteInterpreterOptionsSetNumThreads(options_, thread_count);
+    interpreter_ = TfLiteInterpreterCreate(model_, options_);
+    if (interpreter_ == nullptr || TfLiteInterpreterAllocateTensors(interpreter_) != kTfLiteOk ||
+        TfLiteInterpreterGetInputTensorCount(interpreter_) < 1 ||
+        TfLiteInterpreterGetOutputTensorCount(interpreter_) < 1) {
+        LOGE("TfLiteRunner : interpréteur non créé (%s)", model_path);
+        reset();
+        return false;
+    }
+    input_tensor_ = TfLiteInterpreterGetInputTensor(interpreter_, 0);
+    output_tensor_ = TfLiteInterpreterGetOutputTensor(interpreter_, 0);
+    input_ = describe_input(input_tensor_);
+    output_ = describe_output(output_tensor_);
+    LOGD("Modèle TFLite chargé : entrée %dx%d (type %d, disposition %d), sortie %dx%d (format %d)",
+         input_.width, input_.height, input_.type, input_.layout,
+         output_.width, output_.height, output_.format);
+    return true;
+}
+
+void TfLiteRunner::reset() {
+    if (interpreter_ != nullptr) TfLiteInterpreterDelete(interpreter_);
+    if (options_ != nullptr) TfLiteInterpreterOptionsDelete(options_);
+    if (model_ != nullptr) TfLiteModelDelete(model_);
+    model_file_.reset(); // Après le modèle, qui lit la projection
+    interpreter_ = nullptr;
+    options_ = nullptr;
+    model_ = nullptr;
+    input_tensor_ = nullptr;
+    output_tensor_ = nullptr;
+    input_ = RunnerInput();
+    output_ = RunnerOutput();
+}
+
+void* TfLiteRunner::input_data() const {
+    return input_tensor_ != nullptr ? TfLiteTensorData(input_tensor_) : nullptr;
+}
+
+const void* TfLiteRunner::output_data() const {
+    return output_tensor_ != nullptr ? TfLiteTensorData(output_tensor_) : nullptr;
+}
+
+bool TfLiteRunner::invoke() {
+    return interpreter_ != nullptr && TfLiteInterpreterInvoke(interpreter_) == kTfLiteOk;
+}
+
+#else // NATIVE_HAS_TFLITE
+
+bool TfLiteRunner::available() { return false; }
+
+bool TfLiteRunner::load(const char*, int) {
+    LOGE("TfLiteRunner : bibliothèque compilée sans TFLite (NATIVE_WITH_TFLITE=OFF)");
+    return false;
+}
+
+void TfLiteRunner::reset() {}
+
+void* TfLiteRunner::input_data() const { return nullptr; }
+
+const void* TfLiteRunner::output_data() const { return nullptr; }
+
+bool TfLiteRunner::invoke() { return false; }
+
+#endif // NATIVE_HAS_TFLITE
@@ -0,0 +1,79 @@
+// android/app/src/main/cpp/tflite_runner.h
+// En-tête interne (C++) : interpréteur TFLite (API C) possédé par le contexte.
+// Compilé sans TFLite (NATIVE_HAS_TFLITE=0), load() échoue toujours et le reste du
+// pipeline fonctionne comme avant.
+
+#ifndef TFLITE_RUNNER_H
+#define TFLITE_RUNNER_H
+
+#include "mapped_file.h" // Pour MappedFile
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Types opaques de l'API C (tensorflow/lite/c/c_api.h).
+struct TfLiteModel;
+struct TfLiteInterpreterOptions;
+struct TfLiteInterpreter;
+struct TfLiteTensor;
+
+// Description du tenseur d'entrée, traduite dans les formats du pipeline.
+struct RunnerInput {
+    int32_t type = -1;    // INPUT_TENSOR_U8 / F32 / F16, -1 si non supporté
+    int32_t layout = -1;  // INPUT_TENSOR_NHWC / NCHW (canaux en deuxième dimension)
+    int width = 0;
+    int height = 0;
+    size_t bytes = 0;
+};
+
+// Description du tenseur de sortie (carte de profondeur inverse, 1 canal).
+struct RunnerOutput {
+    int32_t format = -1;  // DEPTH_FORMAT_F32 / U8 / S8, -1 si non supporté
+    float scale = 1.0f;   // Quantification (U8 / S8)
+    int32_t zero_point = 0;
+    int width = 0;
+    int height = 0;
+    size_t bytes = 0;
+};
+
+// Modèle, options et interpréteur créés au chargement ; les tenseurs sont alloués une
+// fois et restent en place d'une trame à l'autre (le prétraitement écrit directement
+// dans le tenseur d'entrée). Le modèle est construit sur la projection du fichier,
+// gardée tant qu'il est chargé.
+class TfLiteRunner {
+public:
+    TfLiteRunner() = default;
+    ~TfLiteRunner() { reset(); }
+    TfLiteRunner(const TfLiteRunner&) = delete;
+    TfLiteRunner& operator=(const TfLiteRunner&) = delete;
+
+    // true si la bibliothèque est compilée avec TFLite.
+    static bool available();
+
+    // Projette le fichier, construit le modèle sur la projection, crée l'interpréteur et
+    // alloue ses tenseurs. thread_count <= 0 : choix de TFLite. false : rien n'est chargé.
+    bool load(const char* model_path, int thread_count);
+    void reset();
+    bool loaded() const { return interpreter_ != nullptr; }
+
+    const RunnerInput& input() const { return input_; }
+    const RunnerOutput& output() const { return output_; }
+
+    // Données des tenseurs (relues à chaque appel : stables tant que rien n'est réalloué).
+    void* input_data() const;
+    const void* output_data() const;
+
+    bool invoke();
+
+private:
+    MappedFile model_file_;
+    TfLiteModel* model_ = nullptr;
+    TfLiteInterpreterOptions* options_ = nullptr;
+    TfLiteInterpreter* interpreter_ = nullptr;
+    TfLiteTensor* input_tensor_ = nullptr;
+    const TfLiteTensor* output_tensor_ = nullptr;
+    RunnerInput input_;
+    RunnerOutput output_;
+};
+
+#endif // TFLITE_RUNNER_H
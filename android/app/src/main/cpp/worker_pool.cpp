@@ -0,0 +1,156 @@
+// android/app/src/main/cpp/worker_pool.cpp
+
+#include "worker_pool.h"
+
+#include <system_error> // Pour std::system_error (création de thread refusée)
+
+#if defined(__SSE2__)
+#include <immintrin.h>  // Pour _mm_pause
+#endif
+
+// Logging (logcat sur Android, stderr ailleurs)
+#include "native_log.h"
+
+
+namespace {
+
+// Attente active avant de dormir sur une variable de condition : couvre l'écart entre
+// deux lots RANSAC (quelques µs à quelques dizaines de µs) sans payer un réveil du noyau.
+constexpr int kSpinIterations = 4000;
+
+inline void cpu_relax() {
+#if defined(__SSE2__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+} // namespace
+
+
+int WorkerPool::hardware_threads() {
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores < 1) return 1;
+    return cores < kMaxThreads ? cores : kMaxThreads;
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+int WorkerPool::start(int thread_count) {
+    stop();
+    if (thread_count <= 0) thread_count = hardware_threads();
+    if (thread_count > kMaxThreads) thread_count = kMaxThreads;
+    // Un seul cœur (ou nombre inconnu) : les threads ne feraient qu'attendre leur tour,
+    // et chaque lot paierait les réveils et changements de contexte (p90 bien pire).
+    if (thread_count > 1 && std::thread::hardware_concurrency() <= 1) {
+        LOGD("WorkerPool : un seul cœur, exécution série au lieu de %d threads.", thread_count);
+        thread_count = 1;
+    }
+
+    stopping_ = false;
+    workers_.reserve(static_cast<size_t>(thread_count - 1));
+    for (int i = 1; i < thread_count; ++i) {
+        try {
+            workers_.emplace_back(&WorkerPool::worker_loop, this);
+        } catch (const std::system_error& error) {
+            LOGW("WorkerPool : création de thread refusée (%s), %d thread(s) au lieu de %d.",
+                 error.what(), this->thread_count(), thread_count);
+            break;
+        }
+    }
+    LOGD("WorkerPool : %d thread(s), appelant compris.", this->thread_count());
+    return this->thread_count();
+}
+
+void WorkerPool::stop() {
+    if (workers_.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+    workers_.clear();
+}
+
+void WorkerPool::drain(TaskFn fn, void* context, int count) {
+    int index;
+    while ((index = next_.fetch_add(1, std::memory_order_relaxed)) < count) {
+        fn(context, index);
+        if (completed_.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            // Dernière tâche : réveille l'appelant s'il s'est endormi.
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_.notify_all();
+        }
+    }
+}
+
+void WorkerPool::run(int count, TaskFn fn, void* context) {
+    if (count <= 0) return;
+    if (workers_.empty() || count == 1) { // Exécution série
+        for (int i = 0; i < count; ++i) fn(context, i);
+        return;
+    }
+
+    {
+        // Un thread en retard peut encore tenir la boucle précédente (il n'y prendra
+        // plus de tâche) : on attend qu'il la lâche avant de publier la suivante.
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        fn_ = fn;
+        context_ = context;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        completed_.store(0, std::memory_order_relaxed);
+        ++generation_;
+        published_.store(generation_, std::memory_order_release);
+    }
+    wake_.notify_all();
+
+    drain(fn, context, count);
+
+    // Les autres threads finissent leurs dernières tâches.
+    for (int spin = 0; spin < kSpinIterations; ++spin) {
+        if (completed_.load(std::memory_order_acquire) == count) return;
+        cpu_relax();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this, count] { return completed_.load(std::memory_order_acquire) == count; });
+}
+
+void WorkerPool::worker_loop() {
+    // Les boucles publiées avant la création de ce thread ne le concernent pas.
+    uint64_t seen = published_.load(std::memory_order_acquire);
+    for (;;) {
+        for (int spin = 0; spin < kSpinIterations; ++spin) {
+            if (published_.load(std::memory_order_acquire) != seen) break;
+            cpu_relax();
+        }
+
+        TaskFn fn;
+        void* context;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+            fn = fn_;
+            context = context_;
+            count = count_;
+            ++active_;
+        }
+
+        drain(fn, context, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) done_.notify_all();
+        }
+    }
+}
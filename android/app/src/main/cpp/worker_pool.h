@@ -0,0 +1,78 @@
+// android/app/src/main/cpp/worker_pool.h
+// En-tête interne (C++) : groupe de threads persistant du contexte de pipeline.
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// Threads créés une fois (avec le contexte), réveillés pour chaque boucle parallèle.
+// parallel_for(count, task) exécute task(0) ... task(count - 1) répartis sur les
+// threads du groupe et le thread appelant, et rend la main quand toutes les tâches
+// sont terminées. Après une boucle, les threads attendent activement un court instant
+// (les lots RANSAC s'enchaînent) avant de s'endormir.
+//
+// Un seul thread appelant à la fois (le contexte n'est pas partagé entre threads).
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // (Re)crée les threads : thread_count threads au total, appelant compris, plafonné
+    // à kMaxThreads (<= 0 : hardware_threads() ; 1 : exécution série). Toujours série si
+    // le processeur n'a qu'un cœur (ou si leur nombre est inconnu).
+    // Si le système refuse des threads, le groupe se contente de ceux obtenus.
+    // Retourne le nombre de threads effectif.
+    int start(int thread_count);
+
+    // Arrête et joint les threads : les boucles suivantes s'exécutent en série.
+    void stop();
+
+    // Threads participant aux boucles, appelant compris (1 : série).
+    int thread_count() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // Exécute task(i) pour i dans [0, count). `task` doit rester valide pendant l'appel.
+    template <typename Task>
+    void parallel_for(int count, Task& task) {
+        run(count, [](void* context, int index) { (*static_cast<Task*>(context))(index); }, &task);
+    }
+
+    // Plafond du nombre de threads (au-delà, le gain de RANSAC est nul).
+    static constexpr int kMaxThreads = 8;
+
+    // Nombre de cœurs, plafonné à kMaxThreads (au moins 1).
+    static int hardware_threads();
+
+private:
+    using TaskFn = void (*)(void* context, int index);
+
+    void run(int count, TaskFn fn, void* context);
+    void worker_loop();
+    void drain(TaskFn fn, void* context, int count);
+
+    std::vector<std::thread> workers_;
+
+    // Boucle en cours (écrite sous mutex_ ; generation_ change à chaque publication).
+    std::mutex mutex_;
+    std::condition_variable wake_; // Nouvelle boucle ou arrêt
+    std::condition_variable done_; // Dernière tâche terminée, ou thread redevenu inactif
+    TaskFn fn_ = nullptr;
+    void* context_ = nullptr;
+    int count_ = 0;
+    uint64_t generation_ = 0;
+    int active_ = 0;               // Threads du groupe engagés dans une boucle
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> published_{0}; // Copie de generation_ pour l'attente active
+    std::atomic<int> next_{0};           // Prochaine tâche à prendre
+    std::atomic<int> completed_{0};      // Tâches terminées
+};
+
+#endif // WORKER_POOL_H
@@ -3,10 +3,10 @@
 // --- IMPORTS ESSENTIELS ---
 import 'dart:async';
 import 'dart:developer';    // Pour log()
-import 'dart:typed_data';   // Pour ByteData et Uint8List
+import 'dart:io';           // Pour File (modèle extrait)
+import 'dart:typed_data';   // Pour Uint8List
 
 import 'package:flutter/material.dart';
-import 'package:flutter/services.dart'; // Pour rootBundle et ByteData
 import 'package:camera/camera.dart'; // Pour CameraPreview et CameraImage
 
 // Importe tous nos services et modèles
@@ -15,8 +15,10 @@ import 'package:assistive_perception_app/services/tflite_service.dart';
 import 'package:assistive_perception_app/services/preprocessing_service.dart';
 import 'package:assistive_perception_app/services/depth_analyzer.dart';
 import 'package:assistive_perception_app/services/audio_feedback_service.dart';
+import 'package:assistive_perception_app/services/native_pipeline.dart';
 import 'package:assistive_perception_app/models/depth_analysis_result.dart';
 import 'package:assistive_perception_app/models/enums.dart';
+import 'package:assistive_perception_app/utils/ffi_bindings.dart';
 // --- FIN IMPORTS ---
 
 
@@ -73,22 +75,38 @@ class _MyHomePageState extends State<MyHomePage> with WidgetsBindingObserver {
   late final PreprocessingService _preprocessingService;
   late final DepthAnalyzer _depthAnalyzer;
   late final AudioFeedbackService _audioFeedbackService;
+  late final NativePipeline _nativePipeline; // Tampons natifs persistants (créés une fois)
 
   CameraController? _controller;
   bool _isInitializing = true;
   bool _servicesInitialized = false;
+  Future<void>? _processingLoop; // Boucle de traitement (une seule, jusqu'à dispose)
+  Completer<void>? _frameSignal; // Attente de la boucle quand aucune trame n'est déposée
+  bool _frameDeposited = false; // Dépôt survenu depuis la dernière prise de la boucle
+  bool _disposing = false; // dispose() commencé : plus de nouvelle trame traitée
+  bool _nativeInference = false; // Trame traitée en un appel natif (interpréteur TFLite du contexte)
   String _statusMessage = "Initialisation...";
 
+  // Temps jusqu'à la première trame analysée, mesuré depuis initState.
+  final Stopwatch _startupWatch = Stopwatch();
+  bool _firstFrameReported = false;
+
   @override
   void initState() {
     super.initState();
+    _startupWatch.start();
     log("MyHomePage: initState", name: "MainUI");
     WidgetsBinding.instance.addObserver(this);
 
     _cameraService = CameraService();
     _tfliteService = TFLiteService();
-    _preprocessingService = PreprocessingService();
-    _depthAnalyzer = DepthAnalyzer();
+    _nativePipeline = NativePipeline(
+      modelWidth: PreprocessingService.modelInputWidth,
+      modelHeight: PreprocessingService.modelInputHeight,
+      maxPlanes: DepthAnalyzer.RANSAC_MAX_PLANES_TO_DETECT,
+    );
+    _preprocessingService = PreprocessingService(_nativePipeline);
+    _depthAnalyzer = DepthAnalyzer(_nativePipeline);
     _audioFeedbackService = AudioFeedbackService();
 
     _initializeAsyncServices();
@@ -98,9 +116,15 @@ class _MyHomePageState extends State<MyHomePage> with WidgetsBindingObserver {
   void dispose() {
      log("MyHomePage: dispose", name: "MainUI");
      WidgetsBinding.instance.removeObserver(this);
+     _disposing = true;
+     _wakeProcessingLoop(); // La boucle en attente de trame se termine
      Future.microtask(() async {
        await _cameraService.dispose();
+       // La trame en cours peut encore tourner dans un isolat sur le contexte natif :
+       // attend la fin de la boucle avant de libérer interpréteur et contexte.
+       await _processingLoop;
        _tfliteService.dispose();
+       _nativePipeline.dispose();
        await _audioFeedbackService.dispose();
        log("MyHomePage: Services disposed", name: "MainUI");
      });
@@ -122,30 +146,32 @@ class _MyHomePageState extends State<MyHomePage> with WidgetsBindingObserver {
       }
    }
 
-  // Initialisation Asynchrone (avec test asset)
+  // Initialisation Asynchrone (modèle extrait une fois dans le stockage de l'app)
   Future<void> _initializeAsyncServices() async {
     log("Initialisation des services...", name: "MainUI");
     if (!mounted) return;
-    setState(() { _isInitializing = true; _statusMessage = "Vérification de l'asset TFLite..."; });
+    setState(() { _isInitializing = true; _statusMessage = "Extraction du modèle TFLite..."; });
 
-    // Test accès asset
-    bool assetLoadSuccess = false; String assetError = "";
-    try {
-      print(">>> TEST ASSET: Tentative de chargement...");
-      final ByteData assetData = await rootBundle.load('assets/midas_small_quant.tflite');
-      if (assetData.lengthInBytes > 0) { print(">>> TEST ASSET: SUCCÈS ! Taille: ${assetData.lengthInBytes} octets."); assetLoadSuccess = true; }
-      else { assetError = "Asset chargé mais VIDE."; print(">>> TEST ASSET: ERREUR ! $assetError"); assetLoadSuccess = false; }
-    } catch (e, stacktrace) {
-      assetError = "Impossible de charger asset. Vérifiez pubspec.yaml..."; print('!!! TEST ASSET: ERREUR FATALE ! $assetError'); print(">>> Erreur: $e\n$stacktrace"); print('!!!'); assetLoadSuccess = false;
-    }
+    // Extraction de l'asset (premier lancement seulement) : les deux interpréteurs
+    // projettent ensuite ce fichier au lieu de charger le modèle dans le tas Dart.
+    final File? modelFile = await TFLiteService.extractModel();
     if (!mounted) return;
-    if (!assetLoadSuccess) { setState(() { _isInitializing = false; _servicesInitialized = false; _statusMessage = "Erreur Asset: $assetError"; }); return; }
+    if (modelFile == null) { setState(() { _isInitializing = false; _servicesInitialized = false; _statusMessage = "Erreur Asset: modèle introuvable. Vérifiez pubspec.yaml..."; }); return; }
 
-    // Init TFLite
+    // Init TFLite : interpréteur natif du contexte si la bibliothèque l'embarque,
+    // sinon interpréteur Dart (tflite_flutter).
     setState(() { _statusMessage = "Asset OK. Chargement modèle TFLite..."; });
-    bool tfliteOk = await _tfliteService.loadModel();
+    final modelWatch = Stopwatch()..start();
+    _nativeInference = _loadNativeModel(modelFile);
     if (!mounted) return;
-    if (!tfliteOk) { setState(() { _isInitializing = false; _servicesInitialized = false; _statusMessage = "Erreur TFLite: Modèle non chargé."; }); return; }
+    if (!_nativeInference) {
+      bool tfliteOk = await _tfliteService.loadModel(modelFile);
+      if (!mounted) return;
+      if (!tfliteOk) { setState(() { _isInitializing = false; _servicesInitialized = false; _statusMessage = "Erreur TFLite: Modèle non chargé."; }); return; }
+      if (!_tfliteService.bindInput(_nativePipeline)) { setState(() { _isInitializing = false; _servicesInitialized = false; _statusMessage = "Erreur TFLite: Entrée incompatible avec le contexte natif."; }); return; }
+      if (!_tfliteService.bindOutput(_nativePipeline)) { setState(() { _isInitializing = false; _servicesInitialized = false; _statusMessage = "Erreur TFLite: Sortie incompatible avec le contexte natif."; }); return; }
+    }
+    log("Modèle chargé en ${modelWatch.elapsedMilliseconds} ms (${_memorySummary()})", name: "MainUI");
 
     // Init Audio
     setState(() { _statusMessage = "Modèle OK. Initialisation audio..."; });
@@ -161,17 +187,50 @@ class _MyHomePageState extends State<MyHomePage> with WidgetsBindingObserver {
 
     // Tout est prêt
     _controller = _cameraService.controller;
+    _preprocessingService.sensorOrientation = _cameraService.sensorOrientation;
     setState(() { _isInitializing = false; _servicesInitialized = true; _statusMessage = "Services Prêts.";});
     log("Tous les services sont initialisés.", name: "MainUI");
     _startCameraStream();
   }
 
+  // Charge le modèle extrait dans l'interpréteur natif du contexte (fichier projeté en
+  // mémoire). False si la bibliothèque est compilée sans TFLite ou si le modèle est
+  // refusé (repli sur tflite_flutter).
+  bool _loadNativeModel(File modelFile) {
+    if (_nativePipeline.isDisposed || !_nativePipeline.hasNativeInference) return false;
+    try {
+      // Normalisation des variantes float (ignorée si l'entrée du modèle est uint8).
+      _nativePipeline.setInputFormat(inputTensorF32, mean: TFLiteService.inputMean, std: TFLiteService.inputStd);
+      final int status = _nativePipeline.loadModel(modelFile.path);
+      log("Inférence native : statut $status", name: "MainUI");
+      return status == pipelineStatusOk;
+    } catch (e, stacktrace) {
+      log("Inférence native indisponible: $e", name: "MainUI", stackTrace: stacktrace);
+      return false;
+    }
+  }
+
+  // RSS courant et pic du processus, pour les journaux de démarrage.
+  String _memorySummary() {
+    final memory = NativePipeline.processMemory();
+    if (memory == null) return "RSS inconnu";
+    return "RSS ${memory.rssKb ~/ 1024} Mo, pic ${memory.peakRssKb ~/ 1024} Mo";
+  }
+
+  // Journalise une fois le temps jusqu'à la première trame analysée et le pic de RSS.
+  void _reportFirstFrame() {
+    if (_firstFrameReported) return;
+    _firstFrameReported = true;
+    _startupWatch.stop();
+    log("Première trame analysée après ${_startupWatch.elapsedMilliseconds} ms (${_memorySummary()})", name: "MainUI");
+  }
+
   // Démarrage Flux Caméra
   void _startCameraStream() {
       final CameraController? cameraController = _controller;
       if (cameraController != null && cameraController.value.isInitialized && _servicesInitialized) {
         log("Démarrage du flux caméra...", name: "MainUI");
-         _cameraService.startStreaming(_processCameraImage);
+         _cameraService.startStreaming(_onCameraImage);
          if(mounted) { setState(() { _statusMessage = "Analyse en cours..."; }); }
       } else {
          log("Impossible de démarrer le flux.", name: "MainUI");
@@ -180,35 +239,62 @@ class _MyHomePageState extends State<MyHomePage> with WidgetsBindingObserver {
    }
 
 
-  // Pipeline Traitement Image (Types Corrigés pour Buffers Plats)
-  Future<void> _processCameraImage(CameraImage image) async {
-  if (!_servicesInitialized || !mounted) return;
+  // Rappel caméra : dépose l'image (la plus récente gagne) et réveille la boucle de
+  // traitement (démarrée au premier dépôt). Ne bloque jamais sur l'analyse en cours.
+  void _onCameraImage(CameraImage image) {
+    if (!_servicesInitialized || !mounted || _disposing || _nativePipeline.isDisposed) return;
+    if (!_preprocessingService.depositCameraImage(image)) return;
+    _frameDeposited = true;
+    _processingLoop ??= _runProcessingLoop();
+    _wakeProcessingLoop();
+  }
+
+  void _wakeProcessingLoop() {
+    final Completer<void>? signal = _frameSignal;
+    _frameSignal = null;
+    signal?.complete();
+  }
+
+  // Boucle de traitement : traite la trame la plus récente, puis attend le dépôt suivant
+  // quand il n'y en a plus. Les trames arrivées pendant une analyse sont remplacées par
+  // la suivante (comptées). La boucle reste en vie : un dépôt n'est jamais perdu entre la
+  // dernière prise et l'arrêt de la boucle. Se termine après la trame en cours dès que
+  // dispose() commence.
+  Future<void> _runProcessingLoop() async {
+    while (mounted && !_disposing && !_nativePipeline.isDisposed) {
+      _frameDeposited = false;
+      if (await _processLatestFrame()) continue;
+      // Plus de trame nouvelle : attend le prochain dépôt (ou dispose), sauf si un dépôt
+      // est arrivé depuis la prise.
+      if (_disposing || _frameDeposited) continue;
+      final Completer<void> signal = _frameSignal = Completer<void>();
+      await signal.future;
+    }
+  }
+
+  // Pipeline Traitement Image (Types Corrigés pour Buffers Plats).
+  // Retourne false s'il n'y avait aucune nouvelle trame à traiter.
+  Future<bool> _processLatestFrame() async {
+  if (!_servicesInitialized || !mounted) return false;
+  if (_nativeInference) return _processLatestFrameNative();
   final processingWatch = Stopwatch()..start();
 
   try {
+    final Uint8List? inputData = await _preprocessingService.preprocessLatestFrame();
+    if (inputData == null) return false;
     print("--- Frame Start ---");
-
-    final Uint8List? inputData = await _preprocessingService.preprocessCameraImage(image);
-    if (!mounted || inputData == null) return;
+    if (!mounted) return false;
     print("--- Step 1: Preprocessing Done (inputData is OK, size=${inputData.length}) ---");
 
-    // INFÉRENCE : sortie maintenant List<List<List<List<int>>>>
-    final List<List<List<List<int>>>>? rawOutput = await _tfliteService.runInference(inputData);
-    if (!mounted || rawOutput == null) return;
-    print("--- Step 2: Inference Done (outputData is OK) ---");
-
-    // CONVERSION : vers List<List<List<List<double>>>> pour compatibilité
-    final outputData = rawOutput.map((batch) =>
-      batch.map((row) =>
-        row.map((col) =>
-          col.map((v) => v.toDouble()).toList()
-        ).toList()
-      ).toList()
-    ).toList();
-
-    final analysisResult = await _depthAnalyzer.analyzeDepthMap(outputData);
-    if (!mounted || analysisResult == null) return;
+    // INFÉRENCE : sortie écrite directement dans le tampon natif du contexte
+    final bool inferenceOk = await _tfliteService.runInference(inputData);
+    if (!mounted || !inferenceOk) return true;
+    print("--- Step 2: Inference Done (output in native buffer) ---");
+
+    final analysisResult = await _depthAnalyzer.analyzeDepthMap();
+    if (!mounted || analysisResult == null) return true;
     print("--- Step 3: Analysis Done (analysisResult is OK) ---");
+    _reportFirstFrame();
 
     print("-----------------------------------------");
     print("ANALYSE RESULT:");
@@ -218,13 +304,36 @@ class _MyHomePageState extends State<MyHomePage> with WidgetsBindingObserver {
     print("-----------------------------------------");
 
     processingWatch.stop();
-    log("Pipeline: ${processingWatch.elapsedMilliseconds} ms", name: "MainUI");
+    final mailbox = _nativePipeline.mailboxStats;
+    log("Pipeline: ${processingWatch.elapsedMilliseconds} ms (trames déposées ${mailbox.published}, traitées ${mailbox.taken}, écrasées ${mailbox.overwritten})", name: "MainUI");
   } catch (e, stacktrace) {
-    print("!!! ERREUR _processCameraImage: $e\n$stacktrace");
+    print("!!! ERREUR _processLatestFrame: $e\n$stacktrace");
     processingWatch.stop();
   }
+  return true;
 }
 
+  // Mode natif : prise de la trame puis prétraitement, inférence, analyse et RANSAC en un
+  // seul appel FFI ; seul le résultat compact revient côté Dart.
+  Future<bool> _processLatestFrameNative() async {
+    final processingWatch = Stopwatch()..start();
+    try {
+      if (_nativePipeline.isDisposed || !_nativePipeline.takeLatestFrame()) return false;
+      await _nativePipeline.processLatestFrame();
+      if (!mounted || _nativePipeline.isDisposed) return false;
+      final DepthAnalysisResult? analysisResult = _depthAnalyzer.resultFromNativeFrame();
+      if (analysisResult == null) return true;
+      _reportFirstFrame();
+
+      processingWatch.stop();
+      final mailbox = _nativePipeline.mailboxStats;
+      log("Pipeline natif: ${processingWatch.elapsedMilliseconds} ms, obstacle ${analysisResult.obstacleProximity.name}, mur ${analysisResult.wallDirection.name}, chemin libre ${analysisResult.freePathDirection.name} (trames déposées ${mailbox.published}, traitées ${mailbox.taken}, écrasées ${mailbox.overwritten})", name: "MainUI");
+    } catch (e, stacktrace) {
+      print("!!! ERREUR _processLatestFrameNative: $e\n$stacktrace");
+    }
+    return true;
+  }
+
 
 
   // --- Build UI ---
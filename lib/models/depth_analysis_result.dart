@@ -22,25 +22,38 @@ class DepthAnalysisResult {
   /// qui dépasse un certain seuil (OBSTACLE_CLOSENESS_THRESHOLD).
   final ObstacleProximity obstacleProximity;
 
+  /// Nombre d'obstacles distincts (composantes connexes plus proches que le seuil,
+  /// au plus 16).
+  final int obstacleCount;
+
   /// Indique la présence et la direction approximative d'un mur
   /// détecté à l'aide de l'algorithme RANSAC sur le nuage de points 3D
   /// généré à partir de la carte de profondeur.
   final WallDirection wallDirection;
 
-  /// Indique la direction estimée de la zone la plus praticable (dégagée),
-  /// généralement en recherchant la plus grande zone contiguë où les valeurs
-  /// de la carte de profondeur inverse sont inférieures à un seuil
-  /// (FREE_PATH_FARNESS_THRESHOLD).
+  /// Indique la direction estimée de la zone la plus praticable (dégagée) :
+  /// le plus large passage de secteurs de cap sans obstacle proche
+  /// (carte polaire d'obstacles).
   final FreePathDirection freePathDirection;
 
+  /// Cap du centre du passage libre (radians, négatif à gauche), null si aucun.
+  /// Issu de la carte polaire d'obstacles native.
+  final double? freePathHeading;
+
+  /// Largeur angulaire du passage libre (radians), null si aucun.
+  final double? freePathWidth;
+
   /// Constructeur pour créer une instance de DepthAnalysisResult.
   ///
   /// Les paramètres sont marqués comme 'required', ce qui signifie qu'ils
   /// doivent obligatoirement être fournis lors de la création de l'objet.
   const DepthAnalysisResult({
     required this.obstacleProximity,
+    this.obstacleCount = 0,
     required this.wallDirection,
     required this.freePathDirection,
+    this.freePathHeading,
+    this.freePathWidth,
   });
 
   /// Méthode pour créer une copie de cet objet avec certaines valeurs modifiées.
@@ -48,13 +61,19 @@ class DepthAnalysisResult {
   /// Non strictement nécessaire pour la Phase 1, mais bonne pratique.
   DepthAnalysisResult copyWith({
     ObstacleProximity? obstacleProximity,
+    int? obstacleCount,
     WallDirection? wallDirection,
     FreePathDirection? freePathDirection,
+    double? freePathHeading,
+    double? freePathWidth,
   }) {
     return DepthAnalysisResult(
       obstacleProximity: obstacleProximity ?? this.obstacleProximity,
+      obstacleCount: obstacleCount ?? this.obstacleCount,
       wallDirection: wallDirection ?? this.wallDirection,
       freePathDirection: freePathDirection ?? this.freePathDirection,
+      freePathHeading: freePathHeading ?? this.freePathHeading,
+      freePathWidth: freePathWidth ?? this.freePathWidth,
     );
   }
 
@@ -62,7 +81,7 @@ class DepthAnalysisResult {
   /// Par exemple, en utilisant `debugPrint(result.toString());`.
   @override
   String toString() {
-    return 'DepthAnalysisResult(obstacle: ${obstacleProximity.name}, wall: ${wallDirection.name}, path: ${freePathDirection.name})';
+    return 'DepthAnalysisResult(obstacle: ${obstacleProximity.name} ($obstacleCount), wall: ${wallDirection.name}, path: ${freePathDirection.name}, heading: ${freePathHeading?.toStringAsFixed(2)}, width: ${freePathWidth?.toStringAsFixed(2)})';
   }
 
   /// Permet de comparer deux instances de DepthAnalysisResult pour l'égalité.
@@ -73,8 +92,11 @@ class DepthAnalysisResult {
 
     return other is DepthAnalysisResult &&
         other.obstacleProximity == obstacleProximity &&
+        other.obstacleCount == obstacleCount &&
         other.wallDirection == wallDirection &&
-        other.freePathDirection == freePathDirection;
+        other.freePathDirection == freePathDirection &&
+        other.freePathHeading == freePathHeading &&
+        other.freePathWidth == freePathWidth;
   }
 
   /// Fournit un code de hachage basé sur les valeurs des champs.
@@ -83,6 +105,9 @@ class DepthAnalysisResult {
   @override
   int get hashCode =>
       obstacleProximity.hashCode ^
+      obstacleCount.hashCode ^
       wallDirection.hashCode ^
-      freePathDirection.hashCode;
+      freePathDirection.hashCode ^
+      freePathHeading.hashCode ^
+      freePathWidth.hashCode;
 }
\ No newline at end of file
@@ -10,8 +10,8 @@ import 'package:flutter/services.dart'; // Pour PlatformException
 /// Service responsable de la gestion de la caméra de l'appareil.
 ///
 /// Fournit des méthodes pour initialiser la caméra, démarrer/arrêter le flux d'images,
-/// et nettoyer les ressources. Gère également la logique essentielle pour éviter
-/// le traitement excessif des images (frame skipping).
+/// et nettoyer les ressources. Chaque image est remise immédiatement au callback :
+/// c'est au consommateur (boîte aux lettres native) de ne garder que la plus récente.
 class CameraService {
   // Contrôleur principal pour interagir avec la caméra matérielle.
   // Il est nullable (?) car il n'est pas initialisé immédiatement.
@@ -26,14 +26,6 @@ class CameraService {
   // Indique si le service et le contrôleur de caméra sont initialisés avec succès.
   bool _isInitialized = false;
 
-  // === Logique de Saut d'Image (Frame Skipping) ===
-  // Indicateur pour savoir si une image de la caméra est EN COURS de traitement
-  // par notre pipeline (pré-traitement, inférence, analyse).
-  // C'est CRUCIAL pour la performance : si nous recevons une nouvelle image alors
-  // que la précédente n'a pas fini d'être traitée, nous ignorons la nouvelle
-  // pour éviter une accumulation de latence et une surcharge du CPU/GPU.
-  bool _isProcessingFrame = false;
-
   // Indique si le flux d'images de la caméra est actuellement actif.
   bool _isStreaming = false;
 
@@ -49,6 +41,9 @@ class CameraService {
 
   bool get isStreaming => _isStreaming;
 
+  // Rotation horaire à appliquer aux images du flux pour les voir droites (degrés).
+  int get sensorOrientation => _selectedCamera?.sensorOrientation ?? 0;
+
   /// Initialise le service de caméra.
   ///
   /// Recherche les caméras disponibles, sélectionne la caméra arrière,
@@ -141,14 +136,12 @@ class CameraService {
 
   /// Démarre le flux d'images de la caméra.
   ///
-  /// [onFrameAvailable] est une fonction callback qui sera appelée pour chaque
-  /// nouvelle image reçue de la caméra. Cette fonction DOIT retourner un Future<void>
-  /// et sera attendue (`await`) pour implémenter correctement le saut d'image.
-  ///
-  /// La logique de saut d'image (`_isProcessingFrame`) est appliquée ici pour
-  /// garantir que nous ne commençons pas à traiter une nouvelle image avant
-  /// que le traitement de la précédente ne soit terminé.
-  Future<void> startStreaming(Future<void> Function(CameraImage image) onFrameAvailable) async {
+  /// [onFrameAvailable] est appelée pour CHAQUE nouvelle image reçue de la caméra.
+  /// Elle doit être courte et ne jamais attendre l'analyse : elle dépose l'image
+  /// (copie des plans dans la boîte aux lettres native) et rend la main. Le traitement
+  /// tourne à part et prend toujours l'image déposée la plus récente ; les images
+  /// arrivées pendant une analyse sont remplacées, pas mises en file.
+  Future<void> startStreaming(void Function(CameraImage image) onFrameAvailable) async {
     // Vérifie si le service est initialisé et que le contrôleur existe.
     if (!_isInitialized || _controller == null) {
       log('ERREUR: CameraService non initialisé. Impossible de démarrer le streaming.', name: 'CameraService');
@@ -162,38 +155,13 @@ class CameraService {
 
     log('Démarrage du flux d\'images...', name: 'CameraService');
     try {
-      // Réinitialise le flag de traitement au cas où.
-      _isProcessingFrame = false;
-
       // Démarre le flux d'images. La fonction fournie sera appelée pour chaque image.
-      await _controller!.startImageStream((CameraImage image) async {
-        // --- Début de la logique de Saut d'Image (Frame Skipping) ---
-        if (_isProcessingFrame) {
-          // Si une image précédente est toujours en cours de traitement,
-          // ignore cette nouvelle image et retourne immédiatement.
-          // log('Image sautée (précédente en cours de traitement)', name: 'CameraService'); // Décommenter pour déboguer le frame skipping
-          return;
-        }
-        // --- Fin de la logique de Saut d'Image ---
-
-        // Marque qu'une image est maintenant en cours de traitement.
-        _isProcessingFrame = true;
-
+      await _controller!.startImageStream((CameraImage image) {
         try {
-          // Appelle la fonction de callback fournie pour traiter l'image.
-          // Nous utilisons 'await' ici, en supposant que onFrameAvailable
-          // contient toute la logique de traitement (preprocessing, inference, analysis)
-          // et retourne un Future qui se complète quand le traitement est fini.
-          await onFrameAvailable(image);
-
+          onFrameAvailable(image);
         } catch (e) {
-          // Enregistre toute erreur survenant pendant le traitement de l'image.
+          // Enregistre toute erreur survenant pendant le dépôt de l'image.
           log('ERREUR dans le callback onFrameAvailable: $e', name: 'CameraService');
-        } finally {
-          // IMPORTANT : Assure que le flag est réinitialisé, MÊME SI une erreur
-          // se produit dans le callback onFrameAvailable.
-          // Cela permet au traitement de l'image suivante de commencer.
-          _isProcessingFrame = false;
         }
 
         // Format de l'image (CameraImage) :
@@ -239,7 +207,6 @@ class CameraService {
     try {
       await _controller!.stopImageStream();
       _isStreaming = false;
-      _isProcessingFrame = false; // Réinitialise aussi au cas où
       log('Flux d\'images arrêté.', name: 'CameraService');
     } on CameraException catch (e) {
       log('ERREUR CameraException lors de l\'arrêt du streaming: ${e.code}\n${e.description}', name: 'CameraService');
@@ -270,7 +237,6 @@ class CameraService {
     _selectedCamera = null;
     _isInitialized = false;
     _isStreaming = false;
-    _isProcessingFrame = false;
     log('CameraService libéré.', name: 'CameraService');
   }
 }
\ No newline at end of file
@@ -2,14 +2,12 @@
 
 import 'dart:ffi';          // Pour FFI (Pointer, Float, Int32)
 import 'dart:developer';    // Pour log()
-import 'dart:typed_data';   // Pour Float32List
 import 'dart:math' as math; // Importe dart:math AVEC un préfixe 'math'
 
-import 'package:ffi/ffi.dart';      // Pour calloc et free (gestion mémoire native)
-
 // Importe nos modèles de données et liaisons FFI
 import 'package:assistive_perception_app/models/enums.dart';
 import 'package:assistive_perception_app/models/depth_analysis_result.dart';
+import 'package:assistive_perception_app/services/native_pipeline.dart';
 import 'package:assistive_perception_app/utils/ffi_bindings.dart'; // Adaptez si chemin différent
 
 /// Service responsable de l'analyse de la carte de profondeur générée par TFLite (MiDaS).
@@ -17,19 +15,79 @@ import 'package:assistive_perception_app/utils/ffi_bindings.dart'; // Adaptez si
 /// pour la détection de murs.
 class DepthAnalyzer {
 
+  // Contexte natif partagé : carte de profondeur et résultats RANSAC y vivent
+  // d'une trame à l'autre (plus de calloc/free par analyse).
+  final NativePipeline _pipeline;
+
+  DepthAnalyzer(this._pipeline) {
+    // Options RANSAC réglées une fois dans le contexte (les autres gardent
+    // les valeurs de ransac_default_options : terminaison anticipée, mode adaptatif).
+    final RansacOptions options = _pipeline.ransacOptions;
+    options.fx = CAMERA_FX; // !! PLACEHOLDERS !!
+    options.fy = CAMERA_FY;
+    options.cx = CAMERA_CX;
+    options.cy = CAMERA_CY;
+    options.distanceThreshold = RANSAC_DISTANCE_THRESHOLD;
+    options.engine = ransacEngineInverseDepth;
+    options.inverseDepthThreshold = RANSAC_INVERSE_DEPTH_THRESHOLD;
+    options.minInliers = RANSAC_MIN_INLIERS;
+    options.maxIterations = RANSAC_MAX_ITERATIONS;
+    options.maxPoints = RANSAC_MAX_POINTS;
+    options.coarseLevel = RANSAC_COARSE_LEVEL;
+    options.seed = RANSAC_SEED;
+
+    // Carte polaire d'obstacles : mêmes intrinsèques que RANSAC, portée = seuil de proximité.
+    final PolarObstacleOptions polar = _pipeline.polarObstacleOptions;
+    polar.fx = CAMERA_FX;
+    polar.fy = CAMERA_FY;
+    polar.cx = CAMERA_CX;
+    polar.cy = CAMERA_CY;
+    polar.obstacleRange = 1.0 / OBSTACLE_CLOSENESS_THRESHOLD;
+    polar.minHeight = OBSTACLE_MIN_HEIGHT;
+    polar.maxHeight = OBSTACLE_MAX_HEIGHT;
+    polar.minObstaclePixels = OBSTACLE_MIN_PIXELS;
+    polar.minGapWidth = FREE_PATH_MIN_GAP_WIDTH;
+
+    // Filtre temporel natif : stabilise la carte avant les seuils et RANSAC.
+    _pipeline.setTemporalFilter(enabled: true, alpha: DEPTH_FILTER_ALPHA, jumpThreshold: DEPTH_FILTER_JUMP);
+
+    // Mêmes seuils pour le traitement de trame complet natif (NativePipeline.processLatestFrame).
+    final FrameProcessOptions frame = _pipeline.frameOptions;
+    frame.freePathThreshold = FREE_PATH_FARNESS_THRESHOLD;
+    frame.histogramMax = DEPTH_HISTOGRAM_MAX;
+    frame.obstacleThreshold = OBSTACLE_CLOSENESS_THRESHOLD;
+    frame.obstacleMinArea = OBSTACLE_MIN_BLOB_AREA;
+    frame.detectWalls = 1;
+  }
+
   // --- Constantes pour l'Analyse de Profondeur ---
   // Seuils basés sur la sortie de MiDaS (profondeur INVERSE relative).
   // + ÉLEVÉ = + PROCHE ; + BAS = + LOIN. À AJUSTER !
   static const double OBSTACLE_CLOSENESS_THRESHOLD = 0.75;
   static const double OBSTACLE_VERY_CLOSE_THRESHOLD = 0.9;
+  static const int OBSTACLE_MIN_BLOB_AREA = 32; // Pixels : composantes d'obstacles plus petites ignorées (bruit)
   static const double FREE_PATH_FARNESS_THRESHOLD = 0.25;
+  static const double DEPTH_HISTOGRAM_MAX = 1.0; // Borne haute de l'histogramme natif (32 classes)
+  static const double DEPTH_FILTER_ALPHA = 0.4; // Poids de la nouvelle trame (1.0 = pas de lissage)
+  static const double DEPTH_FILTER_JUMP = 0.2;  // Écart au-delà duquel un pixel suit la trame sans lissage
+
+  // --- Constantes pour la Carte Polaire d'Obstacles (chemin libre) ---
+  static const double OBSTACLE_MIN_HEIGHT = -1.0; // Bande de hauteur (unités de la carte, caméra = 0) : ni sol ni plafond
+  static const double OBSTACLE_MAX_HEIGHT = 1.0;
+  static const int OBSTACLE_MIN_PIXELS = 8;       // Pixels obstacles pour bloquer un secteur (bruit isolé ignoré)
+  static const double FREE_PATH_MIN_GAP_WIDTH = 0.2;  // Radians (~11°) : largeur minimale d'un passage
+  static const double FREE_PATH_CENTER_HEADING = 0.17; // Radians (~10°) : passage droit devant en deçà
 
   // --- Constantes pour RANSAC (passées à la fonction FFI) ---
   // À AJUSTER finement par expérimentation !
-  static const double RANSAC_DISTANCE_THRESHOLD = 0.08; // Mètres (approx. si intrinsics corrects)
+  static const double RANSAC_DISTANCE_THRESHOLD = 0.08; // Mètres (approx. si intrinsics corrects) ; moteur métrique seulement
+  static const double RANSAC_INVERSE_DEPTH_THRESHOLD = 0.01; // Unités de la carte MiDaS : plans ajustés en profondeur inverse
   static const int RANSAC_MIN_INLIERS = 500;
-  static const int RANSAC_MAX_ITERATIONS = 50;
-  static const int RANSAC_MAX_PLANES_TO_DETECT = 1; // Phase 1: 1 mur max
+  static const int RANSAC_MAX_ITERATIONS = 50; // Fixe le budget d'évaluations (arrêt adaptatif possible avant)
+  static const int RANSAC_MAX_PLANES_TO_DETECT = 3; // Deux murs + sol (RANSAC séquentiel natif)
+  static const int RANSAC_MAX_POINTS = 16384; // Nuage sous-échantillonné (pas 2 sur 256x256)
+  static const int RANSAC_COARSE_LEVEL = 2; // Hypothèses sur la carte réduite 4x (64x64), plans vérifiés à pleine résolution
+  static const int RANSAC_SEED = 0; // 0 : graine automatique ; mettre la graine loggée pour rejouer une trame
 
   // --- PARAMÈTRES INTRINSÈQUES DE LA CAMÉRA (PLACEHOLDERS !) ---
   // IMPORTANTISSIME : Ces valeurs sont des PLACEHOLDERS et INCORRECTES.
@@ -47,22 +105,17 @@ class DepthAnalyzer {
   /// Analyse la carte de profondeur (sortie de TFLiteService) pour détecter obstacles,
   /// chemin libre et murs (via FFI/RANSAC).
   ///
-  /// [depthMap]: Liste 4D [1, H, W, 1] contenant les valeurs de profondeur inverse (double).
+  /// La carte est déjà dans le contexte natif : TFLiteService y écrit directement la
+  /// sortie du modèle (float ou 8 bits quantifiée, voir NativePipeline.setDepthFormat).
+  /// Aucune copie ni conversion côté Dart.
   /// Retourne un objet [DepthAnalysisResult] ou null en cas d'erreur.
-  Future<DepthAnalysisResult?> analyzeDepthMap(List<List<List<List<double>>>>? depthMap) async {
-    // Vérification de l'entrée
-    if (depthMap == null || depthMap.isEmpty || depthMap[0].isEmpty || depthMap[0][0].isEmpty || depthMap[0][0][0].isEmpty) {
-      log("Erreur: Carte de profondeur invalide ou vide reçue.", name: "DepthAnalyzer");
-      return null;
-    }
-
-    // Extraction des dimensions (suppose B=1, C=1)
-    final int height = depthMap[0].length;
-    final int width = depthMap[0][0].length;
-    if (height == 0 || width == 0) {
-       log("Erreur: Carte de profondeur vide (dimensions 0).", name: "DepthAnalyzer");
+  Future<DepthAnalysisResult?> analyzeDepthMap() async {
+    if (_pipeline.isDisposed) {
+       log("Erreur: Contexte natif libéré.", name: "DepthAnalyzer");
        return null;
     }
+    final int width = _pipeline.modelWidth;
+    final int height = _pipeline.modelHeight;
 
     log("Analyse de la carte de profondeur ${width}x${height} (1 canal)", name: "DepthAnalyzer");
     final stopwatch = Stopwatch()..start();
@@ -73,112 +126,69 @@ class DepthAnalyzer {
     FreePathDirection freePathDirection = FreePathDirection.None;
     double maxCloseness = 0.0;
 
-    // --- 1. Convertir en Float32List plate et trouver maxCloseness ---
-    // Float32List est plus facile à passer via FFI Pointer<Float>
-    final Float32List depthFloatList = Float32List(width * height);
-    int flatIndex = 0;
-    for (int y = 0; y < height; y++) {
-      for (int x = 0; x < width; x++) {
-        // Accéder à la valeur de profondeur dans le canal 0 de la structure 4D
-        final double depthValue = depthMap[0][y][x][0];
-        depthFloatList[flatIndex++] = depthValue.toFloat(); // Utilise l'extension
-
-        // Calculer maxCloseness en même temps
-        if (depthValue > OBSTACLE_CLOSENESS_THRESHOLD && depthValue > maxCloseness) {
-          maxCloseness = depthValue;
-        }
-      }
+    // --- 0. Filtre temporel ---
+    // Intègre la nouvelle carte dans l'estimation par pixel ; les statistiques et
+    // RANSAC lisent ensuite la carte filtrée.
+    if (pipelineFilterDepth(_pipeline.context) != 1) {
+       log("Erreur: Filtre temporel natif échoué.", name: "DepthAnalyzer");
+       return null;
     }
-    // log("Conversion Float32List & maxCloseness OK.", name: "DepthAnalyzer");
+
+    // --- 1. Statistiques natives de la carte ---
+    // Une passe : max et histogramme (le chemin libre vient de la carte polaire).
+    if (pipelineComputeDepthStats(_pipeline.context, FREE_PATH_FARNESS_THRESHOLD, DEPTH_HISTOGRAM_MAX) != 1) {
+       log("Erreur: Statistiques natives de profondeur échouées.", name: "DepthAnalyzer");
+       return null;
+    }
+    final DepthStats depthStats = _pipeline.depthStats;
+    maxCloseness = depthStats.maxCloseness;
 
 
     // --- 2. Déterminer la Proximité de l'Obstacle ---
-    if (maxCloseness >= OBSTACLE_VERY_CLOSE_THRESHOLD) { obstacleProximity = ObstacleProximity.VeryClose; }
-    else if (maxCloseness > OBSTACLE_CLOSENESS_THRESHOLD) { obstacleProximity = ObstacleProximity.Detected; }
-    else { obstacleProximity = ObstacleProximity.None; }
+    obstacleProximity = _proximity(maxCloseness);
     // log("Proximité obstacle: ${obstacleProximity.name}", name: "DepthAnalyzer");
 
+    // Obstacles distincts : composantes connexes de la carte seuillée (les plus grandes d'abord).
+    final int obstacleCount = pipelineDetectObstacleBlobs(_pipeline.context, OBSTACLE_CLOSENESS_THRESHOLD, OBSTACLE_MIN_BLOB_AREA);
+    if (obstacleCount > 0) {
+      final ObstacleBlob largest = _pipeline.obstacleBlobs[0];
+      log("Obstacles: $obstacleCount (plus grand: ${largest.area} px, centre (${largest.centroidX.toStringAsFixed(0)}, "
+          "${largest.centroidY.toStringAsFixed(0)}), max ${largest.peakCloseness.toStringAsFixed(2)})", name: "DepthAnalyzer");
+    }
+
 
-    // --- 3. Estimation Simpliste du Chemin Libre ---
-    // (Logique inchangée, utilise depthFloatList)
-    int freePathCenterCount = 0; int freePathLeftCount = 0; int freePathRightCount = 0; int totalConsidered = 0;
-    final int startY = height ~/ 2; final int thirdWidth = width ~/ 3;
-    for (int y = startY; y < height; y++) {
-       for (int x = 0; x < width; x++) {
-           totalConsidered++; final double depthValue = depthFloatList[y * width + x];
-           if (depthValue < FREE_PATH_FARNESS_THRESHOLD) {
-               if (x < thirdWidth) freePathLeftCount++;
-               else if (x >= width - thirdWidth) freePathRightCount++;
-               else freePathCenterCount++;
-           }
-       }
+    // --- 3. Chemin Libre (carte polaire d'obstacles native) ---
+    // Secteurs de cap bloqués par un obstacle dans la portée ; le plus large passage
+    // donne la direction, son cap et sa largeur.
+    double? freePathHeading;
+    double? freePathWidth;
+    if (pipelineComputePolarObstacles(_pipeline.context) == 1) {
+      final PolarObstacleMap polarMap = _pipeline.polarObstacles;
+      if (polarMap.gapStart >= 0) {
+        freePathHeading = polarMap.gapHeading;
+        freePathWidth = polarMap.gapWidth;
+        freePathDirection = _freePathDirection(polarMap.gapHeading);
+      }
+      // log("Chemin libre: ${freePathDirection.name} (secteurs bloqués ${polarMap.blockedMask.toRadixString(2)})", name: "DepthAnalyzer");
+    } else {
+      log("Erreur: Carte polaire native échouée (intrinsèques ?).", name: "DepthAnalyzer");
     }
-    if (freePathCenterCount >= freePathLeftCount && freePathCenterCount >= freePathRightCount && freePathCenterCount > totalConsidered * 0.1) { freePathDirection = FreePathDirection.Center;}
-    else if (freePathLeftCount > freePathCenterCount && freePathLeftCount >= freePathRightCount && freePathLeftCount > totalConsidered * 0.1) { freePathDirection = FreePathDirection.Left; }
-    else if (freePathRightCount > freePathCenterCount && freePathRightCount > freePathLeftCount && freePathRightCount > totalConsidered * 0.1) { freePathDirection = FreePathDirection.Right;}
-    else { freePathDirection = FreePathDirection.None; }
-    // log("Chemin libre estimé: ${freePathDirection.name}", name: "DepthAnalyzer");
 
 
     // --- 4. Détection de Murs via FFI/RANSAC ---
-    Pointer<Float>? depthPtr = nullptr; // Pointeur vers copie native de la carte
-    Pointer<RansacPlaneResult>? resultsBuffer = nullptr; // Pointeur vers buffer résultats C
     try {
-      // Allouer mémoire native pour la carte de profondeur (type C float)
-      depthPtr = calloc<Float>(width * height);
-      if (depthPtr == nullptr) throw Exception("Allocation échouée pour depthPtr");
-      // Copier les données depuis la liste Dart Float32List vers le pointeur natif Float*
-      final nativeDepthList = depthPtr.asTypedList(width * height);
-      nativeDepthList.setAll(0, depthFloatList);
-
-      // Allouer mémoire native pour recevoir les résultats de RANSAC
-      resultsBuffer = calloc<RansacPlaneResult>(RANSAC_MAX_PLANES_TO_DETECT);
-       if (resultsBuffer == nullptr) throw Exception("Allocation échouée pour resultsBuffer");
-
       log("Appel FFI RANSAC...", name: "DepthAnalyzer");
-      // Appel de la fonction native C++ via la liaison FFI
-      final int planesFound = detectWallsRansac( // Fonction importée de ffi_bindings.dart
-        depthPtr, width, height,
-        CAMERA_FX, CAMERA_FY, CAMERA_CX, CAMERA_CY, // !! PLACEHOLDERS !!
-        RANSAC_DISTANCE_THRESHOLD,
-        RANSAC_MIN_INLIERS,
-        RANSAC_MAX_ITERATIONS,
-        resultsBuffer, RANSAC_MAX_PLANES_TO_DETECT
-      );
-      log("FFI RANSAC terminé. Plans trouvés: $planesFound", name: "DepthAnalyzer");
-
-      // Traiter les résultats si un plan a été trouvé
-      if (planesFound > 0) {
-         // Accéder aux données du premier plan via .ref sur le pointeur
-         final RansacPlaneResult plane = resultsBuffer.ref;
-         log("Plan[0]: A=${plane.a.toStringAsFixed(2)}, B=${plane.b.toStringAsFixed(2)}, C=${plane.c.toStringAsFixed(2)}, D=${plane.d.toStringAsFixed(2)}, Inliers=${plane.inlierCount}", name: "DepthAnalyzer");
-
-         // Analyse simple de la normale (A, B, C) pour mur vertical (B faible)
-         double normalMagnitudeXZ = math.sqrt(plane.a * plane.a + plane.c * plane.c);
-         if (normalMagnitudeXZ > 0.01) {
-             // Utilise .abs() sur les doubles
-             if ((plane.b).abs() / normalMagnitudeXZ < 0.20) { // Seuil arbitraire pour verticalité
-                 // Logique simpliste pour direction G/D/Front
-                 if ((plane.a).abs() > (plane.c).abs() * 1.5) { wallDirection = (plane.a > 0) ? WallDirection.Left : WallDirection.Right; }
-                 else if ((plane.c).abs() > (plane.a).abs() * 1.5) { wallDirection = WallDirection.Front; }
-                 else { wallDirection = WallDirection.Front; }
-                 log("Mur vertical détecté. Direction: ${wallDirection.name}", name: "DepthAnalyzer");
-             } else { log("Plan détecté non vertical.", name: "DepthAnalyzer"); }
-         } else { log("Plan détecté normal XZ faible.", name: "DepthAnalyzer"); }
-      } else {
-          log("Aucun mur détecté par RANSAC (placeholder actif).", name: "DepthAnalyzer"); // Log adapté au placeholder
-          wallDirection = WallDirection.None;
-      }
+      // Appel de la fonction native C++ via la liaison FFI : lit la carte de profondeur
+      // et les options du contexte, écrit dans son tampon de plans (capacité RANSAC_MAX_PLANES_TO_DETECT)
+      final int planesFound = pipelineDetectWalls(_pipeline.context); // Fonction importée de ffi_bindings.dart
+      final RansacStats stats = _pipeline.ransacStats;
+      log("FFI RANSAC terminé. Plans trouvés: $planesFound (${stats.iterations} hypothèses, "
+          "${stats.earlyExits} abandonnées, ${stats.pointEvaluations} évaluations, graine ${stats.seed}, ${stats.warmStarts} plans repris)", name: "DepthAnalyzer");
 
+      wallDirection = _wallDirection(planesFound);
     } catch (e, stacktrace) {
        log("Erreur FFI RANSAC: $e", name: "DepthAnalyzer", stackTrace: stacktrace);
        wallDirection = WallDirection.None;
-    } finally {
-       // Libérer IMPÉRATIVEMENT la mémoire native allouée avec calloc !
-       log("Libération mémoire native RANSAC...", name: "DepthAnalyzer");
-       if (depthPtr != null && depthPtr != nullptr) calloc.free(depthPtr);
-       if (resultsBuffer != null && resultsBuffer != nullptr) calloc.free(resultsBuffer);
-       log("Mémoire native RANSAC libérée.", name: "DepthAnalyzer");
     }
 
     // --- 5. Retourner le résultat combiné ---
@@ -187,14 +197,82 @@ class DepthAnalyzer {
 
     return DepthAnalysisResult(
       obstacleProximity: obstacleProximity,
+      obstacleCount: obstacleCount,
       wallDirection: wallDirection, // Sera 'None' tant que RANSAC C++ est vide
       freePathDirection: freePathDirection,
+      freePathHeading: freePathHeading,
+      freePathWidth: freePathWidth,
     );
   } // Fin analyzeDepthMap
 
-} // Fin DepthAnalyzer
+  /// Résultat d'une trame traitée de bout en bout par le contexte natif
+  /// ([NativePipeline.processLatestFrame]) : mêmes seuils et mêmes règles que
+  /// [analyzeDepthMap], sans nouvel appel natif d'analyse. Null si la trame a échoué.
+  DepthAnalysisResult? resultFromNativeFrame() {
+    if (_pipeline.isDisposed) return null;
+    final FrameResult frame = _pipeline.frameResult;
+    if (frame.status != pipelineStatusOk) {
+      log("Erreur: Traitement natif de la trame échoué (statut ${frame.status}).", name: "DepthAnalyzer");
+      return null;
+    }
+    log("Trame native: prétraitement ${frame.preprocessUs} µs, inférence ${frame.inferenceUs} µs, "
+        "analyse ${frame.analysisUs} µs, RANSAC ${frame.ransacUs} µs", name: "DepthAnalyzer");
+
+    final bool hasGap = frame.gapStart >= 0;
+    return DepthAnalysisResult(
+      obstacleProximity: _proximity(frame.maxCloseness),
+      obstacleCount: frame.obstacleCount,
+      wallDirection: _wallDirection(frame.planeCount),
+      freePathDirection: hasGap ? _freePathDirection(frame.gapHeading) : FreePathDirection.None,
+      freePathHeading: hasGap ? frame.gapHeading : null,
+      freePathWidth: hasGap ? frame.gapWidth : null,
+    );
+  }
+
+  // Proximité de l'obstacle le plus proche d'après la profondeur inverse maximale.
+  ObstacleProximity _proximity(double maxCloseness) {
+    if (maxCloseness >= OBSTACLE_VERY_CLOSE_THRESHOLD) return ObstacleProximity.VeryClose;
+    if (maxCloseness > OBSTACLE_CLOSENESS_THRESHOLD) return ObstacleProximity.Detected;
+    return ObstacleProximity.None;
+  }
+
+  // Direction du passage libre d'après son cap (radians, négatif à gauche).
+  FreePathDirection _freePathDirection(double gapHeading) {
+    if (gapHeading < -FREE_PATH_CENTER_HEADING) return FreePathDirection.Left;
+    if (gapHeading > FREE_PATH_CENTER_HEADING) return FreePathDirection.Right;
+    return FreePathDirection.Center;
+  }
+
+  // Direction du mur d'après les [planesFound] premiers plans du contexte.
+  WallDirection _wallDirection(int planesFound) {
+    WallDirection wallDirection = WallDirection.None;
+    // Traiter les plans trouvés (ordre de découverte : le plus grand d'abord).
+    // Le premier plan vertical donne la direction du mur ; les autres (sol, plafond) sont ignorés.
+    if (planesFound > 0) {
+       for (int i = 0; i < planesFound && wallDirection == WallDirection.None; i++) {
+         // Accéder aux données du plan i via l'indexation du pointeur
+         final RansacPlaneResult plane = _pipeline.planes[i];
+         log("Plan[$i]: A=${plane.a.toStringAsFixed(2)}, B=${plane.b.toStringAsFixed(2)}, C=${plane.c.toStringAsFixed(2)}, D=${plane.d.toStringAsFixed(2)}, Inliers=${plane.inlierCount}, RMS=${plane.rms.toStringAsFixed(3)}", name: "DepthAnalyzer");
 
-// Extension (inchangée)
-extension FloatExtension on double {
-  double toFloat() => this;
-}
\ No newline at end of file
+         // Analyse simple de la normale (A, B, C) pour mur vertical (B faible)
+         double normalMagnitudeXZ = math.sqrt(plane.a * plane.a + plane.c * plane.c);
+         if (normalMagnitudeXZ > 0.01) {
+             // Utilise .abs() sur les doubles
+             if ((plane.b).abs() / normalMagnitudeXZ < 0.20) { // Seuil arbitraire pour verticalité
+                 // Logique simpliste pour direction G/D/Front
+                 // Normale orientée de la caméra vers le plan (ajustement en profondeur inverse) : A < 0 = mur à gauche
+                 if ((plane.a).abs() > (plane.c).abs() * 1.5) { wallDirection = (plane.a < 0) ? WallDirection.Left : WallDirection.Right; }
+                 else if ((plane.c).abs() > (plane.a).abs() * 1.5) { wallDirection = WallDirection.Front; }
+                 else { wallDirection = WallDirection.Front; }
+                 log("Mur vertical détecté (plan $i). Direction: ${wallDirection.name}", name: "DepthAnalyzer");
+             } else { log("Plan $i non vertical (sol/plafond ?).", name: "DepthAnalyzer"); }
+         } else { log("Plan $i : normale XZ faible.", name: "DepthAnalyzer"); }
+       }
+    } else {
+        log("Aucun mur détecté par RANSAC (placeholder actif).", name: "DepthAnalyzer"); // Log adapté au placeholder
+        wallDirection = WallDirection.None;
+    }
+    return wallDirection;
+  }
+
+} // Fin DepthAnalyzer
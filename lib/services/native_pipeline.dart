@@ -0,0 +1,261 @@
+// lib/services/native_pipeline.dart
+
+import 'dart:async';      // Pour Completer
+import 'dart:developer';  // Pour log()
+import 'dart:ffi';        // Pour Pointer, nullptr
+import 'dart:isolate';    // Pour Isolate, SendPort, ReceivePort
+import 'dart:typed_data'; // Pour Uint8List, Float32List
+
+import 'package:ffi/ffi.dart'; // Pour toNativeUtf8 / malloc / calloc
+
+import 'package:assistive_perception_app/utils/ffi_bindings.dart';
+
+/// Propriétaire Dart du contexte de pipeline natif (`PipelineContext`).
+///
+/// Créé une seule fois, il expose les tampons natifs persistants (boîte aux lettres
+/// de trames YUV, entrée du modèle, carte de profondeur, résultats RANSAC) sous forme de vues
+/// typées : les services écrivent et lisent directement la mémoire native,
+/// sans calloc/free par trame.
+class NativePipeline {
+  final int modelWidth;
+  final int modelHeight;
+  final int maxPlanes;
+
+  Pointer<PipelineContext> _ctx = nullptr;
+
+  NativePipeline({
+    required this.modelWidth,
+    required this.modelHeight,
+    required this.maxPlanes,
+    int cameraWidth = 0,
+    int cameraHeight = 0,
+  }) {
+    _ctx = pipelineCreate(cameraWidth, cameraHeight, modelWidth, modelHeight, maxPlanes);
+    if (_ctx == nullptr) throw Exception("Création du contexte de pipeline natif échouée");
+    log("Contexte natif créé (modèle ${modelWidth}x$modelHeight, $maxPlanes plans max)", name: "NativePipeline");
+  }
+
+  bool get isDisposed => _ctx == nullptr;
+  Pointer<PipelineContext> get context => _ctx;
+
+  // Vues typées sur les tampons natifs (aucune copie).
+  Uint8List get modelInput => pipelineModelInputBuffer(_ctx).asTypedList(modelWidth * modelHeight * 3);
+  Float32List get depthMap => pipelineDepthBuffer(_ctx).asTypedList(modelWidth * modelHeight);
+  Float32List get filteredDepthMap => pipelineFilteredDepthBuffer(_ctx).asTypedList(modelWidth * modelHeight);
+  Uint8List get depthQ8 => pipelineDepthQ8Buffer(_ctx).asTypedList(modelWidth * modelHeight);
+  Pointer<RansacPlaneResult> get planes => pipelinePlanesBuffer(_ctx);
+
+  /// Dépose une trame dans la boîte aux lettres du contexte : copie des plans dans
+  /// l'emplacement libre, puis publication. Ne bloque jamais ; la trame précédente,
+  /// si elle n'a pas encore été prise, est remplacée (comptée dans [mailboxStats]).
+  bool depositFrame(Uint8List yBytes, Uint8List uvBytes,
+      {required int width, required int height, required int yStride, required int uvStride, required int timestampUs}) {
+    if (pipelineMailboxReserve(_ctx, yBytes.lengthInBytes, uvBytes.lengthInBytes) != 1) return false;
+    // Pointeurs relus à chaque dépôt : l'emplacement libre change après chaque publication.
+    pipelineMailboxYBuffer(_ctx).asTypedList(yBytes.lengthInBytes).setAll(0, yBytes);
+    pipelineMailboxUVBuffer(_ctx).asTypedList(uvBytes.lengthInBytes).setAll(0, uvBytes);
+    return pipelineMailboxPublish(_ctx, width, height, yStride, uvStride, timestampUs) == 1;
+  }
+
+  /// Dépose une trame YUV_420_888 à trois plans (NV12, NV21 ou I420 côté caméra : U et V
+  /// sont copiés tels quels, avec leur pas de pixel). [rotation] : rotation horaire
+  /// appliquée au prétraitement (sensorOrientation), pour un modèle qui voit l'image droite.
+  bool depositYuv420Frame(Uint8List yBytes, Uint8List uBytes, Uint8List vBytes,
+      {required int width, required int height, required int yStride, required int uvStride,
+       required int uvPixelStride, required int rotation, required int timestampUs}) {
+    if (pipelineMailboxReserveYuv420(_ctx, yBytes.lengthInBytes, uBytes.lengthInBytes, vBytes.lengthInBytes) != 1) {
+      return false;
+    }
+    pipelineMailboxYBuffer(_ctx).asTypedList(yBytes.lengthInBytes).setAll(0, yBytes);
+    pipelineMailboxUVBuffer(_ctx).asTypedList(uBytes.lengthInBytes).setAll(0, uBytes);
+    pipelineMailboxVBuffer(_ctx).asTypedList(vBytes.lengthInBytes).setAll(0, vBytes);
+    return pipelineMailboxPublishYuv420(_ctx, width, height, yStride, uvStride, uvPixelStride, rotation, timestampUs) == 1;
+  }
+
+  /// Prend la trame la plus récente si elle est nouvelle (false : rien de neuf).
+  bool takeLatestFrame() => pipelineMailboxTake(_ctx) == 1;
+
+  /// Prétraite la dernière trame prise vers [inputTensor].
+  bool preprocessLatestFrame() => pipelinePreprocessLatest(_ctx) == 1;
+
+  // Métadonnées de la dernière trame prise, et compteurs de la boîte aux lettres.
+  FrameInfo get latestFrameInfo => pipelineMailboxFrameInfo(_ctx).ref;
+  MailboxStats get mailboxStats => pipelineMailboxStats(_ctx).ref;
+
+  /// Carte lue par l'analyse : [depthMap] (depthFormatF32) ou [depthQ8]
+  /// (depthFormatU8 / depthFormatS8, avec la quantification du tenseur de sortie).
+  bool setDepthFormat(int format, {double scale = 1.0, int zeroPoint = 0}) =>
+      pipelineSetDepthFormat(_ctx, format, scale, zeroPoint) == 1;
+
+  /// Tenseur écrit par le prétraitement : uint8 NHWC par défaut ([modelInput]), ou
+  /// float32 / float16, NHWC / NCHW, normalisé par canal ([mean], [std] en unités 0..255).
+  bool setInputFormat(int type, {int layout = inputTensorNHWC,
+      List<double> mean = const [0.0, 0.0, 0.0], List<double> std = const [1.0, 1.0, 1.0]}) =>
+      pipelineSetInputFormat(_ctx, type, layout, mean[0], mean[1], mean[2], std[0], std[1], std[2]) == 1;
+
+  /// Octets du tenseur d'entrée au format choisi (vue native, sans copie) : à passer tel
+  /// quel à l'interpréteur, quel que soit le type.
+  Uint8List get inputTensor => pipelineInputTensorBuffer(_ctx).asTypedList(pipelineInputTensorBytes(_ctx));
+
+  /// Threads natifs du contexte, appelant compris (<= 0 : nombre de cœurs ; 1 : série).
+  /// Les threads sont recréés une fois ; retourne le nombre effectif.
+  int setThreadCount(int threadCount) => pipelineSetThreadCount(_ctx, threadCount);
+
+  // Options RANSAC du contexte (modifiables en place) et coût du dernier appel.
+  RansacOptions get ransacOptions => pipelineRansacOptions(_ctx).ref;
+  RansacStats get ransacStats => pipelineRansacStats(_ctx).ref;
+
+  /// Filtre temporel de la carte de profondeur (lissage exponentiel par pixel, sauf
+  /// écart > [jumpThreshold]). Activé, l'analyse lit la carte filtrée.
+  bool setTemporalFilter({required bool enabled, double alpha = 1.0, double jumpThreshold = 0.0}) =>
+      pipelineSetTemporalFilter(_ctx, enabled ? 1 : 0, alpha, jumpThreshold) == 1;
+
+  /// Oublie l'estimation filtrée (la prochaine carte la réinitialise).
+  void resetDepthFilter() => pipelineResetDepthFilter(_ctx);
+
+  /// Oublie les plans de la trame précédente (la prochaine détection repart des tirages).
+  void resetWarmStart() => pipelineResetWarmStart(_ctx);
+
+  // Statistiques de la dernière carte de profondeur (pipeline_compute_depth_stats).
+  DepthStats get depthStats => pipelineDepthStats(_ctx).ref;
+
+  /// Carte polaire d'obstacles : options (intrinsèques, portée, bande de hauteur)
+  /// et résultat du dernier pipelineComputePolarObstacles.
+  PolarObstacleOptions get polarObstacleOptions => pipelinePolarObstacleOptions(_ctx).ref;
+  PolarObstacleMap get polarObstacles => pipelinePolarObstacles(_ctx).ref;
+
+  /// Composantes d'obstacles du dernier pipelineDetectObstacleBlobs (par aire décroissante).
+  Pointer<ObstacleBlob> get obstacleBlobs => pipelineObstacleBlobs(_ctx);
+
+  /// Tables cumulées de la carte analysée (une fois par carte, après le filtre temporel).
+  /// [threshold] : seuil de profondeur inverse de [RegionStats.fractionAbove].
+  bool buildDepthIntegral(double threshold) => pipelineBuildDepthIntegral(_ctx, threshold) == 1;
+
+  /// Rectangles à évaluer ([depthRegionsMax] au plus) : remplir [depthRegions], puis
+  /// [queryDepthRegions] écrit les statistiques des [count] premiers dans [regionStats].
+  Pointer<DepthRegion> get depthRegions => pipelineDepthRegions(_ctx);
+  Pointer<RegionStats> get regionStats => pipelineDepthRegionStats(_ctx);
+  int queryDepthRegions(int count) => pipelineQueryDepthRegions(_ctx, count);
+
+  /// Pyramide de la carte analysée (moyennes 2x2) : [levelCount] niveaux, 0 compris.
+  /// Les dimensions impaires sont tronquées ; faux si la carte n'est pas disponible.
+  bool buildDepthPyramid(int levelCount) => pipelineBuildDepthPyramid(_ctx, levelCount) == 1;
+
+  /// Vue sur le niveau [level] de la pyramide, null s'il n'est pas construit.
+  Float32List? depthLevel(int level) {
+    final Pointer<Float> data = pipelineDepthLevelBuffer(_ctx, level);
+    if (data == nullptr) return null;
+    return data.asTypedList((modelWidth >> level) * (modelHeight >> level));
+  }
+
+  /// Statistiques (voir [depthStats]) calculées sur le niveau [level] de la pyramide.
+  bool computeDepthStatsLevel(int level, double freePathThreshold, double histogramMax) =>
+      pipelineComputeDepthStatsLevel(_ctx, level, freePathThreshold, histogramMax) == 1;
+
+  /// true si la bibliothèque native embarque TFLite (traitement de trame complet possible).
+  bool get hasNativeInference => pipelineHasTflite() == 1;
+
+  /// Charge le modèle .tflite [modelPath] dans l'interpréteur natif du contexte. Le type et
+  /// la disposition de l'entrée viennent du modèle ; la normalisation est celle du dernier
+  /// [setInputFormat] (à appeler avant). Retourne un code pipelineStatus*.
+  int loadModel(String modelPath, {int threadCount = 0}) {
+    final Pointer<Utf8> path = modelPath.toNativeUtf8();
+    try {
+      return pipelineLoadModel(_ctx, path, threadCount);
+    } finally {
+      malloc.free(path);
+    }
+  }
+
+  /// Traite la dernière trame prise ([takeLatestFrame]) de bout en bout en un appel :
+  /// prétraitement, inférence native, analyse et RANSAC. L'appel tourne dans un isolat de
+  /// fond créé à la première trame puis gardé jusqu'à [dispose] (l'inférence ne bloque pas
+  /// l'interface ; par trame, seuls l'adresse du contexte et le statut traversent les ports).
+  /// Résultat dans [frameResult] ; retourne son statut (pipelineStatus*). Une trame à la fois.
+  Future<int> processLatestFrame() async {
+    final _FrameWorker worker = await (_frameWorker ??= _FrameWorker.spawn());
+    return worker.process(_ctx.address);
+  }
+
+  Future<_FrameWorker>? _frameWorker;
+
+  // Seuils de l'analyse du traitement complet (modifiables en place) et résultat de la dernière trame.
+  FrameProcessOptions get frameOptions => pipelineFrameOptions(_ctx).ref;
+  FrameResult get frameResult => pipelineFrameResult(_ctx).ref;
+
+  /// Mémoire résidente du processus (kio) : actuelle et pic depuis le lancement.
+  /// Null si /proc/self/status est illisible.
+  static ({int rssKb, int peakRssKb})? processMemory() {
+    final Pointer<ProcessMemory> memory = calloc<ProcessMemory>();
+    try {
+      if (readProcessMemory(memory) != 1) return null;
+      return (rssKb: memory.ref.rssKb, peakRssKb: memory.ref.peakRssKb);
+    } finally {
+      calloc.free(memory);
+    }
+  }
+
+  /// Libère le contexte natif. Les vues obtenues auparavant deviennent invalides.
+  void dispose() {
+    if (_ctx == nullptr) return;
+    // Le dernier processLatestFrame doit être terminé (voir MyHomePage.dispose).
+    _frameWorker?.then((worker) => worker.close());
+    _frameWorker = null;
+    pipelineDestroy(_ctx);
+    _ctx = nullptr;
+    log("Contexte natif libéré.", name: "NativePipeline");
+  }
+}
+
+/// Isolat de fond de [NativePipeline.processLatestFrame] : reçoit l'adresse du contexte,
+/// appelle pipeline_process_latest et renvoie le statut.
+class _FrameWorker {
+  final ReceivePort _replies = ReceivePort();
+  final Completer<SendPort> _commands = Completer<SendPort>();
+  Isolate? _isolate;
+  Completer<int>? _pending;
+
+  _FrameWorker._() {
+    // Un seul abonnement : le premier message est le port de commandes de l'isolat,
+    // les suivants sont des statuts.
+    _replies.listen((message) {
+      if (message is SendPort) {
+        _commands.complete(message);
+        return;
+      }
+      final Completer<int>? pending = _pending;
+      _pending = null;
+      pending?.complete(message as int);
+    });
+  }
+
+  static Future<_FrameWorker> spawn() async {
+    final _FrameWorker worker = _FrameWorker._();
+    worker._isolate = await Isolate.spawn(_main, worker._replies.sendPort, debugName: 'NativePipeline.frames');
+    await worker._commands.future;
+    log("Isolat de traitement des trames démarré.", name: "NativePipeline");
+    return worker;
+  }
+
+  Future<int> process(int contextAddress) async {
+    assert(_pending == null, 'Une seule trame à la fois');
+    final Completer<int> pending = Completer<int>();
+    _pending = pending;
+    (await _commands.future).send(contextAddress);
+    return pending.future;
+  }
+
+  void close() {
+    _replies.close();
+    _isolate?.kill(priority: Isolate.beforeNextEvent);
+  }
+
+  // Boucle de l'isolat : une adresse de contexte par trame, jusqu'à kill.
+  static void _main(SendPort replies) {
+    final ReceivePort commands = ReceivePort();
+    replies.send(commands.sendPort);
+    commands.listen((message) {
+      replies.send(pipelineProcessLatest(Pointer<PipelineContext>.fromAddress(message as int)));
+    });
+  }
+}
@@ -1,32 +1,68 @@
 import 'dart:async';
 import 'dart:developer';
-import 'dart:isolate';
+import 'dart:io';
 import 'dart:typed_data';
 import 'package:flutter/services.dart' show rootBundle;
 import 'package:tflite_flutter/tflite_flutter.dart';
 
+import 'package:assistive_perception_app/services/native_pipeline.dart';
+import 'package:assistive_perception_app/utils/ffi_bindings.dart';
+
 class TFLiteService {
   static const String modelPath = 'midas_small_quant.tflite';
-  static const List<int> outputShape = [1, 256, 256, 1];
+
+  // Version du modèle extrait : à incrémenter quand l'asset change, sinon l'ancien
+  // fichier extrait resterait utilisé.
+  static const int modelVersion = 1;
+
+  // Normalisation ImageNet des variantes float de MiDaS (unités 0..255, canaux R, G, B).
+  static const List<double> inputMean = [123.675, 116.28, 103.53];
+  static const List<double> inputStd = [58.395, 57.12, 57.375];
 
   Interpreter? _interpreter;
-  IsolateInterpreter? _isolateInterpreter;
   bool _isInitialized = false;
 
+  // Vue sur le tampon natif du contexte qui reçoit la sortie du modèle (voir bindOutput).
+  Uint8List? _outputBytes;
+  // Relit le tampon natif par une vue neuve obtenue du contexte ; remis à null une fois
+  // la première inférence vérifiée.
+  Uint8List Function()? _checkOutput;
+
   bool get isInitialized => _isInitialized;
 
-  Future<bool> loadModel() async {
+  /// Fichier du modèle dans le stockage de l'application (dossier temporaire de l'app,
+  /// le cache sous Android). L'asset n'est lu et écrit qu'au premier lancement (ou si le
+  /// cache a été vidé) ; ensuite, le fichier est projeté en mémoire tel quel.
+  /// Null si l'asset est introuvable ou l'écriture impossible.
+  static Future<File?> extractModel() async {
+    final File modelFile = File('${Directory.systemTemp.path}/v${modelVersion}_$modelPath');
+    try {
+      if (await modelFile.exists() && await modelFile.length() > 0) return modelFile;
+      final ByteData assetData = await rootBundle.load('assets/$modelPath');
+      // Écrit à côté puis renomme : une extraction interrompue n'est jamais prise pour complète.
+      final File partial = File('${modelFile.path}.part');
+      await partial.writeAsBytes(
+          assetData.buffer.asUint8List(assetData.offsetInBytes, assetData.lengthInBytes), flush: true);
+      await partial.rename(modelFile.path);
+      log('Modèle extrait (${assetData.lengthInBytes} octets) : ${modelFile.path}', name: 'TFLiteService');
+      return modelFile;
+    } catch (e, stacktrace) {
+      print('!!! ERREUR EXTRACTION MODÈLE !!!\nErreur: $e\n$stacktrace');
+      return null;
+    }
+  }
+
+  /// Crée l'interpréteur sur [modelFile] (voir [extractModel]) : TFLite projette le fichier
+  /// en mémoire, les poids ne passent pas par le tas Dart.
+  Future<bool> loadModel(File modelFile) async {
     if (_isInitialized) return true;
     log('Chargement modèle TFLite...', name: 'TFLiteService');
 
     try {
-      final ByteData assetData = await rootBundle.load('assets/$modelPath');
-      final Uint8List modelBytes = assetData.buffer.asUint8List(assetData.offsetInBytes, assetData.lengthInBytes);
       final InterpreterOptions options = InterpreterOptions();
 
-      _interpreter = await Interpreter.fromBuffer(modelBytes, options: options);
+      _interpreter = Interpreter.fromFile(modelFile, options: options);
       _interpreter!.allocateTensors();
-      _isolateInterpreter = await IsolateInterpreter.create(address: _interpreter!.address);
 
       _isInitialized = true;
       log('TFLiteService initialisé avec succès.', name: 'TFLiteService');
@@ -35,42 +71,140 @@ class TFLiteService {
       print('!!! ERREUR INIT TFLITE !!!\nErreur: $e\n$stacktrace');
       _isInitialized = false;
       _interpreter?.close();
-      _isolateInterpreter?.close();
+      _interpreter = null;
       return false;
     }
   }
 
-  /// Adapté pour modèle quantisé : sortie en `int` et non `double`
-  Future<List<List<List<List<int>>>>>? runInference(Uint8List inputBytes) async {
-    if (!_isInitialized || _isolateInterpreter == null) {
-      log('TFLiteService non prêt.', name: 'TFLiteService');
-      return Future.value(null);
+  /// Choisit le format du tenseur d'entrée écrit par le prétraitement natif d'après le
+  /// modèle : uint8 brut (quantifié) ou float32 / float16 normalisé, NHWC ou NCHW
+  /// (canaux en deuxième dimension). Le tenseur est ensuite passé tel quel à l'inférence.
+  bool bindInput(NativePipeline pipeline) {
+    if (!_isInitialized || _interpreter == null) return false;
+    final Tensor input = _interpreter!.getInputTensor(0);
+    final List<int> shape = input.shape;
+    if (shape.length != 4 || shape[0] != 1) {
+      log('Entrée ${input.shape} non supportée.', name: 'TFLiteService');
+      return false;
+    }
+    final bool nchw = shape[1] == 3 && shape[3] != 3;
+    final int layout = nchw ? inputTensorNCHW : inputTensorNHWC;
+    final int height = nchw ? shape[2] : shape[1];
+    final int width = nchw ? shape[3] : shape[2];
+    if (width != pipeline.modelWidth || height != pipeline.modelHeight) {
+      log('Entrée ${input.shape} incompatible avec le contexte natif.', name: 'TFLiteService');
+      return false;
     }
 
-    // Sortie INT au lieu de DOUBLE (quantized model)
-    var outputData = List.generate(
-      outputShape[0], (_) => List.generate(
-        outputShape[1], (_) => List.generate(
-          outputShape[2], (_) => List.filled(outputShape[3], 0),
-        ),
-      ),
-    );
+    bool ok;
+    switch (input.type) {
+      case TensorType.uint8:
+        ok = pipeline.setInputFormat(inputTensorU8, layout: layout);
+      case TensorType.float32:
+        ok = pipeline.setInputFormat(inputTensorF32, layout: layout, mean: inputMean, std: inputStd);
+      case TensorType.float16:
+        ok = pipeline.setInputFormat(inputTensorF16, layout: layout, mean: inputMean, std: inputStd);
+      default:
+        log('Type d\'entrée non supporté : ${input.type}', name: 'TFLiteService');
+        ok = false;
+    }
+    if (ok) log('Entrée ${input.type} ${input.shape} ${nchw ? "NCHW" : "NHWC"} -> prétraitement natif', name: 'TFLiteService');
+    return ok;
+  }
+
+  /// Branche la sortie du modèle sur le tampon de profondeur du contexte natif :
+  /// uint8/int8 (avec scale/zeroPoint du tenseur) ou float32, selon le modèle.
+  /// L'analyse native lit ensuite ce tampon directement (déquantification à la volée).
+  bool bindOutput(NativePipeline pipeline) {
+    if (!_isInitialized || _interpreter == null) return false;
+    final Tensor output = _interpreter!.getOutputTensor(0);
+    final int pixels = pipeline.modelWidth * pipeline.modelHeight;
+    final int elements = output.shape.fold(1, (a, b) => a * b);
+    if (elements != pixels) {
+      log('Sortie ${output.shape} incompatible avec le contexte natif.', name: 'TFLiteService');
+      return false;
+    }
+
+    final QuantizationParams params = output.params;
+    bool ok;
+    TypedData? target;
+    switch (output.type) {
+      case TensorType.uint8:
+        ok = pipeline.setDepthFormat(depthFormatU8, scale: params.scale, zeroPoint: params.zeroPoint);
+        target = pipeline.depthQ8;
+      case TensorType.int8:
+        ok = pipeline.setDepthFormat(depthFormatS8, scale: params.scale, zeroPoint: params.zeroPoint);
+        target = pipeline.depthQ8;
+      case TensorType.float32:
+        ok = pipeline.setDepthFormat(depthFormatF32);
+        target = pipeline.depthMap;
+      default:
+        log('Type de sortie non supporté : ${output.type}', name: 'TFLiteService');
+        ok = false;
+    }
+    _outputBytes = ok && target != null
+        ? target.buffer.asUint8List(target.offsetInBytes, target.lengthInBytes)
+        : null;
+    _checkOutput = _outputBytes == null
+        ? null
+        : () {
+            final TypedData fresh = output.type == TensorType.float32 ? pipeline.depthMap : pipeline.depthQ8;
+            return fresh.buffer.asUint8List(fresh.offsetInBytes, fresh.lengthInBytes);
+          };
+    if (ok) log('Sortie ${output.type} (scale ${params.scale}, zeroPoint ${params.zeroPoint}) -> tampon natif', name: 'TFLiteService');
+    return ok;
+  }
+
+  /// Lance l'inférence dans l'isolat courant : [inputBytes] (octets du tenseur d'entrée
+  /// au format choisi par [bindInput]) est copié dans le tenseur d'entrée, puis le
+  /// tenseur de sortie est copié dans le tampon natif branché par [bindOutput] (une
+  /// copie mémoire par sens, sans listes imbriquées ni conversion). Un isolat auxiliaire
+  /// recevrait des copies des deux tampons et écrirait dans sa propre copie de la sortie.
+  /// Bloque l'isolat appelant le temps de l'inférence (repli de l'inférence native).
+  Future<bool> runInference(Uint8List inputBytes) async {
+    final Interpreter? interpreter = _interpreter;
+    final Uint8List? outputBytes = _outputBytes;
+    if (!_isInitialized || interpreter == null || outputBytes == null) {
+      log('TFLiteService non prêt.', name: 'TFLiteService');
+      return false;
+    }
 
     try {
-      await _isolateInterpreter!.run(inputBytes, outputData);
-      return outputData;
+      interpreter.getInputTensor(0).data = inputBytes;
+      interpreter.invoke();
+      final Uint8List outputTensor = interpreter.getOutputTensor(0).data;
+      if (outputTensor.length != outputBytes.length) {
+        log('Sortie de ${outputTensor.length} octets, tampon natif de ${outputBytes.length}.', name: 'TFLiteService');
+        return false;
+      }
+      outputBytes.setAll(0, outputTensor);
+      // Première inférence : vérifie, par une vue neuve sur le contexte, que le tampon
+      // natif lu par l'analyse contient bien la sortie du modèle.
+      final Uint8List Function()? checkOutput = _checkOutput;
+      if (checkOutput != null) {
+        _checkOutput = null;
+        final Uint8List nativeBytes = checkOutput();
+        for (int i = 0; i < nativeBytes.length; i++) {
+          if (nativeBytes[i] != outputTensor[i]) {
+            log('Tampon natif différent de la sortie du modèle (octet $i).', name: 'TFLiteService');
+            _outputBytes = null;
+            return false;
+          }
+        }
+      }
+      return true;
     } catch (e, stacktrace) {
       print('!!! ERREUR INFÉRENCE TFLITE !!!\nErreur: $e\n$stacktrace');
-      return Future.value(null);
+      return false;
     }
   }
 
   void dispose() {
     log('Libération TFLiteService...', name: 'TFLiteService');
-    _isolateInterpreter?.close();
     _interpreter?.close();
-    _isolateInterpreter = null;
     _interpreter = null;
+    _outputBytes = null;
+    _checkOutput = null;
     _isInitialized = false;
   }
 }
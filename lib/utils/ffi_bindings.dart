@@ -35,6 +35,39 @@ typedef ConvertYUV420SPToRGBDart = void Function(
 );
 
 
+// --- Liaison pour le prétraitement fusionné YUV -> entrée du modèle ---
+
+// Typedef pour la signature C de `preprocess_yuv420sp_to_model_input`.
+// Recadrage + redimensionnement + conversion couleur en une seule passe native :
+// écrit directement les octets RGB [H, W, 3] attendus par le modèle.
+typedef PreprocessYUV420SPNative = Void Function(
+    Pointer<Uint8> pY,      // Plan Y
+    Pointer<Uint8> pUV,     // Plan UV entrelacé
+    Int32 width,            // Largeur caméra
+    Int32 height,           // Hauteur caméra
+    Int32 yStride,          // Stride Y
+    Int32 uvStride,         // Stride UV
+    Int32 cropX, Int32 cropY, Int32 cropWidth, Int32 cropHeight, // Zone source (0 = image entière)
+    Pointer<Uint8> pOut,    // Tampon de sortie (outWidth * outHeight * 3)
+    Int32 outWidth,         // Largeur entrée modèle
+    Int32 outHeight         // Hauteur entrée modèle
+);
+
+// Typedef pour la fonction Dart équivalente.
+typedef PreprocessYUV420SPDart = void Function(
+    Pointer<Uint8> pY,
+    Pointer<Uint8> pUV,
+    int width,
+    int height,
+    int yStride,
+    int uvStride,
+    int cropX, int cropY, int cropWidth, int cropHeight,
+    Pointer<Uint8> pOut,
+    int outWidth,
+    int outHeight
+);
+
+
 // --- Structure pour les Résultats RANSAC ---
 
 // Définit une structure Dart qui correspondra à la structure C `RansacPlaneResult`.
@@ -62,6 +95,446 @@ final class RansacPlaneResult extends Struct {
   /// Nombre de points considérés comme "inliers" pour ce plan.
   @Int32()
   external int inlierCount;
+
+  /// Centroïde des inliers (repère caméra ; 0 sans raffinement moindres carrés).
+  @Float()
+  external double centroidX;
+  @Float()
+  external double centroidY;
+  @Float()
+  external double centroidZ;
+
+  /// Écart quadratique moyen des inliers au plan (0 sans raffinement).
+  @Float()
+  external double rms;
+
+  /// Fraction des points du nuage inliers du plan (indépendante du pas).
+  @Float()
+  external double inlierRatio;
+}
+
+// Structure C `RansacOptions` (même ordre de champs). Remplie par
+// ransac_default_options côté natif, ajustée une fois côté Dart.
+final class RansacOptions extends Struct {
+  /// Paramètres intrinsèques caméra (pixels).
+  @Float()
+  external double fx;
+  @Float()
+  external double fy;
+  @Float()
+  external double cx;
+  @Float()
+  external double cy;
+
+  /// Distance max point-plan pour être inlier.
+  @Float()
+  external double distanceThreshold;
+
+  /// Nombre min d'inliers pour accepter un plan.
+  @Int32()
+  external int minInliers;
+
+  /// Budget : maxIterations * N évaluations de points (et nombre d'hypothèses sans mode adaptatif).
+  @Int32()
+  external int maxIterations;
+
+  /// 1 : abandon d'une hypothèse dès qu'elle ne peut plus battre la meilleure.
+  @Int32()
+  external int earlyTermination;
+
+  /// Taille des blocs de score (points) pour la terminaison anticipée.
+  @Int32()
+  external int chunkSize;
+
+  /// 1 : nombre d'itérations adapté au taux d'inliers observé.
+  @Int32()
+  external int adaptiveIterations;
+
+  /// Probabilité visée d'avoir tiré un triplet pur (mode adaptatif).
+  @Float()
+  external double confidence;
+
+  /// Pas de sous-échantillonnage de la déprojection (1 = chaque pixel).
+  @Int32()
+  external int pixelStride;
+
+  /// Rectangle d'intérêt (pixels de la carte ; largeur/hauteur <= 0 : jusqu'au bord).
+  @Int32()
+  external int roiX;
+  @Int32()
+  external int roiY;
+  @Int32()
+  external int roiW;
+  @Int32()
+  external int roiH;
+
+  /// Nombre max de points du nuage (0 = pas de limite) ; le pas est augmenté si besoin.
+  @Int32()
+  external int maxPoints;
+
+  /// 1 : inliers recomptés sur tous les pixels de la ROI après l'ajustement.
+  @Int32()
+  external int refineFullResolution;
+
+  /// 1 : plan réajusté par moindres carrés sur ses inliers (normale, centroïde, RMS).
+  @Int32()
+  external int refineLeastSquares;
+
+  /// Graine des tirages (0 = automatique ; sinon rejeu déterministe).
+  @Uint32()
+  external int seed;
+
+  /// 1 : les plans de l'appel précédent sont essayés avant tout tirage.
+  @Int32()
+  external int warmStart;
+
+  /// Part du taux d'inliers précédent qu'un plan doit garder pour être repris.
+  @Float()
+  external double warmStartRetention;
+
+  /// Espace d'ajustement (ransacEngine*) : métrique, ou directement en profondeur inverse.
+  @Int32()
+  external int engine;
+
+  /// Écart max de profondeur inverse d'un inlier (ransacEngineInverseDepth).
+  @Float()
+  external double inverseDepthThreshold;
+
+  /// Niveau de pyramide des hypothèses (0 : pleine résolution ; n : carte réduite 2^n fois,
+  /// plans vérifiés et réajustés à pleine résolution). Au plus depthPyramidLevels - 1.
+  @Int32()
+  external int coarseLevel;
+}
+
+// Niveaux de la pyramide de profondeur du contexte (DEPTH_PYRAMID_LEVELS, niveau 0 compris).
+const int depthPyramidLevels = 4;
+
+// Espaces d'ajustement de RANSAC (RANSAC_ENGINE_* dans image_utils.h).
+const int ransacEngineMetric = 0;       // Nuage 3D déprojeté, distance point-plan
+const int ransacEngineInverseDepth = 1; // (u, v, profondeur inverse), sans déprojection
+
+// Structure C `RansacStats` : coût effectif du dernier appel RANSAC.
+final class RansacStats extends Struct {
+  /// Évaluations point-plan réellement effectuées.
+  @Int64()
+  external int pointEvaluations;
+
+  /// Hypothèses tirées (tous plans confondus).
+  @Int32()
+  external int iterations;
+
+  /// Hypothèses abandonnées avant la fin du score.
+  @Int32()
+  external int earlyExits;
+
+  /// Graine utilisée (à remettre dans RansacOptions.seed pour rejouer l'appel).
+  @Uint32()
+  external int seed;
+
+  /// Plans repris de l'appel précédent (sans tirage).
+  @Int32()
+  external int warmStarts;
+}
+
+
+// Structure C `FrameInfo` : métadonnées d'une trame de la boîte aux lettres.
+final class FrameInfo extends Struct {
+  @Int32()
+  external int width;
+  @Int32()
+  external int height;
+  @Int32()
+  external int yStride;
+  @Int32()
+  external int uvStride;
+
+  /// Horodatage fourni au dépôt (µs).
+  @Int64()
+  external int timestampUs;
+
+  /// Numéro de dépôt (à partir de 1 ; 0 : aucune trame prise).
+  @Int64()
+  external int sequence;
+
+  /// Octets entre deux échantillons chroma d'une ligne (planes[1].bytesPerPixel).
+  @Int32()
+  external int uvPixelStride;
+
+  /// Rotation horaire appliquée au prétraitement (degrés).
+  @Int32()
+  external int rotation;
+
+  /// Disposition des plans chroma (yuvLayout*).
+  @Int32()
+  external int layout;
+}
+
+// Dispositions des plans chroma d'une trame YUV 4:2:0 (YUV_LAYOUT_* dans image_utils.h).
+const int yuvLayoutI420 = 0;    // Plans U et V séparés, un octet par échantillon
+const int yuvLayoutNV12 = 1;    // Plan entrelacé U, V, U, V...
+const int yuvLayoutNV21 = 2;    // Plan entrelacé V, U, V, U...
+const int yuvLayoutStrided = 3; // Plans U et V séparés, pas de pixel > 1 (copies Dart)
+
+// Structure C `MailboxStats` : compteurs de la boîte aux lettres.
+final class MailboxStats extends Struct {
+  /// Trames déposées.
+  @Int64()
+  external int published;
+
+  /// Trames prises par le traitement.
+  @Int64()
+  external int taken;
+
+  /// Trames remplacées par une plus récente avant d'être prises.
+  @Int64()
+  external int overwritten;
+}
+
+// Codes de retour du traitement de trame complet (PIPELINE_STATUS_* dans image_utils.h).
+const int pipelineStatusOk = 0;
+const int pipelineStatusInvalidArgument = -1;
+const int pipelineStatusNoTflite = -2;        // Bibliothèque compilée sans TFLite
+const int pipelineStatusModelError = -3;      // Modèle illisible
+const int pipelineStatusModelMismatch = -4;   // Tenseurs incompatibles avec le contexte
+const int pipelineStatusNoModel = -5;
+const int pipelineStatusNoFrame = -6;         // Aucune trame prise
+const int pipelineStatusPreprocessFailed = -7;
+const int pipelineStatusInferenceFailed = -8;
+
+// Structure C `FrameProcessOptions` : seuils de l'analyse de pipeline_process_frame.
+final class FrameProcessOptions extends Struct {
+  /// Statistiques : seuil de chemin libre et borne haute de l'histogramme.
+  @Float()
+  external double freePathThreshold;
+  @Float()
+  external double histogramMax;
+
+  /// Composantes d'obstacles : seuil de proximité et aire minimale (pixels).
+  @Float()
+  external double obstacleThreshold;
+  @Int32()
+  external int obstacleMinArea;
+
+  /// 0 : RANSAC sauté.
+  @Int32()
+  external int detectWalls;
+}
+
+// Structure C `FrameResult` : résultat compact d'une trame traitée de bout en bout.
+final class FrameResult extends Struct {
+  /// pipelineStatus* (les champs suivants ne valent que si pipelineStatusOk).
+  @Int32()
+  external int status;
+
+  /// Composantes d'obstacles (obstacleBlobs) et plans RANSAC (planes).
+  @Int32()
+  external int obstacleCount;
+  @Int32()
+  external int planeCount;
+
+  /// Plus large passage de la carte polaire (-1 si aucun).
+  @Int32()
+  external int gapStart;
+  @Int32()
+  external int gapEnd;
+
+  /// Profondeur inverse maximale.
+  @Float()
+  external double maxCloseness;
+
+  /// Cap et largeur du passage (radians).
+  @Float()
+  external double gapHeading;
+  @Float()
+  external double gapWidth;
+
+  /// Horodatage de la trame (µs).
+  @Int64()
+  external int timestampUs;
+
+  /// Durées des étapes (µs).
+  @Int32()
+  external int preprocessUs;
+  @Int32()
+  external int inferenceUs;
+  @Int32()
+  external int analysisUs;
+  @Int32()
+  external int ransacUs;
+}
+
+// Structure C `ProcessMemory` : mémoire résidente du processus (kio).
+final class ProcessMemory extends Struct {
+  /// VmRSS : actuelle.
+  @Int64()
+  external int rssKb;
+
+  /// VmHWM : pic depuis le lancement.
+  @Int64()
+  external int peakRssKb;
+}
+
+
+// Formats de la carte de profondeur analysée (DEPTH_FORMAT_* dans image_utils.h).
+const int depthFormatF32 = 0; // float
+const int depthFormatU8 = 1;  // uint8 quantifié : valeur = scale * (q - zeroPoint)
+const int depthFormatS8 = 2;  // int8 quantifié
+
+// Tenseur d'entrée du modèle (INPUT_TENSOR_* dans image_utils.h) : type et disposition.
+const int inputTensorU8 = 0;   // uint8 RGB brut (modèle quantifié)
+const int inputTensorF32 = 1;  // float32 : (valeur - mean) / std par canal
+const int inputTensorF16 = 2;  // float16, même formule
+const int inputTensorNHWC = 0; // R, G, B entrelacés par pixel
+const int inputTensorNCHW = 1; // Plan R, puis G, puis B
+
+// Structure C `DepthStats` : statistiques de la carte de profondeur (compute_depth_stats).
+const int depthStatsHistogramBins = 32; // DEPTH_STATS_HISTOGRAM_BINS
+
+final class DepthStats extends Struct {
+  /// Valeur max de la carte (profondeur inverse : plus haut = plus proche).
+  @Float()
+  external double maxCloseness;
+
+  /// Pixels libres (plus lointains que le seuil) de la moitié basse, par tiers.
+  @Int32()
+  external int freeLeft;
+  @Int32()
+  external int freeCenter;
+  @Int32()
+  external int freeRight;
+
+  /// Pixels de la moitié basse examinés.
+  @Int32()
+  external int totalConsidered;
+
+  /// Histogramme des valeurs sur [0, histogramMax).
+  @Array(depthStatsHistogramBins)
+  external Array<Int32> histogram;
+}
+
+// Structures C `PolarObstacleOptions` / `PolarObstacleMap` : carte polaire d'obstacles
+// (secteurs de cap égaux sur le champ horizontal, de gauche à droite).
+const int polarObstacleBins = 32; // POLAR_OBSTACLE_BINS
+
+final class PolarObstacleOptions extends Struct {
+  /// Intrinsèques de la caméra (pixels de la carte de profondeur).
+  @Float()
+  external double fx;
+  @Float()
+  external double fy;
+  @Float()
+  external double cx;
+  @Float()
+  external double cy;
+
+  /// Portée : seuls les pixels plus proches comptent (unités de la carte).
+  @Float()
+  external double obstacleRange;
+
+  /// Bande de hauteur (Y vers le haut, caméra = 0) ; ignorée si minHeight >= maxHeight.
+  @Float()
+  external double minHeight;
+  @Float()
+  external double maxHeight;
+
+  /// Pixels obstacles à partir desquels un secteur est bloqué.
+  @Int32()
+  external int minObstaclePixels;
+
+  /// Largeur angulaire minimale (radians) d'un passage.
+  @Float()
+  external double minGapWidth;
+}
+
+final class PolarObstacleMap extends Struct {
+  /// Cap des bords gauche et droit du champ (radians, négatif à gauche).
+  @Float()
+  external double headingMin;
+  @Float()
+  external double headingMax;
+
+  /// Distance de l'obstacle le plus proche par secteur (0 si aucun dans la portée).
+  @Array(polarObstacleBins)
+  external Array<Float> nearest;
+
+  /// Pixels obstacles par secteur.
+  @Array(polarObstacleBins)
+  external Array<Int32> obstaclePixels;
+
+  /// Bit b : secteur b bloqué.
+  @Uint32()
+  external int blockedMask;
+
+  /// Plus large passage (secteurs libres consécutifs), -1 si aucun.
+  @Int32()
+  external int gapStart;
+  @Int32()
+  external int gapEnd;
+
+  /// Cap du centre du passage et largeur angulaire (radians).
+  @Float()
+  external double gapHeading;
+  @Float()
+  external double gapWidth;
+}
+
+// Structure C `ObstacleBlob` : composante connexe de pixels obstacles (detect_obstacle_blobs).
+const int obstacleBlobsMax = 16; // OBSTACLE_BLOBS_MAX
+
+final class ObstacleBlob extends Struct {
+  /// Boîte englobante, bornes incluses (pixels de la carte).
+  @Int32()
+  external int xMin;
+  @Int32()
+  external int yMin;
+  @Int32()
+  external int xMax;
+  @Int32()
+  external int yMax;
+
+  /// Nombre de pixels.
+  @Int32()
+  external int area;
+
+  /// Centre de gravité des pixels.
+  @Float()
+  external double centroidX;
+  @Float()
+  external double centroidY;
+
+  /// Profondeur inverse maximale (le point le plus proche).
+  @Float()
+  external double peakCloseness;
+}
+
+// Structures C `DepthRegion` / `RegionStats` : requêtes de rectangles sur les tables
+// cumulées de la carte (pipelineBuildDepthIntegral puis pipelineQueryDepthRegions).
+const int depthRegionsMax = 64; // DEPTH_REGIONS_MAX
+
+final class DepthRegion extends Struct {
+  /// Rectangle [x0, x1[ x [y0, y1[ (pixels de la carte, ramené à la carte).
+  @Int32()
+  external int x0;
+  @Int32()
+  external int y0;
+  @Int32()
+  external int x1;
+  @Int32()
+  external int y1;
+}
+
+final class RegionStats extends Struct {
+  /// Profondeur inverse moyenne des pixels valides (0 si aucun).
+  @Float()
+  external double mean;
+
+  /// Part des pixels valides au-dessus du seuil des tables (0..1).
+  @Float()
+  external double fractionAbove;
+
+  /// Pixels valides (finis) du rectangle.
+  @Int32()
+  external int validCount;
 }
 
 
@@ -99,6 +572,156 @@ typedef DetectWallsRansacDart = int Function(
 );
 
 
+// --- Liaisons pour le contexte de pipeline persistant ---
+
+// Type opaque : Dart ne manipule que le pointeur retourné par pipeline_create.
+final class PipelineContext extends Opaque {}
+
+typedef PipelineCreateNative = Pointer<PipelineContext> Function(
+    Int32 cameraWidth, Int32 cameraHeight, // Dimensions caméra (0 si inconnues)
+    Int32 modelWidth, Int32 modelHeight,   // Dimensions entrée/sortie du modèle
+    Int32 maxPlanes                        // Capacité du tampon de plans RANSAC
+);
+typedef PipelineCreateDart = Pointer<PipelineContext> Function(
+    int cameraWidth, int cameraHeight, int modelWidth, int modelHeight, int maxPlanes);
+
+typedef PipelineDestroyNative = Void Function(Pointer<PipelineContext> ctx);
+typedef PipelineDestroyDart = void Function(Pointer<PipelineContext> ctx);
+
+// Accesseurs des tampons du contexte
+typedef PipelineUint8BufferNative = Pointer<Uint8> Function(Pointer<PipelineContext> ctx);
+typedef PipelineUint8BufferDart = Pointer<Uint8> Function(Pointer<PipelineContext> ctx);
+typedef PipelineFloatBufferNative = Pointer<Float> Function(Pointer<PipelineContext> ctx);
+typedef PipelineFloatBufferDart = Pointer<Float> Function(Pointer<PipelineContext> ctx);
+typedef PipelinePlanesBufferNative = Pointer<RansacPlaneResult> Function(Pointer<PipelineContext> ctx);
+typedef PipelinePlanesBufferDart = Pointer<RansacPlaneResult> Function(Pointer<PipelineContext> ctx);
+
+// Boîte aux lettres de trames : dépôt (rappel caméra) et prise de la plus récente (traitement).
+// Garantit la capacité des plans Y/UV des emplacements (octets). Retourne 1 si OK.
+typedef PipelineMailboxReserveNative = Int32 Function(Pointer<PipelineContext> ctx, Int32 yBytes, Int32 uvBytes);
+typedef PipelineMailboxReserveDart = int Function(Pointer<PipelineContext> ctx, int yBytes, int uvBytes);
+typedef PipelineMailboxPublishNative = Int32 Function(
+    Pointer<PipelineContext> ctx, Int32 width, Int32 height, Int32 yStride, Int32 uvStride, Int64 timestampUs);
+typedef PipelineMailboxPublishDart = int Function(
+    Pointer<PipelineContext> ctx, int width, int height, int yStride, int uvStride, int timestampUs);
+// Trames à trois plans (Y, U, V) : réservation, puis publication avec pas de pixel et rotation.
+typedef PipelineMailboxReserveYuv420Native = Int32 Function(
+    Pointer<PipelineContext> ctx, Int32 yBytes, Int32 uBytes, Int32 vBytes);
+typedef PipelineMailboxReserveYuv420Dart = int Function(
+    Pointer<PipelineContext> ctx, int yBytes, int uBytes, int vBytes);
+typedef PipelineMailboxPublishYuv420Native = Int32 Function(Pointer<PipelineContext> ctx, Int32 width, Int32 height,
+    Int32 yStride, Int32 uvStride, Int32 uvPixelStride, Int32 rotation, Int64 timestampUs);
+typedef PipelineMailboxPublishYuv420Dart = int Function(Pointer<PipelineContext> ctx, int width, int height,
+    int yStride, int uvStride, int uvPixelStride, int rotation, int timestampUs);
+typedef PipelineContextIntNative = Int32 Function(Pointer<PipelineContext> ctx);
+typedef PipelineContextIntDart = int Function(Pointer<PipelineContext> ctx);
+typedef PipelineMailboxFrameInfoNative = Pointer<FrameInfo> Function(Pointer<PipelineContext> ctx);
+typedef PipelineMailboxFrameInfoDart = Pointer<FrameInfo> Function(Pointer<PipelineContext> ctx);
+typedef PipelineMailboxStatsNative = Pointer<MailboxStats> Function(Pointer<PipelineContext> ctx);
+typedef PipelineMailboxStatsDart = Pointer<MailboxStats> Function(Pointer<PipelineContext> ctx);
+
+// Options et statistiques RANSAC du contexte (pointeurs stables pendant sa durée de vie).
+typedef PipelineRansacOptionsNative = Pointer<RansacOptions> Function(Pointer<PipelineContext> ctx);
+typedef PipelineRansacOptionsDart = Pointer<RansacOptions> Function(Pointer<PipelineContext> ctx);
+typedef PipelineRansacStatsNative = Pointer<RansacStats> Function(Pointer<PipelineContext> ctx);
+typedef PipelineRansacStatsDart = Pointer<RansacStats> Function(Pointer<PipelineContext> ctx);
+
+// RANSAC sur la carte de profondeur du contexte, avec ses options.
+// Retourne le nombre de plans trouvés.
+typedef PipelineDetectWallsNative = Int32 Function(Pointer<PipelineContext> ctx);
+typedef PipelineDetectWallsDart = int Function(Pointer<PipelineContext> ctx);
+
+// Choix de la carte analysée (float ou 8 bits quantifiée). Retourne 1 si OK.
+typedef PipelineSetDepthFormatNative = Int32 Function(
+    Pointer<PipelineContext> ctx, Int32 format, Float scale, Int32 zeroPoint);
+typedef PipelineSetDepthFormatDart = int Function(
+    Pointer<PipelineContext> ctx, int format, double scale, int zeroPoint);
+
+// Format du tenseur d'entrée (normalisation par canal, unités 0..255), son tampon et sa taille.
+typedef PipelineSetInputFormatNative = Int32 Function(Pointer<PipelineContext> ctx, Int32 type, Int32 layout,
+    Float meanR, Float meanG, Float meanB, Float stdR, Float stdG, Float stdB);
+typedef PipelineSetInputFormatDart = int Function(Pointer<PipelineContext> ctx, int type, int layout,
+    double meanR, double meanG, double meanB, double stdR, double stdG, double stdB);
+typedef PipelineInputTensorBytesNative = Int64 Function(Pointer<PipelineContext> ctx);
+typedef PipelineInputTensorBytesDart = int Function(Pointer<PipelineContext> ctx);
+
+// Filtre temporel de la carte de profondeur du contexte. Retournent 1 si OK.
+typedef PipelineSetTemporalFilterNative = Int32 Function(
+    Pointer<PipelineContext> ctx, Int32 enabled, Float alpha, Float jumpThreshold);
+typedef PipelineSetTemporalFilterDart = int Function(
+    Pointer<PipelineContext> ctx, int enabled, double alpha, double jumpThreshold);
+typedef PipelineFilterDepthNative = Int32 Function(Pointer<PipelineContext> ctx);
+typedef PipelineFilterDepthDart = int Function(Pointer<PipelineContext> ctx);
+typedef PipelineResetDepthFilterNative = Void Function(Pointer<PipelineContext> ctx);
+typedef PipelineResetDepthFilterDart = void Function(Pointer<PipelineContext> ctx);
+
+// Oubli des plans de l'appel précédent (reprise temporelle).
+typedef PipelineResetWarmStartNative = Void Function(Pointer<PipelineContext> ctx);
+typedef PipelineResetWarmStartDart = void Function(Pointer<PipelineContext> ctx);
+
+// Threads de calcul du contexte (appelant compris). Retourne le nombre effectif.
+typedef PipelineSetThreadCountNative = Int32 Function(Pointer<PipelineContext> ctx, Int32 threadCount);
+typedef PipelineSetThreadCountDart = int Function(Pointer<PipelineContext> ctx, int threadCount);
+
+// Statistiques de la carte de profondeur du contexte. Retourne 1 si OK.
+typedef PipelineComputeDepthStatsNative = Int32 Function(
+    Pointer<PipelineContext> ctx, Float freePathThreshold, Float histogramMax);
+typedef PipelineComputeDepthStatsDart = int Function(
+    Pointer<PipelineContext> ctx, double freePathThreshold, double histogramMax);
+typedef PipelineDepthStatsNative = Pointer<DepthStats> Function(Pointer<PipelineContext> ctx);
+typedef PipelineDepthStatsDart = Pointer<DepthStats> Function(Pointer<PipelineContext> ctx);
+
+// Carte polaire d'obstacles du contexte (pipeline_compute_polar_obstacles : Int32, 1 si OK).
+typedef PipelinePolarObstacleOptionsNative = Pointer<PolarObstacleOptions> Function(Pointer<PipelineContext> ctx);
+typedef PipelinePolarObstacleOptionsDart = Pointer<PolarObstacleOptions> Function(Pointer<PipelineContext> ctx);
+typedef PipelinePolarObstaclesNative = Pointer<PolarObstacleMap> Function(Pointer<PipelineContext> ctx);
+typedef PipelinePolarObstaclesDart = Pointer<PolarObstacleMap> Function(Pointer<PipelineContext> ctx);
+
+// Composantes d'obstacles du contexte (obstacleBlobsMax au plus). Retourne le nombre écrit.
+typedef PipelineDetectObstacleBlobsNative = Int32 Function(
+    Pointer<PipelineContext> ctx, Float closenessThreshold, Int32 minArea);
+typedef PipelineDetectObstacleBlobsDart = int Function(
+    Pointer<PipelineContext> ctx, double closenessThreshold, int minArea);
+typedef PipelineObstacleBlobsNative = Pointer<ObstacleBlob> Function(Pointer<PipelineContext> ctx);
+typedef PipelineObstacleBlobsDart = Pointer<ObstacleBlob> Function(Pointer<PipelineContext> ctx);
+
+// Tables cumulées du contexte (Int32 : 1 si OK) et requêtes de rectangles (nombre traité).
+typedef PipelineBuildDepthIntegralNative = Int32 Function(Pointer<PipelineContext> ctx, Float threshold);
+typedef PipelineBuildDepthIntegralDart = int Function(Pointer<PipelineContext> ctx, double threshold);
+typedef PipelineQueryDepthRegionsNative = Int32 Function(Pointer<PipelineContext> ctx, Int32 regionCount);
+typedef PipelineQueryDepthRegionsDart = int Function(Pointer<PipelineContext> ctx, int regionCount);
+typedef PipelineDepthRegionsNative = Pointer<DepthRegion> Function(Pointer<PipelineContext> ctx);
+typedef PipelineDepthRegionsDart = Pointer<DepthRegion> Function(Pointer<PipelineContext> ctx);
+typedef PipelineRegionStatsNative = Pointer<RegionStats> Function(Pointer<PipelineContext> ctx);
+typedef PipelineRegionStatsDart = Pointer<RegionStats> Function(Pointer<PipelineContext> ctx);
+
+// Pyramide de profondeur du contexte (Int32 : 1 si OK),
+// vue sur un niveau (nulle s'il n'est pas construit) et statistiques d'un niveau (1 si OK).
+typedef PipelineBuildDepthPyramidNative = Int32 Function(Pointer<PipelineContext> ctx, Int32 levelCount);
+typedef PipelineBuildDepthPyramidDart = int Function(Pointer<PipelineContext> ctx, int levelCount);
+typedef PipelineDepthLevelBufferNative = Pointer<Float> Function(Pointer<PipelineContext> ctx, Int32 level);
+typedef PipelineDepthLevelBufferDart = Pointer<Float> Function(Pointer<PipelineContext> ctx, int level);
+typedef PipelineComputeDepthStatsLevelNative = Int32 Function(
+    Pointer<PipelineContext> ctx, Int32 level, Float freePathThreshold, Float histogramMax);
+typedef PipelineComputeDepthStatsLevelDart = int Function(
+    Pointer<PipelineContext> ctx, int level, double freePathThreshold, double histogramMax);
+
+// Traitement de trame complet (interpréteur TFLite natif) : disponibilité (1 / 0),
+// chargement du modèle et traitement de la dernière trame prise (pipelineStatus*).
+typedef PipelineHasTfliteNative = Int32 Function();
+typedef PipelineHasTfliteDart = int Function();
+typedef PipelineLoadModelNative = Int32 Function(Pointer<PipelineContext> ctx, Pointer<Utf8> modelPath, Int32 threadCount);
+typedef PipelineLoadModelDart = int Function(Pointer<PipelineContext> ctx, Pointer<Utf8> modelPath, int threadCount);
+typedef PipelineFrameOptionsNative = Pointer<FrameProcessOptions> Function(Pointer<PipelineContext> ctx);
+typedef PipelineFrameOptionsDart = Pointer<FrameProcessOptions> Function(Pointer<PipelineContext> ctx);
+typedef PipelineFrameResultNative = Pointer<FrameResult> Function(Pointer<PipelineContext> ctx);
+typedef PipelineFrameResultDart = Pointer<FrameResult> Function(Pointer<PipelineContext> ctx);
+
+// Mémoire résidente du processus (/proc/self/status). Retourne 1 si OK.
+typedef ReadProcessMemoryNative = Int32 Function(Pointer<ProcessMemory> out);
+typedef ReadProcessMemoryDart = int Function(Pointer<ProcessMemory> out);
+
+
 // --- Chargement de la bibliothèque native ---
 
 const String _libName = "native_processing";
@@ -114,10 +737,167 @@ final ConvertYUV420SPToRGBDart convertYUV420SPToRGB = _nativeLib
     .lookup<NativeFunction<ConvertYUV420SPToRGBNative>>('convert_yuv420sp_to_rgb')
     .asFunction<ConvertYUV420SPToRGBDart>();
 
+// Recherche du prétraitement fusionné (YUV -> entrée 256x256 du modèle)
+final PreprocessYUV420SPDart preprocessYUV420SP = _nativeLib
+    .lookup<NativeFunction<PreprocessYUV420SPNative>>('preprocess_yuv420sp_to_model_input')
+    .asFunction<PreprocessYUV420SPDart>();
+
 // Recherche de la fonction RANSAC
 // Note : L'appel à lookup réussira maintenant, mais la fonction ne sera
 // utilisable qu'une fois que detect_walls_ransac sera implémentée en C++
 // et compilée dans la bibliothèque libnative_processing.so.
 final DetectWallsRansacDart detectWallsRansac = _nativeLib
     .lookup<NativeFunction<DetectWallsRansacNative>>('detect_walls_ransac')
-    .asFunction<DetectWallsRansacDart>();
\ No newline at end of file
+    .asFunction<DetectWallsRansacDart>();
+
+// Recherche des fonctions du contexte de pipeline
+final PipelineCreateDart pipelineCreate = _nativeLib
+    .lookup<NativeFunction<PipelineCreateNative>>('pipeline_create')
+    .asFunction<PipelineCreateDart>();
+final PipelineDestroyDart pipelineDestroy = _nativeLib
+    .lookup<NativeFunction<PipelineDestroyNative>>('pipeline_destroy')
+    .asFunction<PipelineDestroyDart>();
+final PipelineUint8BufferDart pipelineModelInputBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineUint8BufferNative>>('pipeline_model_input_buffer')
+    .asFunction<PipelineUint8BufferDart>();
+final PipelineFloatBufferDart pipelineDepthBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineFloatBufferNative>>('pipeline_depth_buffer')
+    .asFunction<PipelineFloatBufferDart>();
+final PipelineFloatBufferDart pipelineFilteredDepthBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineFloatBufferNative>>('pipeline_filtered_depth_buffer')
+    .asFunction<PipelineFloatBufferDart>();
+final PipelineUint8BufferDart pipelineDepthQ8Buffer = _nativeLib
+    .lookup<NativeFunction<PipelineUint8BufferNative>>('pipeline_depth_q8_buffer')
+    .asFunction<PipelineUint8BufferDart>();
+final PipelinePlanesBufferDart pipelinePlanesBuffer = _nativeLib
+    .lookup<NativeFunction<PipelinePlanesBufferNative>>('pipeline_planes_buffer')
+    .asFunction<PipelinePlanesBufferDart>();
+final PipelineRansacOptionsDart pipelineRansacOptions = _nativeLib
+    .lookup<NativeFunction<PipelineRansacOptionsNative>>('pipeline_ransac_options')
+    .asFunction<PipelineRansacOptionsDart>();
+final PipelineRansacStatsDart pipelineRansacStats = _nativeLib
+    .lookup<NativeFunction<PipelineRansacStatsNative>>('pipeline_ransac_stats')
+    .asFunction<PipelineRansacStatsDart>();
+final PipelineDetectWallsDart pipelineDetectWalls = _nativeLib
+    .lookup<NativeFunction<PipelineDetectWallsNative>>('pipeline_detect_walls')
+    .asFunction<PipelineDetectWallsDart>();
+final PipelineComputeDepthStatsDart pipelineComputeDepthStats = _nativeLib
+    .lookup<NativeFunction<PipelineComputeDepthStatsNative>>('pipeline_compute_depth_stats')
+    .asFunction<PipelineComputeDepthStatsDart>();
+final PipelineDepthStatsDart pipelineDepthStats = _nativeLib
+    .lookup<NativeFunction<PipelineDepthStatsNative>>('pipeline_depth_stats')
+    .asFunction<PipelineDepthStatsDart>();
+final PipelineContextIntDart pipelineComputePolarObstacles = _nativeLib
+    .lookup<NativeFunction<PipelineContextIntNative>>('pipeline_compute_polar_obstacles')
+    .asFunction<PipelineContextIntDart>();
+final PipelinePolarObstacleOptionsDart pipelinePolarObstacleOptions = _nativeLib
+    .lookup<NativeFunction<PipelinePolarObstacleOptionsNative>>('pipeline_polar_obstacle_options')
+    .asFunction<PipelinePolarObstacleOptionsDart>();
+final PipelinePolarObstaclesDart pipelinePolarObstacles = _nativeLib
+    .lookup<NativeFunction<PipelinePolarObstaclesNative>>('pipeline_polar_obstacles')
+    .asFunction<PipelinePolarObstaclesDart>();
+final PipelineDetectObstacleBlobsDart pipelineDetectObstacleBlobs = _nativeLib
+    .lookup<NativeFunction<PipelineDetectObstacleBlobsNative>>('pipeline_detect_obstacle_blobs')
+    .asFunction<PipelineDetectObstacleBlobsDart>();
+final PipelineObstacleBlobsDart pipelineObstacleBlobs = _nativeLib
+    .lookup<NativeFunction<PipelineObstacleBlobsNative>>('pipeline_obstacle_blobs')
+    .asFunction<PipelineObstacleBlobsDart>();
+final PipelineBuildDepthIntegralDart pipelineBuildDepthIntegral = _nativeLib
+    .lookup<NativeFunction<PipelineBuildDepthIntegralNative>>('pipeline_build_depth_integral')
+    .asFunction<PipelineBuildDepthIntegralDart>();
+final PipelineQueryDepthRegionsDart pipelineQueryDepthRegions = _nativeLib
+    .lookup<NativeFunction<PipelineQueryDepthRegionsNative>>('pipeline_query_depth_regions')
+    .asFunction<PipelineQueryDepthRegionsDart>();
+final PipelineDepthRegionsDart pipelineDepthRegions = _nativeLib
+    .lookup<NativeFunction<PipelineDepthRegionsNative>>('pipeline_depth_regions')
+    .asFunction<PipelineDepthRegionsDart>();
+final PipelineRegionStatsDart pipelineDepthRegionStats = _nativeLib
+    .lookup<NativeFunction<PipelineRegionStatsNative>>('pipeline_depth_region_stats')
+    .asFunction<PipelineRegionStatsDart>();
+final PipelineBuildDepthPyramidDart pipelineBuildDepthPyramid = _nativeLib
+    .lookup<NativeFunction<PipelineBuildDepthPyramidNative>>('pipeline_build_depth_pyramid')
+    .asFunction<PipelineBuildDepthPyramidDart>();
+final PipelineDepthLevelBufferDart pipelineDepthLevelBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineDepthLevelBufferNative>>('pipeline_depth_level_buffer')
+    .asFunction<PipelineDepthLevelBufferDart>();
+final PipelineComputeDepthStatsLevelDart pipelineComputeDepthStatsLevel = _nativeLib
+    .lookup<NativeFunction<PipelineComputeDepthStatsLevelNative>>('pipeline_compute_depth_stats_level')
+    .asFunction<PipelineComputeDepthStatsLevelDart>();
+final PipelineSetDepthFormatDart pipelineSetDepthFormat = _nativeLib
+    .lookup<NativeFunction<PipelineSetDepthFormatNative>>('pipeline_set_depth_format')
+    .asFunction<PipelineSetDepthFormatDart>();
+final PipelineSetInputFormatDart pipelineSetInputFormat = _nativeLib
+    .lookup<NativeFunction<PipelineSetInputFormatNative>>('pipeline_set_input_format')
+    .asFunction<PipelineSetInputFormatDart>();
+final PipelineUint8BufferDart pipelineInputTensorBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineUint8BufferNative>>('pipeline_input_tensor_buffer')
+    .asFunction<PipelineUint8BufferDart>();
+final PipelineInputTensorBytesDart pipelineInputTensorBytes = _nativeLib
+    .lookup<NativeFunction<PipelineInputTensorBytesNative>>('pipeline_input_tensor_bytes')
+    .asFunction<PipelineInputTensorBytesDart>();
+final PipelineSetTemporalFilterDart pipelineSetTemporalFilter = _nativeLib
+    .lookup<NativeFunction<PipelineSetTemporalFilterNative>>('pipeline_set_temporal_filter')
+    .asFunction<PipelineSetTemporalFilterDart>();
+final PipelineFilterDepthDart pipelineFilterDepth = _nativeLib
+    .lookup<NativeFunction<PipelineFilterDepthNative>>('pipeline_filter_depth')
+    .asFunction<PipelineFilterDepthDart>();
+final PipelineResetDepthFilterDart pipelineResetDepthFilter = _nativeLib
+    .lookup<NativeFunction<PipelineResetDepthFilterNative>>('pipeline_reset_depth_filter')
+    .asFunction<PipelineResetDepthFilterDart>();
+final PipelineResetWarmStartDart pipelineResetWarmStart = _nativeLib
+    .lookup<NativeFunction<PipelineResetWarmStartNative>>('pipeline_reset_warm_start')
+    .asFunction<PipelineResetWarmStartDart>();
+final PipelineSetThreadCountDart pipelineSetThreadCount = _nativeLib
+    .lookup<NativeFunction<PipelineSetThreadCountNative>>('pipeline_set_thread_count')
+    .asFunction<PipelineSetThreadCountDart>();
+final PipelineMailboxReserveDart pipelineMailboxReserve = _nativeLib
+    .lookup<NativeFunction<PipelineMailboxReserveNative>>('pipeline_mailbox_reserve')
+    .asFunction<PipelineMailboxReserveDart>();
+final PipelineUint8BufferDart pipelineMailboxYBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineUint8BufferNative>>('pipeline_mailbox_y_buffer')
+    .asFunction<PipelineUint8BufferDart>();
+final PipelineUint8BufferDart pipelineMailboxUVBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineUint8BufferNative>>('pipeline_mailbox_uv_buffer')
+    .asFunction<PipelineUint8BufferDart>();
+final PipelineMailboxPublishDart pipelineMailboxPublish = _nativeLib
+    .lookup<NativeFunction<PipelineMailboxPublishNative>>('pipeline_mailbox_publish')
+    .asFunction<PipelineMailboxPublishDart>();
+final PipelineMailboxReserveYuv420Dart pipelineMailboxReserveYuv420 = _nativeLib
+    .lookup<NativeFunction<PipelineMailboxReserveYuv420Native>>('pipeline_mailbox_reserve_yuv420')
+    .asFunction<PipelineMailboxReserveYuv420Dart>();
+final PipelineUint8BufferDart pipelineMailboxVBuffer = _nativeLib
+    .lookup<NativeFunction<PipelineUint8BufferNative>>('pipeline_mailbox_v_buffer')
+    .asFunction<PipelineUint8BufferDart>();
+final PipelineMailboxPublishYuv420Dart pipelineMailboxPublishYuv420 = _nativeLib
+    .lookup<NativeFunction<PipelineMailboxPublishYuv420Native>>('pipeline_mailbox_publish_yuv420')
+    .asFunction<PipelineMailboxPublishYuv420Dart>();
+final PipelineContextIntDart pipelineMailboxTake = _nativeLib
+    .lookup<NativeFunction<PipelineContextIntNative>>('pipeline_mailbox_take')
+    .asFunction<PipelineContextIntDart>();
+final PipelineContextIntDart pipelinePreprocessLatest = _nativeLib
+    .lookup<NativeFunction<PipelineContextIntNative>>('pipeline_preprocess_latest')
+    .asFunction<PipelineContextIntDart>();
+final PipelineMailboxFrameInfoDart pipelineMailboxFrameInfo = _nativeLib
+    .lookup<NativeFunction<PipelineMailboxFrameInfoNative>>('pipeline_mailbox_frame_info')
+    .asFunction<PipelineMailboxFrameInfoDart>();
+final PipelineMailboxStatsDart pipelineMailboxStats = _nativeLib
+    .lookup<NativeFunction<PipelineMailboxStatsNative>>('pipeline_mailbox_stats')
+    .asFunction<PipelineMailboxStatsDart>();
+final PipelineHasTfliteDart pipelineHasTflite = _nativeLib
+    .lookup<NativeFunction<PipelineHasTfliteNative>>('pipeline_has_tflite')
+    .asFunction<PipelineHasTfliteDart>();
+final PipelineLoadModelDart pipelineLoadModel = _nativeLib
+    .lookup<NativeFunction<PipelineLoadModelNative>>('pipeline_load_model')
+    .asFunction<PipelineLoadModelDart>();
+final PipelineContextIntDart pipelineProcessLatest = _nativeLib
+    .lookup<NativeFunction<PipelineContextIntNative>>('pipeline_process_latest')
+    .asFunction<PipelineContextIntDart>();
+final PipelineFrameOptionsDart pipelineFrameOptions = _nativeLib
+    .lookup<NativeFunction<PipelineFrameOptionsNative>>('pipeline_frame_options')
+    .asFunction<PipelineFrameOptionsDart>();
+final PipelineFrameResultDart pipelineFrameResult = _nativeLib
+    .lookup<NativeFunction<PipelineFrameResultNative>>('pipeline_frame_result')
+    .asFunction<PipelineFrameResultDart>();
+final ReadProcessMemoryDart readProcessMemory = _nativeLib
+    .lookup<NativeFunction<ReadProcessMemoryNative>>('read_process_memory')
+    .asFunction<ReadProcessMemoryDart>();